@@ -0,0 +1,9 @@
+#!/bin/sh
+# Checks and times chat colour formatting, without the SDK.
+
+set -e
+
+cd "$(dirname "$0")/.."
+OUT="${TMPDIR:-/tmp}/cs2kz-cformat-bench"
+${CXX:-c++} -std=c++17 -O2 -Wall -Iscripts/tests/stubs -o "$OUT" scripts/tests/cformat_bench.cpp src/utils/cformat.cpp
+"$OUT"
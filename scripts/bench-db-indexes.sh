@@ -0,0 +1,10 @@
+#!/bin/sh
+# Times the run and jumpstat lookups on a 1M run SQLite database before and after the Times and Jumpstats indexes.
+# Needs the SQLite headers and library, set CXXFLAGS/LDFLAGS if they aren't in the default paths.
+
+set -e
+
+cd "$(dirname "$0")/.."
+OUT="${TMPDIR:-/tmp}/cs2kz-db-index-bench"
+${CXX:-c++} -std=c++17 -O2 -Wall -Iscripts/tests/stubs $CXXFLAGS -o "$OUT" scripts/tests/db_index_bench.cpp $LDFLAGS -lsqlite3
+"$OUT"
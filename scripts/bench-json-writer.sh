@@ -0,0 +1,11 @@
+#!/bin/sh
+# Compares JsonWriter output to the nlohmann based Json it replaced and times both, without the SDK.
+# Needs the vendor/json submodule, or NLOHMANN_ROOT pointing at a directory containing vendor/json/single_include.
+# Extra compiler flags can be passed through CXXFLAGS.
+
+set -e
+
+cd "$(dirname "$0")/.."
+OUT="${TMPDIR:-/tmp}/cs2kz-json-writer-bench"
+${CXX:-c++} -std=c++17 -O2 -Wall -Iscripts/tests/stubs -I. ${NLOHMANN_ROOT:+-I"$NLOHMANN_ROOT"} $CXXFLAGS -o "$OUT" scripts/tests/json_writer_bench.cpp
+"$OUT"
@@ -0,0 +1,9 @@
+#!/bin/sh
+# Checks the quiet hide matrix against a per-target walk over every pawn and times both, without the SDK.
+
+set -e
+
+cd "$(dirname "$0")/.."
+OUT="${TMPDIR:-/tmp}/cs2kz-quiet-bench"
+${CXX:-c++} -std=c++17 -O2 -Wall -Iscripts/tests/stubs -o "$OUT" scripts/tests/quiet_bench.cpp
+"$OUT"
@@ -0,0 +1,9 @@
+#!/bin/sh
+# Checks the scmd hash buckets against a scan of every registered command and times both, without the SDK.
+
+set -e
+
+cd "$(dirname "$0")/.."
+OUT="${TMPDIR:-/tmp}/cs2kz-scmd-bench"
+${CXX:-c++} -std=c++17 -O2 -Wall -Iscripts/tests/stubs -o "$OUT" scripts/tests/scmd_bench.cpp
+"$OUT"
@@ -0,0 +1,9 @@
+#!/bin/sh
+# Checks the signature scanner against a plain per-signature scan of a synthetic blob and times both, without the SDK.
+
+set -e
+
+cd "$(dirname "$0")/.."
+OUT="${TMPDIR:-/tmp}/cs2kz-sigscan-bench"
+${CXX:-c++} -std=c++17 -O2 -Wall -Iscripts/tests/stubs -o "$OUT" scripts/tests/sigscan_bench.cpp src/utils/sigscan.cpp
+"$OUT"
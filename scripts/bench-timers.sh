@@ -0,0 +1,9 @@
+#!/bin/sh
+# Checks the timer scheduler against a per-frame scan of every timer and times both, without the SDK.
+
+set -e
+
+cd "$(dirname "$0")/.."
+OUT="${TMPDIR:-/tmp}/cs2kz-timers-bench"
+${CXX:-c++} -std=c++17 -O2 -Wall -Iscripts/tests/stubs -o "$OUT" scripts/tests/timers_bench.cpp src/utils/ctimer.cpp
+"$OUT"
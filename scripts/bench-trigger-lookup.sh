@@ -0,0 +1,9 @@
+#!/bin/sh
+# Checks the mapping API trigger lookup table against a scan of every trigger and times both, without the SDK.
+
+set -e
+
+cd "$(dirname "$0")/.."
+OUT="${TMPDIR:-/tmp}/cs2kz-trigger-lookup-bench"
+${CXX:-c++} -std=c++17 -O2 -Wall -Iscripts/tests/stubs -o "$OUT" scripts/tests/trigger_lookup_bench.cpp
+"$OUT"
@@ -0,0 +1,9 @@
+#!/bin/sh
+# Round trips synthetic ticks through the replay encoder and reader, without the SDK.
+
+set -e
+
+cd "$(dirname "$0")/.."
+OUT="${TMPDIR:-/tmp}/cs2kz-replay-format-test"
+${CXX:-c++} -std=c++17 -O2 -Wall -Iscripts/tests/stubs -o "$OUT" scripts/tests/replay_format_test.cpp src/kz/replays/replay_format.cpp
+"$OUT"
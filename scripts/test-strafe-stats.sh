@@ -0,0 +1,9 @@
+#!/bin/sh
+# Checks the strafe stat reductions against the code they replaced and times both, without the SDK.
+
+set -e
+
+cd "$(dirname "$0")/.."
+OUT="${TMPDIR:-/tmp}/cs2kz-strafe-stats-test"
+${CXX:-c++} -std=c++17 -O2 -Wall -Iscripts/tests/stubs -o "$OUT" scripts/tests/strafe_stats_test.cpp
+"$OUT"
@@ -0,0 +1,124 @@
+// Checks utils::CFormat on colour tags, escapes and newlines, then times a chat line formatted the way the print helpers
+// did before CachedNetMessage (into a 512 byte buffer, then copied into a fresh param string) against formatting straight
+// into a reused param string. Looking up, allocating and posting the net message itself needs the engine and isn't covered.
+// Run through scripts/bench-cformat.sh.
+
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "../../src/utils/cformat.h"
+
+static_global i32 failures;
+
+#define CHECK(condition, ...) \
+	do \
+	{ \
+		if (!(condition)) \
+		{ \
+			printf("FAILED %s:%i: %s: ", __FILE__, __LINE__, #condition); \
+			printf(__VA_ARGS__); \
+			printf("\n"); \
+			failures++; \
+		} \
+	} while (0)
+
+static_function void TestFormat(const char *text, const char *expected)
+{
+	std::string output;
+	CHECK(utils::CFormat(output, text), "\"%s\" failed to format", text);
+	CHECK(output == expected, "\"%s\" formatted as \"%s\", expected \"%s\"", text, output.c_str(), expected);
+
+	char buffer[512];
+	CHECK(utils::CFormat(buffer, sizeof(buffer), text), "\"%s\" failed to format into a buffer", text);
+	CHECK(output == buffer, "\"%s\" formatted as \"%s\" into a string but \"%s\" into a buffer", text, output.c_str(), buffer);
+}
+
+static_function void TestWorstCase()
+{
+	// Every character expands to the maximum, the string overload has to size for that on its own.
+	for (u32 length = 0; length < 300; length++)
+	{
+		std::string text(length, '\n');
+		std::string output;
+		CHECK(utils::CFormat(output, text.c_str()), "%u newlines failed to format", length);
+		CHECK(output.size() == 1 + length * 3, "%u newlines formatted to %zu bytes", length, output.size());
+	}
+
+	// The buffer overload still reports running out of space.
+	char small[8];
+	CHECK(!utils::CFormat(small, sizeof(small), "{red}too long for this"), "an overlong line fit into 8 bytes");
+}
+
+static_global const char *lines[] = {
+	"{lime}KZ {grey}| {default}You finished {gold}Main{default} in {lime}01:23.456{default} ({grey}3 TPs{default}).",
+	"{lime}KZ {grey}| {default}Map: {gold}kz_grotto{default}, Tier {yellow}3{default}, by {purple}Someone",
+	"{lime}KZ {grey}| {red}You can't do that right now.",
+	"{{escaped}} braces and a\nnewline with {bluegrey}colour",
+};
+
+template<typename F>
+static_function f64 NanosecondsPerLine(u32 rounds, F &&format)
+{
+	size_t bytes = 0;
+	auto start = std::chrono::steady_clock::now();
+	for (u32 round = 0; round < rounds; round++)
+	{
+		for (const char *line : lines)
+		{
+			bytes += format(line);
+		}
+	}
+	auto end = std::chrono::steady_clock::now();
+	// Keeps the formatting from being optimized out.
+	if (bytes == 0)
+	{
+		printf("no output\n");
+	}
+	return std::chrono::duration<f64, std::nano>(end - start).count() / ((f64)rounds * (sizeof(lines) / sizeof(lines[0])));
+}
+
+int main()
+{
+	TestFormat("", " ");
+	TestFormat("plain", " plain");
+	TestFormat("{red}red{default}", " \x07red\x01");
+	TestFormat("{{red}}", " {red}}");
+	TestFormat("{notacolour}", " {notacolour}");
+	TestFormat("a\nb", " a\xe2\x80\xa9" "b");
+	TestFormat("\n", " \xe2\x80\xa9");
+	TestWorstCase();
+
+	const u32 rounds = 500000;
+
+	f64 copied = NanosecondsPerLine(rounds, [](const char *line) -> size_t {
+		char coloredBuffer[512];
+		if (!utils::CFormat(coloredBuffer, sizeof(coloredBuffer), line))
+		{
+			return 0;
+		}
+		// What add_param(const char *) did on a freshly allocated message.
+		std::string *param = new std::string(coloredBuffer);
+		size_t size = param->size();
+		delete param;
+		return size;
+	});
+
+	std::string param;
+	f64 direct = NanosecondsPerLine(rounds, [&param](const char *line) -> size_t {
+		utils::CFormat(param, line);
+		return param.size();
+	});
+
+	printf("chat line: 512 byte buffer + copy %.0f ns, reused string %.0f ns (%.1fx)\n", copied, direct, copied / direct);
+
+	if (failures)
+	{
+		printf("%i check(s) failed\n", failures);
+		return 1;
+	}
+	printf("All CFormat checks passed.\n");
+	return 0;
+}
@@ -0,0 +1,326 @@
+// Seeds an SQLite database with 1M runs and 200k jumpstats through the table definitions in src/kz/db/queries, times the
+// Times and Jumpstats lookups the plugin runs before and after the indexes from the leaderboard migration, and checks that
+// the results stay the same and that the indexes get used. Run through scripts/bench-db-indexes.sh.
+
+#include <chrono>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include <sqlite3.h>
+
+#include "common.h"
+
+#include "../../src/kz/db/queries/courses.h"
+#include "../../src/kz/db/queries/jumpstats.h"
+#include "../../src/kz/db/queries/maps.h"
+#include "../../src/kz/db/queries/modes.h"
+#include "../../src/kz/db/queries/players.h"
+#include "../../src/kz/db/queries/styles.h"
+#include "../../src/kz/db/queries/times.h"
+
+// Both define sql_getpb, the plugin includes them from different sources.
+namespace pb
+{
+#include "../../src/kz/db/queries/personal_best.h"
+}
+
+namespace savetime
+{
+#include "../../src/kz/db/queries/save_time.h"
+}
+
+static_global i32 failures;
+
+#define CHECK(condition, ...) \
+	do \
+	{ \
+		if (!(condition)) \
+		{ \
+			printf("FAILED %s:%i: %s: ", __FILE__, __LINE__, #condition); \
+			printf(__VA_ARGS__); \
+			printf("\n"); \
+			failures++; \
+		} \
+	} while (0)
+
+static_global u32 g_seed = 1;
+
+static_function u32 Random(u32 range)
+{
+	g_seed = g_seed * 1664525u + 1013904223u;
+	return (g_seed >> 8) % range;
+}
+
+#define STEAMID_BASE 76561197960265728ull
+#define PLAYER_COUNT 50000
+#define MAP_COUNT    1000
+#define COURSE_COUNT 3
+#define MODE_COUNT   3
+#define TIME_COUNT   1000000
+#define JUMP_COUNT   200000
+
+static_global sqlite3 *g_db;
+
+static_function void Exec(const char *sql)
+{
+	char *error = nullptr;
+	if (sqlite3_exec(g_db, sql, nullptr, nullptr, &error) != SQLITE_OK)
+	{
+		CHECK(false, "%s\n%s", error, sql);
+		sqlite3_free(error);
+	}
+}
+
+static_function sqlite3_stmt *Prepare(const char *sql)
+{
+	sqlite3_stmt *stmt = nullptr;
+	if (sqlite3_prepare_v2(g_db, sql, -1, &stmt, nullptr) != SQLITE_OK)
+	{
+		CHECK(false, "%s\n%s", sqlite3_errmsg(g_db), sql);
+	}
+	return stmt;
+}
+
+static_function void Seed()
+{
+	Exec(sqlite_players_create);
+	Exec(sqlite_modes_create);
+	Exec(sqlite_styles_create);
+	Exec(sqlite_maps_create);
+	Exec(sqlite_mapcourses_create);
+	Exec(sqlite_times_create);
+	Exec(sqlite_jumpstats_create);
+	// Later migrations that don't touch the lookups timed here.
+	Exec(sqlite_jumpstats_create_index_ranking);
+
+	Exec("BEGIN");
+	sqlite3_stmt *player = Prepare("INSERT INTO Players (SteamID64, Alias, Cheater) VALUES (?, 'player', ?)");
+	for (u32 i = 0; i < PLAYER_COUNT; i++)
+	{
+		sqlite3_bind_int64(player, 1, (sqlite3_int64)(STEAMID_BASE + i));
+		sqlite3_bind_int(player, 2, Random(200) == 0);
+		sqlite3_step(player);
+		sqlite3_reset(player);
+	}
+	sqlite3_finalize(player);
+
+	sqlite3_stmt *map = Prepare("INSERT INTO Maps (ID, Name) VALUES (?, ?)");
+	sqlite3_stmt *course = Prepare("INSERT INTO MapCourses (ID, MapID, Name, StageID) VALUES (?, ?, ?, ?)");
+	char name[32];
+	for (u32 i = 1; i <= MAP_COUNT; i++)
+	{
+		snprintf(name, sizeof(name), "kz_map%u", i);
+		sqlite3_bind_int(map, 1, i);
+		sqlite3_bind_text(map, 2, name, -1, SQLITE_TRANSIENT);
+		sqlite3_step(map);
+		sqlite3_reset(map);
+		for (u32 j = 1; j <= COURSE_COUNT; j++)
+		{
+			snprintf(name, sizeof(name), "Course %u", j);
+			sqlite3_bind_int(course, 1, (i - 1) * COURSE_COUNT + j);
+			sqlite3_bind_int(course, 2, i);
+			sqlite3_bind_text(course, 3, name, -1, SQLITE_TRANSIENT);
+			sqlite3_bind_int(course, 4, j);
+			sqlite3_step(course);
+			sqlite3_reset(course);
+		}
+	}
+	sqlite3_finalize(map);
+	sqlite3_finalize(course);
+
+	sqlite3_stmt *time = Prepare("INSERT INTO Times (SteamID64, MapCourseID, ModeID, StyleIDFlags, RunTime, Teleports, Metadata) "
+								 "VALUES (?, ?, ?, ?, ?, ?, '{}')");
+	for (u32 i = 0; i < TIME_COUNT; i++)
+	{
+		sqlite3_bind_int64(time, 1, (sqlite3_int64)(STEAMID_BASE + Random(PLAYER_COUNT)));
+		sqlite3_bind_int(time, 2, 1 + Random(MAP_COUNT * COURSE_COUNT));
+		sqlite3_bind_int(time, 3, 1 + Random(MODE_COUNT));
+		sqlite3_bind_int(time, 4, Random(10) == 0 ? 1 << Random(4) : 0);
+		sqlite3_bind_double(time, 5, 10.0 + Random(600000) / 1000.0);
+		sqlite3_bind_int(time, 6, Random(3) == 0 ? 0 : Random(200));
+		sqlite3_step(time);
+		sqlite3_reset(time);
+	}
+	sqlite3_finalize(time);
+
+	sqlite3_stmt *jump = Prepare(sql_jumpstats_insert);
+	for (u32 i = 0; i < JUMP_COUNT; i++)
+	{
+		bool block = Random(2);
+		sqlite3_bind_int64(jump, 1, (sqlite3_int64)(STEAMID_BASE + Random(PLAYER_COUNT)));
+		sqlite3_bind_int(jump, 2, Random(8));
+		sqlite3_bind_int(jump, 3, 1 + Random(MODE_COUNT));
+		sqlite3_bind_int(jump, 4, 2300000 + Random(100000));
+		sqlite3_bind_int(jump, 5, block);
+		sqlite3_bind_int(jump, 6, block ? 230 + Random(60) : 0);
+		for (i32 column = 7; column <= 11; column++)
+		{
+			sqlite3_bind_int(jump, column, Random(1000));
+		}
+		sqlite3_step(jump);
+		sqlite3_reset(jump);
+	}
+	sqlite3_finalize(jump);
+	Exec("COMMIT");
+}
+
+// Parameters taken from existing rows so every lookup finds something.
+struct Lookup
+{
+	sqlite3_int64 steamID64;
+	i32 courseID;
+	i32 modeID;
+	std::string mapName;
+	std::string courseName;
+};
+
+static_function std::vector<Lookup> MakeLookups(u32 count)
+{
+	std::vector<Lookup> lookups;
+	sqlite3_stmt *stmt = Prepare("SELECT t.SteamID64, t.MapCourseID, t.ModeID, m.Name, mc.Name FROM Times t "
+								 "INNER JOIN MapCourses mc ON mc.ID = t.MapCourseID INNER JOIN Maps m ON m.ID = mc.MapID WHERE t.ID = ?");
+	for (u32 i = 0; i < count; i++)
+	{
+		sqlite3_bind_int(stmt, 1, 1 + Random(TIME_COUNT));
+		if (sqlite3_step(stmt) == SQLITE_ROW)
+		{
+			lookups.push_back({sqlite3_column_int64(stmt, 0), sqlite3_column_int(stmt, 1), sqlite3_column_int(stmt, 2),
+							   (const char *)sqlite3_column_text(stmt, 3), (const char *)sqlite3_column_text(stmt, 4)});
+		}
+		sqlite3_reset(stmt);
+	}
+	sqlite3_finalize(stmt);
+	return lookups;
+}
+
+struct Query
+{
+	const char *name;
+	const char *sql;
+	// Which index the lookup should go through once the migration ran.
+	const char *index;
+	void (*bind)(sqlite3_stmt *stmt, const Lookup &lookup);
+	// Sum of everything the query returned, compared before and after.
+	std::vector<f64> results;
+	f64 beforeMs;
+	f64 afterMs;
+};
+
+// Same argument order as the Bind() calls in src/kz/db.
+static_function void BindSaveTimePB(sqlite3_stmt *stmt, const Lookup &lookup)
+{
+	sqlite3_bind_int(stmt, 1, lookup.courseID);
+	sqlite3_bind_int64(stmt, 2, lookup.steamID64);
+	sqlite3_bind_int(stmt, 3, lookup.modeID);
+	sqlite3_bind_int(stmt, 4, 0);
+	sqlite3_bind_int(stmt, 5, 2);
+}
+
+static_function void BindFindPB(sqlite3_stmt *stmt, const Lookup &lookup)
+{
+	sqlite3_bind_int64(stmt, 1, lookup.steamID64);
+	sqlite3_bind_text(stmt, 2, lookup.mapName.c_str(), -1, SQLITE_TRANSIENT);
+	sqlite3_bind_text(stmt, 3, lookup.courseName.c_str(), -1, SQLITE_TRANSIENT);
+	sqlite3_bind_int(stmt, 4, lookup.modeID);
+	sqlite3_bind_int(stmt, 5, 0);
+	sqlite3_bind_int(stmt, 6, 1);
+}
+
+static_function void BindJumpPBs(sqlite3_stmt *stmt, const Lookup &lookup)
+{
+	sqlite3_bind_int64(stmt, 1, lookup.steamID64);
+}
+
+static_function f64 Run(Query &query, const std::vector<Lookup> &lookups, bool record)
+{
+	sqlite3_stmt *stmt = Prepare(query.sql);
+	auto start = std::chrono::steady_clock::now();
+	for (size_t i = 0; i < lookups.size(); i++)
+	{
+		query.bind(stmt, lookups[i]);
+		f64 sum = 0;
+		while (sqlite3_step(stmt) == SQLITE_ROW)
+		{
+			for (i32 column = 0; column < sqlite3_column_count(stmt); column++)
+			{
+				sum += sqlite3_column_type(stmt, column) == SQLITE_TEXT ? sqlite3_column_bytes(stmt, column) : sqlite3_column_double(stmt, column);
+			}
+		}
+		sqlite3_reset(stmt);
+		if (record)
+		{
+			query.results.push_back(sum);
+		}
+		else
+		{
+			CHECK(query.results[i] == sum, "%s: lookup %zu returned %f before the indexes and %f after", query.name, i, query.results[i], sum);
+		}
+	}
+	auto end = std::chrono::steady_clock::now();
+	sqlite3_finalize(stmt);
+	return std::chrono::duration<f64, std::milli>(end - start).count() / lookups.size();
+}
+
+static_function bool UsesIndex(const char *sql, const char *index)
+{
+	std::string explain = std::string("EXPLAIN QUERY PLAN ") + sql;
+	sqlite3_stmt *stmt = Prepare(explain.c_str());
+	bool found = false;
+	while (sqlite3_step(stmt) == SQLITE_ROW)
+	{
+		found |= strstr((const char *)sqlite3_column_text(stmt, 3), index) != nullptr;
+	}
+	sqlite3_finalize(stmt);
+	return found;
+}
+
+int main()
+{
+	if (sqlite3_open(":memory:", &g_db) != SQLITE_OK)
+	{
+		printf("Couldn't open an in-memory database\n");
+		return 1;
+	}
+	auto seedStart = std::chrono::steady_clock::now();
+	Seed();
+	f64 seedMs = std::chrono::duration<f64, std::milli>(std::chrono::steady_clock::now() - seedStart).count();
+	printf("Seeded %u runs and %u jumps in %.0f ms\n", TIME_COUNT, JUMP_COUNT, seedMs);
+
+	// Without the indexes every lookup scans the whole table, so fewer of them are timed.
+	std::vector<Lookup> lookups = MakeLookups(40);
+	Query queries[] = {
+		{"SaveTime PB", savetime::sql_getpb, "IX_Times_Player", BindSaveTimePB},
+		{"SaveTime PRO PB", savetime::sql_getpbpro, "IX_Times_Player", BindSaveTimePB},
+		{"!pb", pb::sql_getpb, "IX_Times_Player", BindFindPB},
+		{"!pb PRO", pb::sql_getpbpro, "IX_Times_Player", BindFindPB},
+		{"jumpstat PBs", sql_jumpstats_getpbs, "IX_Jumpstats_Player", BindJumpPBs},
+	};
+	for (Query &query : queries)
+	{
+		query.beforeMs = Run(query, lookups, true);
+	}
+
+	auto indexStart = std::chrono::steady_clock::now();
+	Exec(sqlite_times_create_index_leaderboard);
+	Exec(sqlite_times_create_index_player);
+	Exec(sqlite_jumpstats_create_index_player);
+	f64 indexMs = std::chrono::duration<f64, std::milli>(std::chrono::steady_clock::now() - indexStart).count();
+	printf("Created the indexes in %.0f ms\n", indexMs);
+
+	for (Query &query : queries)
+	{
+		CHECK(UsesIndex(query.sql, query.index), "%s doesn't use %s", query.name, query.index);
+		query.afterMs = Run(query, lookups, false);
+		printf("%-18s before %9.3f ms, after %7.3f ms\n", query.name, query.beforeMs, query.afterMs);
+	}
+	sqlite3_close(g_db);
+
+	if (failures)
+	{
+		printf("%i check(s) failed\n", failures);
+		return 1;
+	}
+	printf("All database index checks passed.\n");
+	return 0;
+}
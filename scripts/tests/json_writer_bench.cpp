@@ -0,0 +1,197 @@
+// Serializes a `new-record` message through JsonWriter and through the Json (nlohmann) tree it replaced, checks that both
+// decode to the same document and that floats read back exactly, then times both. Run through scripts/bench-json-writer.sh.
+
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+#include "../../src/utils/json.h"
+
+static_global i32 failures;
+
+#define CHECK(condition, ...) \
+	do \
+	{ \
+		if (!(condition)) \
+		{ \
+			printf("FAILED %s:%i: %s: ", __FILE__, __LINE__, #condition); \
+			printf(__VA_ARGS__); \
+			printf("\n"); \
+			failures++; \
+		} \
+	} while (0)
+
+// Same fields as KZ::API::events::NewRecord, with both the old and the new serializer.
+struct NewRecord
+{
+	struct StyleInfo
+	{
+		std::string_view name;
+		std::string_view checksum;
+
+		bool ToJson(JsonWriter &json) const
+		{
+			return json.Set("style", this->name) && json.Set("checksum", this->checksum);
+		}
+
+		bool ToJson(Json &json) const
+		{
+			return json.Set("style", this->name) && json.Set("checksum", this->checksum);
+		}
+	};
+
+	u64 playerID;
+	u16 filterID;
+	std::string_view modeChecksum;
+	u32 teleports;
+	f64 time;
+	std::vector<StyleInfo> styles;
+	std::string_view metadata;
+
+	bool ToJson(JsonWriter &json) const
+	{
+		// clang-format off
+		return json.Set("player_id", this->playerID)
+			&& json.Set("filter_id", this->filterID)
+			&& json.Set("mode_md5", this->modeChecksum)
+			&& json.Set("teleports", this->teleports)
+			&& json.Set("time", this->time)
+			&& json.Set("styles", this->styles)
+			&& json.Set("metadata", this->metadata);
+		// clang-format on
+	}
+
+	bool ToJson(Json &json) const
+	{
+		// clang-format off
+		return json.Set("player_id", this->playerID)
+			&& json.Set("filter_id", this->filterID)
+			&& json.Set("mode_md5", this->modeChecksum)
+			&& json.Set("teleports", this->teleports)
+			&& json.Set("time", this->time)
+			&& json.Set("styles", this->styles)
+			&& json.Set("metadata", this->metadata);
+		// clang-format on
+	}
+};
+
+// What KZGlobalService::SendMessage builds now.
+static_function std::string WriteWithWriter(u32 messageID, const NewRecord &data)
+{
+	JsonWriter &payload = JsonWriter::ForCurrentThread();
+	payload.BeginObject();
+	payload.Set("id", messageID);
+	payload.Set("event", std::string_view("new-record"));
+	payload.Set("data", data);
+	payload.EndObject();
+	return payload.TakeBuffer();
+}
+
+// What KZGlobalService::SendMessage built before JsonWriter.
+static_function std::string WriteWithTree(u32 messageID, const NewRecord &data)
+{
+	Json payload;
+	payload.Set("id", messageID);
+	payload.Set("event", std::string_view("new-record"));
+	payload.Set("data", data);
+	return payload.ToString();
+}
+
+static_function NewRecord MakeRecord(u32 i)
+{
+	static_persist const NewRecord::StyleInfo styles[] = {
+		{"Auto Bhop", "2b4b6a2f0e6c4b8a9d1e3f5a7c9b0d2e"},
+		{"Low Gravity", "8f1e2d3c4b5a69788796a5b4c3d2e1f0"},
+	};
+
+	NewRecord record;
+	record.playerID = 76561197960265728ull + i;
+	record.filterID = (u16)(i % 4096);
+	record.modeChecksum = "0f3c8a0a6b1e4d7c9e2b5a8f1d4c7e0a";
+	record.teleports = i % 13;
+	record.time = 10.0 + i * 0.015625 + i % 7 * 0.1;
+	record.styles.assign(styles, styles + i % 3);
+	record.metadata = "{\"checkpoints\":12,\"note\":\"quoted \\\"text\\\" and\\ttabs\"}";
+	return record;
+}
+
+static_function void TestSameDocument()
+{
+	for (u32 i = 0; i < 1000; i++)
+	{
+		NewRecord record = MakeRecord(i);
+		std::string written = WriteWithWriter(i, record);
+		std::string tree = WriteWithTree(i, record);
+		nlohmann::json fromWriter = nlohmann::json::parse(written, nullptr, false);
+		CHECK(!fromWriter.is_discarded(), "record %u: writer output isn't valid JSON: %s", i, written.c_str());
+		CHECK(fromWriter == nlohmann::json::parse(tree), "record %u: documents differ\n  writer: %s\n  tree:   %s", i, written.c_str(), tree.c_str());
+	}
+}
+
+static_function void TestFloats()
+{
+	const f64 values[] = {0.0, -0.0, 1.0, -1.0, 0.1, 1.0 / 3.0, 12.345, 1e-7, 123456789.0, 1e21, 5e-324, 1.7976931348623157e308, 64.015625};
+	for (f64 value : values)
+	{
+		JsonWriter &writer = JsonWriter::ForCurrentThread();
+		writer.Value(value);
+		std::string text = writer.ToString();
+		nlohmann::json parsed = nlohmann::json::parse(text, nullptr, false);
+		CHECK(parsed.is_number_float(), "%.17g was written as %s, which doesn't read back as a float", value, text.c_str());
+		CHECK(parsed.get<f64>() == value, "%.17g was written as %s, which reads back as %.17g", value, text.c_str(), parsed.get<f64>());
+
+		char longest[32];
+		snprintf(longest, sizeof(longest), "%.17g", value);
+		CHECK(text.size() <= strlen(longest) + 2, "%.17g was written as %s, longer than %s", value, text.c_str(), longest);
+	}
+
+	JsonWriter &writer = JsonWriter::ForCurrentThread();
+	writer.Value(0.1);
+	CHECK(writer.ToString() == "0.1", "0.1 was written as %s", writer.ToString().c_str());
+}
+
+template<typename F>
+static_function f64 NanosecondsPerMessage(const std::vector<NewRecord> &records, u32 rounds, F &&write)
+{
+	size_t bytes = 0;
+	auto start = std::chrono::steady_clock::now();
+	for (u32 round = 0; round < rounds; round++)
+	{
+		for (u32 i = 0; i < records.size(); i++)
+		{
+			bytes += write(i, records[i]).size();
+		}
+	}
+	auto end = std::chrono::steady_clock::now();
+	// Keeps the writes from being optimized out.
+	if (bytes == 0)
+	{
+		printf("no output\n");
+	}
+	return std::chrono::duration<f64, std::nano>(end - start).count() / ((f64)rounds * records.size());
+}
+
+int main()
+{
+	TestSameDocument();
+	TestFloats();
+
+	std::vector<NewRecord> records;
+	for (u32 i = 0; i < 1024; i++)
+	{
+		records.push_back(MakeRecord(i));
+	}
+
+	f64 tree = NanosecondsPerMessage(records, 200, WriteWithTree);
+	f64 writer = NanosecondsPerMessage(records, 200, WriteWithWriter);
+	printf("new-record: Json tree %.0f ns/message, JsonWriter %.0f ns/message (%.1fx)\n", tree, writer, tree / writer);
+
+	if (failures)
+	{
+		printf("%i check(s) failed\n", failures);
+		return 1;
+	}
+	printf("All JSON writer checks passed.\n");
+	return 0;
+}
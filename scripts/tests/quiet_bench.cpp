@@ -0,0 +1,252 @@
+// Builds the hide matrix from src/kz/quiet/kz_quiet_matrix.h for 64 players and applies it to every CheckTransmit info,
+// checks that the same transmit bits are cleared as with the per-target pawn walk it replaced, and times both.
+// Run through scripts/bench-quiet.sh.
+
+#include <chrono>
+#include <cstdio>
+#include <vector>
+
+#include "../../src/kz/quiet/kz_quiet_matrix.h"
+
+static_global i32 failures;
+
+#define CHECK(condition, ...) \
+	do \
+	{ \
+		if (!(condition)) \
+		{ \
+			printf("FAILED %s:%i: %s: ", __FILE__, __LINE__, #condition); \
+			printf(__VA_ARGS__); \
+			printf("\n"); \
+			failures++; \
+		} \
+	} while (0)
+
+static_global u32 g_seed = 1;
+
+static_function u32 Random(u32 range)
+{
+	g_seed = g_seed * 1664525u + 1013904223u;
+	return (g_seed >> 8) % range;
+}
+
+// Same size and interface as the CBitVec<16384> in TransmitInfo.
+struct TransmitBits
+{
+	u32 words[16384 / 32];
+
+	void SetAll()
+	{
+		memset(this->words, 0xFF, sizeof(this->words));
+	}
+
+	bool IsBitSet(u32 bit) const
+	{
+		return this->words[bit >> 5] & (1u << (bit & 31));
+	}
+
+	void Set(u32 bit)
+	{
+		this->words[bit >> 5] |= 1u << (bit & 31);
+	}
+
+	void Clear(u32 bit)
+	{
+		this->words[bit >> 5] &= ~(1u << (bit & 31));
+	}
+
+	bool operator==(const TransmitBits &other) const
+	{
+		return memcmp(this->words, other.words, sizeof(this->words)) == 0;
+	}
+};
+
+// Stands in for a pawn found through EntityInstanceByClassIter_t, linked the way m_pNextByClass links them.
+struct Pawn
+{
+	u32 entIndex;
+	// -1 without a valid controller.
+	i32 slot;
+	Pawn *next;
+};
+
+struct Server
+{
+	std::vector<Pawn> pawns;
+	// Players that have the option on and are alive, what ShouldHide() returns.
+	bool shouldHide[MAXPLAYERS];
+	u64 hidingPlayers;
+	// Pawn of each connected slot, or nullptr.
+	Pawn *slotPawn[MAXPLAYERS];
+	u32 targets[MAXPLAYERS];
+	u32 targetCount;
+};
+
+// Every slot is a connected player, about one in eight pawns lost its controller and there are a few extra orphaned pawns.
+static_function void MakeServer(Server &server, u32 hidePercent, u32 orphanCount)
+{
+	server.pawns.clear();
+	server.hidingPlayers = 0;
+	server.targetCount = 0;
+	for (u32 i = 0; i < MAXPLAYERS; i++)
+	{
+		server.shouldHide[i] = Random(100) < hidePercent;
+		server.hidingPlayers |= server.shouldHide[i] ? 1ull << i : 0;
+		server.slotPawn[i] = nullptr;
+		server.targets[server.targetCount++] = i;
+	}
+	u32 entIndex = 1 + MAXPLAYERS;
+	for (u32 i = 0; i < MAXPLAYERS + orphanCount; i++)
+	{
+		Pawn pawn;
+		pawn.entIndex = entIndex;
+		entIndex += 1 + Random(40);
+		pawn.slot = i < MAXPLAYERS && Random(8) != 0 ? (i32)i : -1;
+		server.pawns.push_back(pawn);
+	}
+	// Entity iteration order isn't slot order.
+	for (u32 i = (u32)server.pawns.size() - 1; i > 0; i--)
+	{
+		std::swap(server.pawns[i], server.pawns[Random(i + 1)]);
+	}
+	for (u32 i = 0; i < server.pawns.size(); i++)
+	{
+		server.pawns[i].next = i + 1 < server.pawns.size() ? &server.pawns[i + 1] : nullptr;
+		if (server.pawns[i].slot >= 0)
+		{
+			server.slotPawn[server.pawns[i].slot] = &server.pawns[i];
+		}
+	}
+}
+
+// OnCheckTransmit before the matrix: every target walks every pawn and asks the quiet service about each one.
+static_function void WalkPawns(const Server &server, TransmitBits *bits)
+{
+	for (u32 t = 0; t < server.targetCount; t++)
+	{
+		u32 target = server.targets[t];
+		for (const Pawn *pawn = server.pawns.data(); pawn; pawn = pawn->next)
+		{
+			if (server.slotPawn[target] == pawn)
+			{
+				continue;
+			}
+			if (!bits[t].IsBitSet(pawn->entIndex))
+			{
+				continue;
+			}
+			if (pawn->slot < 0)
+			{
+				bits[t].Clear(pawn->entIndex);
+				continue;
+			}
+			if (!server.shouldHide[target])
+			{
+				continue;
+			}
+			if ((u32)pawn->slot != target)
+			{
+				bits[t].Clear(pawn->entIndex);
+			}
+		}
+	}
+}
+
+// UpdateHideMatrix() and the matrix half of OnCheckTransmit().
+static_function void ApplyMatrix(const Server &server, KZHideMatrix &matrix, i32 tick, TransmitBits *bits)
+{
+	matrix.Reset(tick);
+	for (const Pawn *pawn = server.pawns.data(); pawn; pawn = pawn->next)
+	{
+		if (pawn->slot < 0)
+		{
+			matrix.AddOrphan(pawn->entIndex);
+			continue;
+		}
+		matrix.AddPawn(pawn->slot, pawn->entIndex);
+	}
+	matrix.Build(server.hidingPlayers);
+	for (u32 t = 0; t < server.targetCount; t++)
+	{
+		matrix.Apply(server.targets[t], bits[t]);
+	}
+}
+
+static_global TransmitBits g_walkBits[MAXPLAYERS];
+static_global TransmitBits g_matrixBits[MAXPLAYERS];
+
+// Setting the pawn bits again is enough between ticks, nothing else gets cleared.
+static_function void ResetPawnBits(const Server &server, TransmitBits *bits)
+{
+	for (u32 t = 0; t < server.targetCount; t++)
+	{
+		for (const Pawn &pawn : server.pawns)
+		{
+			bits[t].Set(pawn.entIndex);
+		}
+	}
+}
+
+static_function void TestServer(const char *name, u32 hidePercent, u32 orphanCount)
+{
+	Server server;
+	MakeServer(server, hidePercent, orphanCount);
+	KZHideMatrix matrix;
+
+	for (u32 t = 0; t < server.targetCount; t++)
+	{
+		g_walkBits[t].SetAll();
+		g_matrixBits[t].SetAll();
+	}
+	WalkPawns(server, g_walkBits);
+	ApplyMatrix(server, matrix, 1, g_matrixBits);
+	u32 cleared = 0;
+	for (u32 t = 0; t < server.targetCount; t++)
+	{
+		CHECK(g_walkBits[t] == g_matrixBits[t], "%s: transmit bits of slot %u differ", name, server.targets[t]);
+		for (const Pawn &pawn : server.pawns)
+		{
+			cleared += !g_walkBits[t].IsBitSet(pawn.entIndex);
+		}
+	}
+
+	// One CheckTransmit per tick, the bits are reset for both so only the pawn handling differs.
+	const i32 ticks = 20000;
+	auto start = std::chrono::steady_clock::now();
+	for (i32 tick = 0; tick < ticks; tick++)
+	{
+		ResetPawnBits(server, g_walkBits);
+		WalkPawns(server, g_walkBits);
+	}
+	auto mid = std::chrono::steady_clock::now();
+	for (i32 tick = 0; tick < ticks; tick++)
+	{
+		ResetPawnBits(server, g_matrixBits);
+		ApplyMatrix(server, matrix, tick + 2, g_matrixBits);
+	}
+	auto end = std::chrono::steady_clock::now();
+	f64 walkMs = std::chrono::duration<f64, std::milli>(mid - start).count();
+	f64 matrixMs = std::chrono::duration<f64, std::milli>(end - mid).count();
+	for (u32 t = 0; t < server.targetCount; t++)
+	{
+		CHECK(g_walkBits[t] == g_matrixBits[t], "%s: transmit bits of slot %u differ after the timed runs", name, server.targets[t]);
+	}
+
+	printf("%s: %zu pawns, %u bits cleared per tick, per-target walk %.2f us/tick, matrix %.2f us/tick\n", name, server.pawns.size(),
+		   cleared, walkMs * 1000.0 / ticks, matrixMs * 1000.0 / ticks);
+}
+
+int main()
+{
+	TestServer("nobody hiding", 0, 0);
+	TestServer("quarter hiding", 25, 2);
+	TestServer("everyone hiding", 100, 4);
+
+	if (failures)
+	{
+		printf("%i check(s) failed\n", failures);
+		return 1;
+	}
+	printf("All quiet checks passed.\n");
+	return 0;
+}
@@ -0,0 +1,199 @@
+// Encodes synthetic ticks through ReplayBuffer and WriteHeader, lays them out the way KZReplayService writes replay files,
+// reads them back through ReplayReader and compares the result to the quantized input. Run through scripts/test-replay-format.sh.
+
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+
+#include "../../src/kz/replays/replay_format.h"
+
+static_global i32 failures;
+
+#define CHECK(condition, ...) \
+	do \
+	{ \
+		if (!(condition)) \
+		{ \
+			printf("FAILED %s:%i: %s: ", __FILE__, __LINE__, #condition); \
+			printf(__VA_ARGS__); \
+			printf("\n"); \
+			failures++; \
+		} \
+	} while (0)
+
+static_function f32 Quantized(f32 value, f32 scale)
+{
+	return (i32)roundf(value * scale) / scale;
+}
+
+static_function f32 QuantizedAngle(f32 value)
+{
+	i32 range = (i32)(360 * KZ_REPLAY_ANGLE_SCALE);
+	i32 angle = (i32)roundf(value * KZ_REPLAY_ANGLE_SCALE) % range;
+	if (angle >= range / 2)
+	{
+		angle -= range;
+	}
+	else if (angle < -range / 2)
+	{
+		angle += range;
+	}
+	return angle / KZ_REPLAY_ANGLE_SCALE;
+}
+
+// Ticks are mostly consecutive, with gaps, repeated tick numbers and records identical to the previous one mixed in.
+// Yaw runs past +-180 so the angle deltas have to wrap.
+static_function std::vector<ReplayTick> MakeTicks(u32 count)
+{
+	std::vector<ReplayTick> ticks;
+	ReplayTick tick {};
+	tick.tick = 1000;
+	tick.origin = {-1024.0f, 512.0f, 64.0f};
+	for (u32 i = 0; i < count; i++)
+	{
+		if (i > 0 && i % 97 == 0)
+		{
+			// Same record again, nothing but the tick changes.
+			tick.tick++;
+			ticks.push_back(tick);
+			continue;
+		}
+
+		if (i % 331 == 0)
+		{
+			// Repeated tick number.
+		}
+		else if (i % 211 == 0)
+		{
+			tick.tick += 1 + i % 7;
+		}
+		else
+		{
+			tick.tick++;
+		}
+		tick.velocity = {250.0f * sinf(i * 0.01f), 250.0f * cosf(i * 0.013f), (i % 80 < 40) ? 300.0f - i % 40 * 20.0f : 0.0f};
+		for (u32 axis = 0; axis < 3; axis++)
+		{
+			tick.origin[axis] += tick.velocity[axis] * 0.015625f;
+		}
+		tick.angles = {89.0f * sinf(i * 0.002f), fmodf(i * 1.7f, 400.0f) - 200.0f, 0.0f};
+		tick.buttons = ((i / 16) % 2 ? 0x2ull : 0) | ((i / 64) % 2 ? 0x8000000000ull : 0);
+		tick.flags = (i % 80 >= 40) ? 1 : 0;
+		ticks.push_back(tick);
+	}
+	return ticks;
+}
+
+static_function std::vector<u8> WriteFile(const ReplayHeader &header, const std::vector<ReplayChunk> &chunks)
+{
+	std::vector<u8> file;
+	KZ::replays::WriteHeader(header, file);
+	for (const ReplayChunk &chunk : chunks)
+	{
+		KZ::replays::WriteChunkHeader(chunk, file);
+		file.insert(file.end(), chunk.data.begin(), chunk.data.end());
+	}
+	return file;
+}
+
+static_function void TestRoundTrip(const char *name, u32 tickCount, u32 runLength)
+{
+	std::vector<ReplayTick> ticks = MakeTicks(tickCount);
+	ReplayBuffer buffer;
+	for (const ReplayTick &tick : ticks)
+	{
+		buffer.Append(tick);
+	}
+
+	i32 startTick = ticks[ticks.size() - runLength].tick;
+	std::vector<ReplayChunk> chunks;
+	buffer.CopyChunks(startTick, chunks);
+	CHECK(!chunks.empty(), "%s: no chunks", name);
+	CHECK(chunks.size() <= KZ_REPLAY_MAX_CHUNKS, "%s: %zu chunks", name, chunks.size());
+
+	ReplayHeader header;
+	header.steamID64 = 76561197960287930ull;
+	strcpy(header.map, "kz_roundtrip");
+	strcpy(header.course, "Main");
+	strcpy(header.mode, "CKZ");
+	header.time = 12.5f;
+	header.teleports = 3;
+	header.tickInterval = 0.015625f;
+	header.startTick = startTick;
+	header.chunkCount = (u32)chunks.size();
+
+	size_t recorded = 0;
+	for (const ReplayChunk &chunk : chunks)
+	{
+		recorded += chunk.tickCount;
+	}
+	std::vector<u8> file = WriteFile(header, chunks);
+
+	ReplayReader reader;
+	CHECK(reader.Load(file), "%s: header rejected", name);
+	const ReplayHeader &read = reader.GetHeader();
+	CHECK(read.steamID64 == header.steamID64 && !strcmp(read.map, header.map) && !strcmp(read.course, header.course)
+			  && !strcmp(read.mode, header.mode) && read.time == header.time && read.teleports == header.teleports
+			  && read.tickInterval == header.tickInterval && read.startTick == header.startTick && read.chunkCount == header.chunkCount,
+		  "%s: header mismatch", name);
+
+	// The copied chunks hold the newest ticks, so they line up with the end of the input.
+	size_t first = ticks.size() - recorded;
+	CHECK(ticks[first].tick <= startTick, "%s: run start %i isn't covered, first tick is %i", name, startTick, ticks[first].tick);
+	ReplayTick tick;
+	size_t decoded = 0;
+	for (; reader.ReadTick(tick); decoded++)
+	{
+		if (first + decoded >= ticks.size())
+		{
+			continue;
+		}
+		const ReplayTick &expected = ticks[first + decoded];
+		bool match = tick.tick == expected.tick && tick.buttons == expected.buttons && tick.flags == expected.flags && tick.angles[2] == 0.0f;
+		for (u32 i = 0; i < 3; i++)
+		{
+			match &= tick.origin[i] == Quantized(expected.origin[i], KZ_REPLAY_ORIGIN_SCALE);
+			match &= tick.velocity[i] == Quantized(expected.velocity[i], KZ_REPLAY_VELOCITY_SCALE);
+		}
+		for (u32 i = 0; i < 2; i++)
+		{
+			match &= tick.angles[i] == QuantizedAngle(expected.angles[i]);
+		}
+		if (!match)
+		{
+			CHECK(match, "%s: record %zu (tick %i) decoded as tick %i, origin %f %f %f, angles %f %f", name, decoded, expected.tick, tick.tick,
+				  tick.origin[0], tick.origin[1], tick.origin[2], tick.angles[0], tick.angles[1]);
+			break;
+		}
+	}
+	CHECK(!reader.IsCorrupt(), "%s: reader flagged the replay as corrupt", name);
+	CHECK(decoded == recorded, "%s: decoded %zu of %zu records", name, decoded, recorded);
+
+	// A file cut short in the middle of a chunk must be reported, not read past.
+	file.resize(file.size() - 3);
+	reader.Load(file);
+	while (reader.ReadTick(tick))
+	{
+	}
+	CHECK(reader.IsCorrupt(), "%s: truncated replay not flagged as corrupt", name);
+
+	printf("%s: %zu chunks, %zu records, %zu bytes\n", name, chunks.size(), recorded, file.size() + 3);
+}
+
+int main()
+{
+	// Fits in a single chunk.
+	TestRoundTrip("single chunk", KZ_REPLAY_CHUNK_TICKS / 2, KZ_REPLAY_CHUNK_TICKS / 4);
+	// Crosses chunk boundaries, only the chunks of the run are copied.
+	TestRoundTrip("chunk rollover", KZ_REPLAY_CHUNK_TICKS * 20 + 17, KZ_REPLAY_CHUNK_TICKS * 5 + 3);
+	// More than the buffer holds, the oldest chunks have been reused and the run needs all of the ones left.
+	TestRoundTrip("buffer wrap", KZ_REPLAY_CHUNK_TICKS * (KZ_REPLAY_MAX_CHUNKS + 40), KZ_REPLAY_CHUNK_TICKS * KZ_REPLAY_MAX_CHUNKS - 10);
+
+	if (failures)
+	{
+		printf("%i check(s) failed\n", failures);
+		return 1;
+	}
+	printf("All replay format checks passed.\n");
+	return 0;
+}
@@ -0,0 +1,266 @@
+// Registers a few hundred commands in ScmdTable from src/utils/scmd_table.h, dispatches a chat heavy stream of chat
+// commands and console command overrides through it and through the array scan it replaced, checks that the same
+// commands run in the same order, and times both. Run through scripts/bench-scmd.sh.
+
+#include <chrono>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include "../../src/utils/scmd_table.h"
+
+static_global i32 failures;
+
+#define CHECK(condition, ...) \
+	do \
+	{ \
+		if (!(condition)) \
+		{ \
+			printf("FAILED %s:%i: %s: ", __FILE__, __LINE__, #condition); \
+			printf(__VA_ARGS__); \
+			printf("\n"); \
+			failures++; \
+		} \
+	} while (0)
+
+static_global u32 g_seed = 1;
+
+static_function u32 Random(u32 range)
+{
+	g_seed = g_seed * 1664525u + 1013904223u;
+	return (g_seed >> 8) % range;
+}
+
+// Stands in for META_RES, true is MRES_SUPERCEDE.
+typedef bool Callback_t();
+
+static_function bool Ignore()
+{
+	return false;
+}
+
+static_function bool Supercede()
+{
+	return true;
+}
+
+// The command list and dispatch loops from before the hash buckets.
+struct ScanCmd
+{
+	bool hasConsolePrefix;
+	char name[SCMD_MAX_NAME_LEN];
+	Callback_t *callback;
+};
+
+struct ScanTable
+{
+	std::vector<ScanCmd> cmds;
+
+	void Add(const char *name, bool hasConsolePrefix, Callback_t *callback)
+	{
+		ScanCmd cmd = {hasConsolePrefix, "", callback};
+		snprintf(cmd.name, sizeof(cmd.name), "%s", name);
+		this->cmds.push_back(cmd);
+	}
+
+	void Remove(const char *name)
+	{
+		for (size_t i = 0; i < this->cmds.size(); i++)
+		{
+			if (!V_stricmp(this->cmds[i].name, name))
+			{
+				this->cmds.erase(this->cmds.begin() + i);
+				return;
+			}
+		}
+	}
+
+	bool Dispatch(const char *name, bool silent, std::vector<std::string> *log)
+	{
+		for (size_t i = 0; i < this->cmds.size(); i++)
+		{
+			const char *cmdName = this->cmds[i].hasConsolePrefix ? this->cmds[i].name + strlen(SCMD_CONSOLE_PREFIX) : this->cmds[i].name;
+			if (!V_stricmp(name, cmdName))
+			{
+				if (log)
+				{
+					log->push_back(this->cmds[i].name);
+				}
+				if (this->cmds[i].callback() || silent)
+				{
+					return true;
+				}
+			}
+		}
+		return false;
+	}
+};
+
+typedef ScmdTable<Callback_t> Table;
+
+static_function bool Dispatch(Table &table, const char *name, bool silent, std::vector<std::string> *log)
+{
+	return table.ForEachByShortName(name,
+									[&](Table::Cmd *cmd)
+									{
+										if (log)
+										{
+											log->push_back(cmd->name);
+										}
+										return cmd->callback() || silent;
+									});
+}
+
+static_global const char *g_names[] = {
+	"kz_help",    "kz_mode",       "kz_style",  "kz_hide",    "kz_hideweapon", "kz_checkpoint", "kz_cp",      "kz_teleport", "kz_tp",
+	"kz_undo",    "kz_prevcp",     "kz_nextcp", "kz_restart", "kz_r",          "kz_pause",      "kz_resume",  "kz_noclip",   "kz_nc",
+	"kz_goto",    "kz_spec",       "kz_specs",  "kz_pb",      "kz_wr",         "kz_maptop",     "kz_options", "kz_measure",  "kz_jsalways",
+	"kz_js",      "kz_beam",       "kz_panel",  "kz_tips",    "kz_lang",       "kz_rank",       "kz_top",     "kz_profile",  "kz_stop",
+	"kz_timer",   "kz_end",        "kz_start",  "kz_bonus",   "kz_course",     "kz_stage",      "kz_replay",  "kz_telemetry"};
+
+static_function void Register(Table &table, ScanTable &scan, const char *name, Callback_t *callback)
+{
+	if (table.IsFull() || table.FindByName(name))
+	{
+		return;
+	}
+	bool hasConsolePrefix = !strncasecmp(name, SCMD_CONSOLE_PREFIX, strlen(SCMD_CONSOLE_PREFIX));
+	table.Add(name, (i32)strlen(name), hasConsolePrefix, callback, false);
+	scan.Add(name, hasConsolePrefix, callback);
+}
+
+static_function void Unregister(Table &table, ScanTable &scan, const char *name)
+{
+	Table::Cmd *cmd = table.FindByName(name);
+	if (cmd)
+	{
+		table.Remove(cmd);
+	}
+	scan.Remove(name);
+}
+
+struct Message
+{
+	std::string name;
+	bool silent;
+};
+
+static_function void TestDispatch(u32 extraCmds)
+{
+	static_persist Table table;
+	table = {};
+	ScanTable scan;
+	char name[64];
+
+	// The plugin's own commands, a few of them also registered without the prefix.
+	for (const char *cmdName : g_names)
+	{
+		Register(table, scan, cmdName, Random(4) ? Ignore : Supercede);
+		if (Random(5) == 0)
+		{
+			Register(table, scan, cmdName + strlen(SCMD_CONSOLE_PREFIX), Random(2) ? Ignore : Supercede);
+		}
+	}
+	// Commands from other modules, some unregistered and replaced later so freed slots get reused.
+	for (u32 i = 0; i < extraCmds; i++)
+	{
+		snprintf(name, sizeof(name), "%scmd%u", Random(2) ? SCMD_CONSOLE_PREFIX : "", i);
+		Register(table, scan, name, Random(4) ? Ignore : Supercede);
+	}
+	for (u32 i = 0; i < extraCmds / 8; i++)
+	{
+		snprintf(name, sizeof(name), "%scmd%u", Random(2) ? SCMD_CONSOLE_PREFIX : "", Random(extraCmds));
+		Unregister(table, scan, name);
+	}
+	for (u32 i = 0; i < extraCmds / 16; i++)
+	{
+		snprintf(name, sizeof(name), "%sCMD%u", Random(2) ? SCMD_CONSOLE_PREFIX : "", Random(extraCmds * 2));
+		Register(table, scan, name, Random(4) ? Ignore : Supercede);
+	}
+
+	// Chat commands in any case, chat lines that look like commands but aren't, and console commands the game handles.
+	std::vector<Message> messages;
+	for (u32 i = 0; i < 20000; i++)
+	{
+		Message message {};
+		switch (Random(4))
+		{
+			case 0:
+			case 1:
+			{
+				const char *cmdName = g_names[Random(sizeof(g_names) / sizeof(g_names[0]))] + strlen(SCMD_CONSOLE_PREFIX);
+				message.name = cmdName;
+				for (char &c : message.name)
+				{
+					c = Random(4) ? c : toupper(c);
+				}
+				message.silent = Random(3) == 0;
+				break;
+			}
+			case 2:
+				snprintf(name, sizeof(name), "%s%u", Random(2) ? "gg" : "cmd", Random(extraCmds * 2 + 8));
+				message.name = name;
+				message.silent = Random(3) == 0;
+				break;
+			case 3:
+				message.name = Random(2) ? "jointeam" : "buy";
+				break;
+		}
+		messages.push_back(message);
+	}
+
+	std::vector<std::string> scanLog, tableLog;
+	u32 handled = 0;
+	for (const Message &message : messages)
+	{
+		scanLog.clear();
+		tableLog.clear();
+		bool scanResult = scan.Dispatch(message.name.c_str(), message.silent, &scanLog);
+		bool tableResult = Dispatch(table, message.name.c_str(), message.silent, &tableLog);
+		CHECK(scanResult == tableResult && scanLog == tableLog, "%u commands: '%s' ran %zu commands (%s) instead of %zu (%s)", table.cmdCount,
+			  message.name.c_str(), tableLog.size(), tableLog.empty() ? "" : tableLog[0].c_str(), scanLog.size(), scanLog.empty() ? "" : scanLog[0].c_str());
+		handled += scanResult;
+	}
+
+	const u32 rounds = 20;
+	u32 scanHandled = 0, tableHandled = 0;
+	auto start = std::chrono::steady_clock::now();
+	for (u32 round = 0; round < rounds; round++)
+	{
+		for (const Message &message : messages)
+		{
+			scanHandled += scan.Dispatch(message.name.c_str(), message.silent, nullptr);
+		}
+	}
+	auto mid = std::chrono::steady_clock::now();
+	for (u32 round = 0; round < rounds; round++)
+	{
+		for (const Message &message : messages)
+		{
+			tableHandled += Dispatch(table, message.name.c_str(), message.silent, nullptr);
+		}
+	}
+	auto end = std::chrono::steady_clock::now();
+	CHECK(scanHandled == tableHandled, "%u commands: timed dispatches disagree", table.cmdCount);
+
+	f64 dispatches = (f64)rounds * messages.size();
+	f64 scanNs = std::chrono::duration<f64, std::nano>(mid - start).count() / dispatches;
+	f64 tableNs = std::chrono::duration<f64, std::nano>(end - mid).count() / dispatches;
+	printf("%3zu commands: %u of %zu messages superceded, scan %7.1f ns/dispatch, hash buckets %5.1f ns/dispatch\n", scan.cmds.size(), handled,
+		   messages.size(), scanNs, tableNs);
+}
+
+int main()
+{
+	TestDispatch(0);
+	TestDispatch(150);
+	TestDispatch(400);
+
+	if (failures)
+	{
+		printf("%i check(s) failed\n", failures);
+		return 1;
+	}
+	printf("All scmd checks passed.\n");
+	return 0;
+}
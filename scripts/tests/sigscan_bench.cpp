@@ -0,0 +1,238 @@
+// Plants gamedata-like signatures in a synthetic code blob, resolves them with sigscan::Scan and with the per-signature
+// byte loop CModule::FindSignature used before, checks that both find the same first match and the same ambiguity, and
+// times both. Also round trips the offset cache. Run through scripts/bench-sigscan.sh.
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+#include "../../src/utils/sigscan.h"
+
+static_global i32 failures;
+
+#define CHECK(condition, ...) \
+	do \
+	{ \
+		if (!(condition)) \
+		{ \
+			printf("FAILED %s:%i: %s: ", __FILE__, __LINE__, #condition); \
+			printf(__VA_ARGS__); \
+			printf("\n"); \
+			failures++; \
+		} \
+	} while (0)
+
+static_global u32 g_seed = 7;
+
+static_function u32 Random(u32 range)
+{
+	g_seed = g_seed * 1664525u + 1013904223u;
+	return (g_seed >> 8) % range;
+}
+
+// Mostly the bytes that are everywhere in x86-64 code, so anchors and the full compare both get plenty of near misses.
+static_function u8 RandomCodeByte()
+{
+	static_persist const u8 common[] = {0x00, 0x48, 0x8B, 0x89, 0x0F, 0x41, 0xE8, 0xFF, 0x24, 0x4C, 0x8D, 0x74, 0x75, 0x85, 0xCC, 0x90, 0x83};
+	return Random(3) ? common[Random(sizeof(common))] : (u8)Random(256);
+}
+
+// The loop CModule::FindSignature ran for every signature, kept from reading past the end of the range.
+static_function void NaiveScan(const std::vector<sigscan::Range> &ranges, const std::vector<u8> &signature, sigscan::Result &result)
+{
+	result = {};
+	for (const sigscan::Range &range : ranges)
+	{
+		if (signature.size() > range.size)
+		{
+			continue;
+		}
+		for (size_t i = 0; i + signature.size() <= range.size; i++)
+		{
+			size_t matches = 0;
+			while (range.base[i + matches] == signature[matches] || signature[matches] == 0x2A)
+			{
+				if (++matches == signature.size())
+				{
+					break;
+				}
+			}
+			if (matches == signature.size())
+			{
+				if (result.matches++ == 0)
+				{
+					result.address = range.base + i;
+				}
+				if (result.matches >= 2)
+				{
+					return;
+				}
+			}
+		}
+	}
+}
+
+struct Blob
+{
+	std::vector<u8> memory;
+	std::vector<sigscan::Range> ranges;
+	std::vector<std::vector<u8>> signatures;
+};
+
+// Executable sections with gaps between them. Signatures are planted once, twice, across a section boundary or not at
+// all, and some are all common bytes or start or end with wildcards.
+static_function Blob MakeBlob(size_t size, u32 signatureCount)
+{
+	Blob blob;
+	blob.memory.resize(size);
+	for (u8 &value : blob.memory)
+	{
+		value = RandomCodeByte();
+	}
+
+	size_t sectionSize = size / 3;
+	for (size_t i = 0; i < 3; i++)
+	{
+		size_t start = i * sectionSize + (i ? 4096 : 0);
+		blob.ranges.push_back({blob.memory.data() + start, sectionSize - (i ? 4096 : 0) - 512});
+	}
+
+	for (u32 i = 0; i < signatureCount; i++)
+	{
+		std::vector<u8> signature(8 + Random(40));
+		for (size_t j = 0; j < signature.size(); j++)
+		{
+			signature[j] = (Random(5) == 0) ? 0x2A : RandomCodeByte();
+		}
+		if (i % 10 == 0)
+		{
+			signature.front() = 0x2A;
+		}
+		if (i % 10 == 1)
+		{
+			signature.back() = 0x2A;
+		}
+		if (i % 10 == 2)
+		{
+			// Only bytes that are everywhere, the anchor can't filter much.
+			for (u8 &value : signature)
+			{
+				value = value == 0x2A ? value : 0x48;
+			}
+		}
+
+		u32 kind = i % 7;
+		u32 copies = kind == 0 ? 0 : (kind == 1 ? 2 : 1);
+		for (u32 copy = 0; copy < copies; copy++)
+		{
+			const sigscan::Range &range = blob.ranges[Random(3)];
+			u8 *at = range.base + Random((u32)(range.size - signature.size()));
+			for (size_t j = 0; j < signature.size(); j++)
+			{
+				at[j] = signature[j] == 0x2A ? at[j] : signature[j];
+			}
+		}
+		if (kind == 6)
+		{
+			// Straddles the end of a section, neither scan may report it.
+			const sigscan::Range &range = blob.ranges[1];
+			u8 *at = range.base + range.size - signature.size() / 2;
+			for (size_t j = 0; j < signature.size(); j++)
+			{
+				at[j] = signature[j] == 0x2A ? at[j] : signature[j];
+			}
+		}
+		blob.signatures.push_back(signature);
+	}
+	return blob;
+}
+
+static_function f64 Milliseconds(std::chrono::steady_clock::time_point start)
+{
+	return std::chrono::duration<f64, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+static_function void TestAndBenchmark(const char *name, size_t size, u32 signatureCount)
+{
+	Blob blob = MakeBlob(size, signatureCount);
+	std::vector<sigscan::Pattern> patterns;
+	for (const std::vector<u8> &signature : blob.signatures)
+	{
+		patterns.emplace_back(signature.data(), signature.size());
+	}
+
+	auto start = std::chrono::steady_clock::now();
+	std::vector<sigscan::Result> results;
+	sigscan::Scan(blob.ranges, patterns, results);
+	f64 scan = Milliseconds(start);
+
+	start = std::chrono::steady_clock::now();
+	std::vector<sigscan::Result> expected(blob.signatures.size());
+	for (size_t i = 0; i < blob.signatures.size(); i++)
+	{
+		NaiveScan(blob.ranges, blob.signatures[i], expected[i]);
+	}
+	f64 naive = Milliseconds(start);
+
+	u32 found = 0, ambiguous = 0;
+	for (size_t i = 0; i < blob.signatures.size(); i++)
+	{
+		CHECK(results[i].address == expected[i].address && results[i].matches == expected[i].matches,
+			  "%s: signature %zu (%zu bytes) found %u times at +%td, expected %u times at +%td", name, i, blob.signatures[i].size(),
+			  results[i].matches, results[i].address ? (u8 *)results[i].address - blob.memory.data() : -1, expected[i].matches,
+			  expected[i].address ? (u8 *)expected[i].address - blob.memory.data() : -1);
+		found += expected[i].matches == 1;
+		ambiguous += expected[i].matches > 1;
+	}
+	printf("%s: %zu MB, %u signatures (%u unique, %u ambiguous): sigscan::Scan %.1f ms, per signature loop %.1f ms (%.1fx)\n", name, size >> 20,
+		   signatureCount, found, ambiguous, scan, naive, naive / scan);
+}
+
+static_function void TestCache()
+{
+	char path[] = "/tmp/cs2kz-sigcache-XXXXXX";
+	i32 fd = mkstemp(path);
+	CHECK(fd != -1, "couldn't create a temporary file");
+	if (fd == -1)
+	{
+		return;
+	}
+
+	sigscan::Cache cache;
+	u64 offset = 0;
+	cache.Set("server", "build-id-1", sigscan::HashString("48 8B ? ? 89"), 0x1234);
+	cache.Set("engine2", "build-id-2", sigscan::HashString("E8 ? ? ? ?"), 0xABCDEF);
+	CHECK(cache.IsDirty(), "cache isn't dirty after setting entries");
+	cache.Save(path);
+
+	sigscan::Cache loaded;
+	loaded.Load(path);
+	CHECK(loaded.Find("server", "build-id-1", sigscan::HashString("48 8B ? ? 89"), offset) && offset == 0x1234, "offset %llx", offset);
+	CHECK(!loaded.Find("server", "build-id-other", sigscan::HashString("48 8B ? ? 89"), offset), "found an entry for another binary");
+	CHECK(!loaded.Find("server", "build-id-1", sigscan::HashString("48 8B"), offset), "found an entry for another signature");
+
+	// Entries that weren't looked up since loading are dropped on save.
+	loaded.Save(path);
+	sigscan::Cache reloaded;
+	reloaded.Load(path);
+	CHECK(reloaded.Find("server", "build-id-1", sigscan::HashString("48 8B ? ? 89"), offset), "used entry was dropped");
+	CHECK(!reloaded.Find("engine2", "build-id-2", sigscan::HashString("E8 ? ? ? ?"), offset), "unused entry was kept");
+	remove(path);
+}
+
+int main()
+{
+	TestAndBenchmark("small module", 2 << 20, 20);
+	TestAndBenchmark("server-sized module", 32 << 20, 62);
+	TestCache();
+
+	if (failures)
+	{
+		printf("%i check(s) failed\n", failures);
+		return 1;
+	}
+	printf("All sigscan checks passed.\n");
+	return 0;
+}
@@ -0,0 +1,301 @@
+// Replays synthetic AA calls through the strafe stat reduction that Strafe::End used before StrafeTickData and through
+// StrafeTickData::Classify/Accumulate, and checks that every stat comes out bit-identical. Also checks the angle ratio
+// median and max against a full sort, then times both reductions. Run through scripts/test-strafe-stats.sh.
+//
+// CalcIdealGain() and the yaw difference need the mode cvars and the SDK, so the calls carry those values precomputed.
+// Both paths read the same values, only the classification and the sums are being compared.
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+#include "mathlib/vector.h"
+#include "../../src/kz/jumpstats/kz_strafeticks.h"
+
+static_global i32 failures;
+
+#define CHECK(condition, ...) \
+	do \
+	{ \
+		if (!(condition)) \
+		{ \
+			printf("FAILED %s:%i: %s: ", __FILE__, __LINE__, #condition); \
+			printf(__VA_ARGS__); \
+			printf("\n"); \
+			failures++; \
+		} \
+	} while (0)
+
+struct TestAACall
+{
+	f32 externalSpeedDiff;
+	f32 yawDifference;
+	f32 wishspeed;
+	f32 duration;
+	bool movementPressed;
+	Vector velocityPre;
+	Vector velocityPost;
+	f32 idealGain;
+};
+
+// The fields of Strafe that End() fills in.
+struct StrafeStats
+{
+	f32 duration;
+	f32 badAngles;
+	f32 overlap;
+	f32 deadAir;
+	f32 syncDuration;
+	f32 width;
+	f32 airGain;
+	f32 maxGain;
+	f32 airLoss;
+	f32 externalGain;
+	f32 externalLoss;
+};
+
+// Strafe::End() before StrafeTickData, minus CalcAngleRatioStats().
+static_function void EndBefore(const std::vector<TestAACall> &aaCalls, StrafeStats &stats)
+{
+	for (size_t i = 0; i < aaCalls.size(); i++)
+	{
+		stats.duration += aaCalls[i].duration;
+		// Calculate BA/DA/OL
+		if (aaCalls[i].wishspeed == 0)
+		{
+			if (aaCalls[i].movementPressed)
+			{
+				stats.overlap += aaCalls[i].duration;
+			}
+			else
+			{
+				stats.deadAir += aaCalls[i].duration;
+			}
+		}
+		else if ((aaCalls[i].velocityPost - aaCalls[i].velocityPre).Length2D() <= JS_EPSILON)
+		{
+			// This gain could just be from quantized float stuff.
+			stats.badAngles += aaCalls[i].duration;
+		}
+		// Calculate sync.
+		else if (aaCalls[i].velocityPost.Length2D() - aaCalls[i].velocityPre.Length2D() > JS_EPSILON)
+		{
+			stats.syncDuration += aaCalls[i].duration;
+		}
+
+		// Gain/loss.
+		stats.maxGain += aaCalls[i].idealGain;
+		f32 speedDiff = aaCalls[i].velocityPost.Length2D() - aaCalls[i].velocityPre.Length2D();
+		if (speedDiff > 0)
+		{
+			stats.airGain += speedDiff;
+		}
+		else
+		{
+			stats.airLoss += speedDiff;
+		}
+		f32 externalSpeedDiff = aaCalls[i].externalSpeedDiff;
+		if (externalSpeedDiff > 0)
+		{
+			stats.externalGain += externalSpeedDiff;
+		}
+		else
+		{
+			stats.externalLoss += externalSpeedDiff;
+		}
+		stats.width += fabs(aaCalls[i].yawDifference);
+	}
+}
+
+// StrafeTickData::Build() with the SDK calls swapped for the precomputed values, then Strafe::End().
+static_function void EndAfter(const std::vector<TestAACall> &aaCalls, StrafeTickData &ticks, StrafeStats &stats)
+{
+	i32 count = (i32)aaCalls.size();
+	ticks.duration.SetCount(count);
+	ticks.speedPre.SetCount(count);
+	ticks.speedPost.SetCount(count);
+	ticks.idealGain.SetCount(count);
+	ticks.externalSpeedDiff.SetCount(count);
+	ticks.yawDifference.SetCount(count);
+	ticks.kind.SetCount(count);
+
+	for (i32 i = 0; i < count; i++)
+	{
+		const TestAACall &call = aaCalls[i];
+		ticks.duration[i] = call.duration;
+		ticks.speedPre[i] = call.velocityPre.Length2D();
+		ticks.speedPost[i] = call.velocityPost.Length2D();
+		ticks.idealGain[i] = call.idealGain;
+		ticks.externalSpeedDiff[i] = call.externalSpeedDiff;
+		ticks.yawDifference[i] = fabs(call.yawDifference);
+		ticks.kind[i] = StrafeTickData::Classify(call.wishspeed, call.movementPressed, (call.velocityPost - call.velocityPre).Length2D(),
+												 ticks.speedPre[i], ticks.speedPost[i]);
+	}
+
+	ticks.Accumulate(stats);
+}
+
+static_global u32 g_seed = 12345;
+
+static_function f32 Random(f32 min, f32 max)
+{
+	g_seed = g_seed * 1664525u + 1013904223u;
+	return min + (max - min) * ((g_seed >> 8) / 16777216.0f);
+}
+
+// Mostly regular strafing with dead air, overlap, quantized no-gain ticks, losses and trigger pushes mixed in.
+static_function std::vector<TestAACall> MakeStrafe(i32 count)
+{
+	std::vector<TestAACall> calls(count);
+	Vector velocity = {Random(-250.0f, 250.0f), Random(-250.0f, 250.0f), Random(-300.0f, 300.0f)};
+	for (TestAACall &call : calls)
+	{
+		call.duration = Random(0.0f, 1.0f) < 0.1f ? Random(0.0f, ENGINE_FIXED_TICK_INTERVAL) : ENGINE_FIXED_TICK_INTERVAL;
+		call.yawDifference = Random(-4.0f, 4.0f);
+		call.idealGain = Random(0.0f, 1.5f);
+		call.velocityPre = velocity;
+
+		f32 kind = Random(0.0f, 1.0f);
+		call.wishspeed = kind < 0.15f ? 0.0f : 250.0f;
+		call.movementPressed = Random(0.0f, 1.0f) < 0.5f;
+		if (kind < 0.25f)
+		{
+			// No change at all, or less than the quantization threshold.
+			f32 nudge = kind < 0.2f ? 0.0f : Random(-0.02f, 0.02f);
+			call.velocityPost = {velocity.x + nudge, velocity.y, velocity.z};
+		}
+		else if (kind < 0.3f)
+		{
+			// Right at the sync threshold.
+			f32 speed = velocity.Length2D();
+			f32 scale = (speed + JS_EPSILON) / speed;
+			call.velocityPost = {velocity.x * scale, velocity.y * scale, velocity.z};
+		}
+		else
+		{
+			call.velocityPost = {velocity.x + Random(-1.5f, 1.5f), velocity.y + Random(-1.5f, 1.5f), velocity.z - 12.0f};
+		}
+
+		f32 external = Random(0.0f, 1.0f);
+		call.externalSpeedDiff = external < 0.9f ? 0.0f : (external < 0.95f ? Random(-30.0f, 0.0f) : Random(0.0f, 30.0f));
+		if (external < 0.01f)
+		{
+			call.externalSpeedDiff = -0.0f;
+		}
+		velocity = call.velocityPost;
+	}
+	return calls;
+}
+
+static_function void TestEquivalence()
+{
+	StrafeTickData ticks;
+	for (i32 strafe = 0; strafe < 20000; strafe++)
+	{
+		std::vector<TestAACall> calls = MakeStrafe(strafe % 97);
+
+		// Collisions may already have added external gain/loss before the strafe ends.
+		StrafeStats before {};
+		before.externalGain = strafe % 3 == 0 ? Random(0.0f, 10.0f) : 0.0f;
+		before.externalLoss = strafe % 5 == 0 ? Random(-10.0f, 0.0f) : 0.0f;
+		StrafeStats after = before;
+
+		EndBefore(calls, before);
+		EndAfter(calls, ticks, after);
+		if (memcmp(&before, &after, sizeof(before)))
+		{
+			CHECK(false,
+				  "strafe %i (%zu calls) differs:\n"
+				  "  duration %a %a, badAngles %a %a, overlap %a %a, deadAir %a %a, sync %a %a, width %a %a\n"
+				  "  airGain %a %a, maxGain %a %a, airLoss %a %a, externalGain %a %a, externalLoss %a %a",
+				  strafe, calls.size(), before.duration, after.duration, before.badAngles, after.badAngles, before.overlap, after.overlap,
+				  before.deadAir, after.deadAir, before.syncDuration, after.syncDuration, before.width, after.width, before.airGain,
+				  after.airGain, before.maxGain, after.maxGain, before.airLoss, after.airLoss, before.externalGain, after.externalGain,
+				  before.externalLoss, after.externalLoss);
+			break;
+		}
+	}
+}
+
+static_function void TestRatioMedianAndMax()
+{
+	for (i32 count = 1; count < 200; count++)
+	{
+		CUtlVector<f32> ratios;
+		std::vector<f32> sorted;
+		for (i32 i = 0; i < count; i++)
+		{
+			// Plenty of repeated values, like the -1 and 1 ratios of ticks outside the gain window.
+			f32 ratio = i % 4 == 0 ? -1.0f : (i % 4 == 1 ? 1.0f : Random(-1.0f, 1.0f));
+			ratios.AddToTail(ratio);
+			sorted.push_back(ratio);
+		}
+		std::sort(sorted.begin(), sorted.end());
+
+		f32 median, max;
+		StrafeTickData::RatioMedianAndMax(ratios, median, max);
+		CHECK(median == sorted[count / 2], "%i ratios: median %f, expected %f", count, median, sorted[count / 2]);
+		CHECK(max == sorted[count - 1], "%i ratios: max %f, expected %f", count, max, sorted[count - 1]);
+	}
+}
+
+static_function void Benchmark()
+{
+	std::vector<std::vector<TestAACall>> strafes;
+	size_t callCount = 0;
+	for (i32 i = 0; i < 4096; i++)
+	{
+		strafes.push_back(MakeStrafe(8 + i % 48));
+		callCount += strafes.back().size();
+	}
+
+	const i32 rounds = 50;
+	StrafeStats total {};
+
+	auto start = std::chrono::steady_clock::now();
+	for (i32 round = 0; round < rounds; round++)
+	{
+		for (const std::vector<TestAACall> &strafe : strafes)
+		{
+			StrafeStats stats {};
+			EndBefore(strafe, stats);
+			total.width += stats.width;
+		}
+	}
+	auto middle = std::chrono::steady_clock::now();
+
+	StrafeTickData ticks;
+	for (i32 round = 0; round < rounds; round++)
+	{
+		for (const std::vector<TestAACall> &strafe : strafes)
+		{
+			StrafeStats stats {};
+			EndAfter(strafe, ticks, stats);
+			total.width += stats.width;
+		}
+	}
+	auto end = std::chrono::steady_clock::now();
+
+	f64 calls = (f64)callCount * rounds;
+	f64 before = std::chrono::duration<f64, std::nano>(middle - start).count() / calls;
+	f64 after = std::chrono::duration<f64, std::nano>(end - middle).count() / calls;
+	printf("strafe stats: per AA call %.2f ns before, %.2f ns with StrafeTickData (%.2fx), checksum %f\n", before, after, before / after, total.width);
+}
+
+int main()
+{
+	TestEquivalence();
+	TestRatioMedianAndMax();
+	Benchmark();
+
+	if (failures)
+	{
+		printf("%i check(s) failed\n", failures);
+		return 1;
+	}
+	printf("All strafe stat checks passed.\n");
+	return 0;
+}
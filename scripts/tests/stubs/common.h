@@ -0,0 +1,54 @@
+#pragma once
+// Just enough of src/common.h for the SDK independent sources that the scripts/tests programs compile.
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <strings.h>
+
+// Standard headers the real common.h gets through the SDK.
+#include <optional>
+#include <unordered_map>
+#include <vector>
+
+#define MAXPLAYERS 64
+
+#define ENGINE_FIXED_TICK_INTERVAL 0.015625f
+#define ENGINE_FIXED_TICK_RATE     (1.0f / ENGINE_FIXED_TICK_INTERVAL)
+#define EPSILON                    0.000001f
+
+#define static_global   static
+#define static_persist  static
+#define static_function static
+
+typedef int8_t i8;
+typedef int16_t i16;
+typedef int32_t i32;
+typedef long long i64; // int64 in the SDK
+
+typedef uint8_t u8;
+typedef uint16_t u16;
+typedef uint32_t u32;
+typedef unsigned long long u64; // uint64 in the SDK
+
+typedef unsigned char byte;
+
+typedef float f32;
+typedef double f64;
+
+#define META_CONPRINTF printf
+#define Warning        printf
+
+#define V_snprintf snprintf
+#define V_strncmp  strncmp
+#define V_stricmp  strcasecmp
+#define V_memset   memset
+#define V_strlen(s) ((int)strlen(s))
+
+// From tier0/basetypes.h.
+#define MIN(a, b) (((a) < (b)) ? (a) : (b))
+#define MAX(a, b) (((a) > (b)) ? (a) : (b))
+
+#define KZ_STREQ(a, b)             (strcmp(a, b) == 0)
+#define KZ_STREQI(a, b)            (strcasecmp(a, b) == 0)
+#define KZ_STREQLEN(a, b, maxlen)  (strncmp(a, b, maxlen) == 0)
+#define KZ_STREQILEN(a, b, maxlen) (strncasecmp(a, b, maxlen) == 0)
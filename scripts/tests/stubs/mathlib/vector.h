@@ -0,0 +1,43 @@
+#pragma once
+// Stand-ins for the SDK's Vector and QAngle, with only the members the scripts/tests programs use.
+#include <math.h>
+
+struct Vector
+{
+	float x, y, z;
+
+	float &operator[](int i)
+	{
+		return (&x)[i];
+	}
+
+	float operator[](int i) const
+	{
+		return (&x)[i];
+	}
+
+	Vector operator-(const Vector &other) const
+	{
+		return {x - other.x, y - other.y, z - other.z};
+	}
+
+	float Length2D() const
+	{
+		return sqrtf(x * x + y * y);
+	}
+};
+
+struct QAngle
+{
+	float x, y, z;
+
+	float &operator[](int i)
+	{
+		return (&x)[i];
+	}
+
+	float operator[](int i) const
+	{
+		return (&x)[i];
+	}
+};
@@ -0,0 +1,2 @@
+#pragma once
+// The SDK's debug allocator hooks, nothing to do outside the engine.
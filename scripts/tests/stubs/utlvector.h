@@ -0,0 +1,66 @@
+#pragma once
+// CUtlVector on top of std::vector, with only the members the SDK independent sources use.
+#include <algorithm>
+#include <vector>
+
+#define FOR_EACH_VEC(vecName, iteratorName) for (int iteratorName = 0; iteratorName < (vecName).Count(); iteratorName++)
+
+template<typename T>
+class CUtlVector
+{
+public:
+	int Count() const
+	{
+		return (int)this->items.size();
+	}
+
+	void SetCount(int count)
+	{
+		this->items.resize(count);
+	}
+
+	void RemoveAll()
+	{
+		this->items.clear();
+	}
+
+	int AddToTail(const T &item)
+	{
+		this->items.push_back(item);
+		return this->Count() - 1;
+	}
+
+	bool FindAndRemove(const T &item)
+	{
+		auto it = std::find(this->items.begin(), this->items.end(), item);
+		if (it == this->items.end())
+		{
+			return false;
+		}
+		this->items.erase(it);
+		return true;
+	}
+
+	T *Base()
+	{
+		return this->items.data();
+	}
+
+	const T *Base() const
+	{
+		return this->items.data();
+	}
+
+	T &operator[](int i)
+	{
+		return this->items[i];
+	}
+
+	const T &operator[](int i) const
+	{
+		return this->items[i];
+	}
+
+private:
+	std::vector<T> items;
+};
@@ -0,0 +1,376 @@
+// Runs 10k timers through the heap scheduler in src/utils/ctimer.cpp and through the per-frame scan it replaced, checks
+// that the same timers run on the same frames, and times both. Run through scripts/bench-timers.sh.
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <vector>
+
+#include "../../src/utils/ctimer_base.h"
+
+static_global i32 failures;
+
+#define CHECK(condition, ...) \
+	do \
+	{ \
+		if (!(condition)) \
+		{ \
+			printf("FAILED %s:%i: %s: ", __FILE__, __LINE__, #condition); \
+			printf(__VA_ARGS__); \
+			printf("\n"); \
+			failures++; \
+		} \
+	} while (0)
+
+static_global u32 g_seed = 1;
+
+static_function u32 Random(u32 range)
+{
+	g_seed = g_seed * 1664525u + 1013904223u;
+	return (g_seed >> 8) % range;
+}
+
+// Each execution appends the timer's id to the log, and the timer stops after a fixed number of runs.
+class TestTimer : public CTimerBase
+{
+public:
+	TestTimer(u32 id, f64 interval, bool useRealTime, i32 runs, std::vector<u32> *log)
+		: CTimerBase(interval, useRealTime), id(id), runsLeft(runs), log(log)
+	{
+	}
+
+	bool Execute() override
+	{
+		if (this->log)
+		{
+			this->log->push_back(this->id);
+		}
+		// Some timers change their interval as they go, like the ones returning a computed delay.
+		if (this->log && this->id % 7 == 0)
+		{
+			this->interval = this->interval * 0.5 + 0.05;
+		}
+		return --this->runsLeft > 0;
+	}
+
+	u32 id;
+	i32 runsLeft;
+	std::vector<u32> *log;
+};
+
+// ProcessTimerList() from before the heap, over one list per persistence.
+struct ScanTimers
+{
+	std::vector<TestTimer *> timers[2];
+
+	void Process(f64 curtime, f64 realtime)
+	{
+		for (std::vector<TestTimer *> &list : this->timers)
+		{
+			for (i32 i = (i32)list.size() - 1; i >= 0; i--)
+			{
+				TestTimer *timer = list[i];
+				f64 currentTime = timer->useRealTime ? realtime : curtime;
+				if (timer->lastExecute == -1)
+				{
+					timer->lastExecute = currentTime;
+				}
+
+				if (timer->lastExecute + timer->interval <= currentTime)
+				{
+					if (!timer->Execute())
+					{
+						delete timer;
+						list.erase(list.begin() + i);
+					}
+					else
+					{
+						timer->lastExecute = currentTime;
+					}
+				}
+			}
+		}
+	}
+
+	void Cancel(u32 id)
+	{
+		for (std::vector<TestTimer *> &list : this->timers)
+		{
+			for (size_t i = 0; i < list.size(); i++)
+			{
+				if (list[i]->id == id)
+				{
+					delete list[i];
+					list.erase(list.begin() + i);
+					return;
+				}
+			}
+		}
+	}
+
+	void RemoveNonPersistent()
+	{
+		for (TestTimer *timer : this->timers[0])
+		{
+			delete timer;
+		}
+		this->timers[0].clear();
+	}
+
+	void Clear()
+	{
+		this->RemoveNonPersistent();
+		for (TestTimer *timer : this->timers[1])
+		{
+			delete timer;
+		}
+		this->timers[1].clear();
+	}
+};
+
+struct Clocks
+{
+	f64 curtime = 100.0;
+	f64 realtime = 5000.0;
+
+	void Advance(u32 frame)
+	{
+		this->curtime += ENGINE_FIXED_TICK_INTERVAL;
+		// Real time drifts around the tick interval.
+		this->realtime += ENGINE_FIXED_TICK_INTERVAL * (0.75 + (frame * 37 % 11) / 20.0);
+	}
+};
+
+struct TimerSpec
+{
+	f64 interval;
+	bool useRealTime;
+	bool persistent;
+	i32 runs;
+};
+
+static_function TimerSpec MakeSpec()
+{
+	static_persist const f64 intervals[] = {0.0, ENGINE_FIXED_TICK_INTERVAL, 0.1, 0.25, 0.5, 1.0, 1.5, 5.0};
+	TimerSpec spec;
+	spec.interval = Random(4) ? intervals[Random(8)] : Random(2000) / 1000.0;
+	spec.useRealTime = Random(4) == 0;
+	spec.persistent = Random(3) != 0;
+	spec.runs = Random(5) == 0 ? 1 : 1 + Random(40);
+	return spec;
+}
+
+// Schedules, cancels and map changes between frames, and compares which timers ran on each frame.
+static_function void TestAgainstScan()
+{
+	std::vector<u32> heapLog, scanLog;
+	ScanTimers scan;
+	// Handles of the scheduled timers by id, for cancelling. Timers that stopped on their own are deleted, so they're
+	// only cancelled through ids that are known to still be running on both sides.
+	std::vector<std::pair<u32, TestTimer *>> cancellable;
+	Clocks clocks;
+	u32 nextID = 1;
+
+	for (u32 frame = 0; frame < 64 * 120; frame++)
+	{
+		u32 toAdd = frame == 0 ? 10000 : Random(8);
+		for (u32 i = 0; i < toAdd; i++)
+		{
+			TimerSpec spec = MakeSpec();
+			u32 id = nextID++;
+			TestTimer *heapTimer = new TestTimer(id, spec.interval, spec.useRealTime, spec.runs, &heapLog);
+			ScheduleTimer(heapTimer, spec.persistent);
+			scan.timers[spec.persistent ? 1 : 0].push_back(new TestTimer(id, spec.interval, spec.useRealTime, spec.runs, &scanLog));
+			// Timers that can't stop on their own can be cancelled safely at any time.
+			if (spec.runs > 1000)
+			{
+				cancellable.push_back({id, heapTimer});
+			}
+		}
+
+		// Cancel timers that never stop on their own, otherwise the handle could be stale on the heap side.
+		if (frame % 5 == 0)
+		{
+			TimerSpec spec = MakeSpec();
+			u32 id = nextID++;
+			TestTimer *heapTimer = new TestTimer(id, spec.interval, spec.useRealTime, 1 << 30, &heapLog);
+			ScheduleTimer(heapTimer, true);
+			scan.timers[1].push_back(new TestTimer(id, spec.interval, spec.useRealTime, 1 << 30, &scanLog));
+			cancellable.push_back({id, heapTimer});
+		}
+		if (frame % 3 == 0 && !cancellable.empty())
+		{
+			size_t index = Random((u32)cancellable.size());
+			CancelTimer(cancellable[index].second);
+			// The scheduler doesn't own cancelled timers, deleting right away lets new timers reuse the address.
+			delete cancellable[index].second;
+			scan.Cancel(cancellable[index].first);
+			cancellable.erase(cancellable.begin() + index);
+		}
+
+		clocks.Advance(frame);
+		heapLog.clear();
+		scanLog.clear();
+		ProcessTimers(clocks.curtime, clocks.realtime);
+		scan.Process(clocks.curtime, clocks.realtime);
+
+		// Within a frame the heap runs timers by due time, the scan ran them by list position.
+		std::sort(heapLog.begin(), heapLog.end());
+		std::sort(scanLog.begin(), scanLog.end());
+		if (heapLog != scanLog)
+		{
+			CHECK(heapLog == scanLog, "frame %u: heap ran %zu timers, scan ran %zu", frame, heapLog.size(), scanLog.size());
+			break;
+		}
+
+		// Map change, none of the cancellable timers are non-persistent.
+		if (frame % 2000 == 1999)
+		{
+			RemoveNonPersistentTimers();
+			scan.RemoveNonPersistent();
+		}
+	}
+
+	for (auto &[id, timer] : cancellable)
+	{
+		CancelTimer(timer);
+		delete timer;
+	}
+	RemoveNonPersistentTimers();
+	scan.Clear();
+}
+
+// A timer cancelling itself or another one from Execute() must not run again and isn't deleted by the scheduler.
+class CancellingTimer : public CTimerBase
+{
+public:
+	CancellingTimer(CTimerBase *target, i32 *runs) : CTimerBase(0.1, false), target(target), runs(runs) {}
+
+	bool Execute() override
+	{
+		(*this->runs)++;
+		CancelTimer(this->target ? this->target : this);
+		return true;
+	}
+
+	CTimerBase *target;
+	i32 *runs;
+};
+
+static_function void TestCancelFromExecute()
+{
+	i32 selfRuns = 0, otherRuns = 0, victimRuns = 0;
+	CancellingTimer self(nullptr, &selfRuns);
+	CancellingTimer victim(nullptr, &victimRuns);
+	victim.interval = 0.2;
+	CancellingTimer other(&victim, &otherRuns);
+	ScheduleTimer(&self, true);
+	ScheduleTimer(&victim, true);
+	ScheduleTimer(&other, true);
+
+	f64 time = 0.0;
+	for (i32 frame = 0; frame < 64; frame++)
+	{
+		ProcessTimers(time, time);
+		time += 0.05;
+	}
+	CHECK(selfRuns == 1, "self cancelling timer ran %i times", selfRuns);
+	CHECK(victimRuns == 0, "timer cancelled by another one ran %i times", victimRuns);
+	CHECK(otherRuns > 10, "cancelling timer ran %i times", otherRuns);
+	CancelTimer(&other);
+	ProcessTimers(time + 1.0, time + 1.0);
+}
+
+// Runs the same set of repeating timers through both schedulers for a minute of frames.
+static_function void BenchmarkRepeating(const char *name, f64 minInterval, f64 maxInterval)
+{
+	const u32 timerCount = 10000;
+	const u32 frames = 64 * 60;
+
+	ScanTimers scan;
+	std::vector<TestTimer *> heapTimers;
+	for (u32 i = 0; i < timerCount; i++)
+	{
+		f64 interval = minInterval + (maxInterval - minInterval) * Random(10000) / 10000.0;
+		bool useRealTime = i % 4 == 0;
+		heapTimers.push_back(new TestTimer(i, interval, useRealTime, 1 << 30, nullptr));
+		ScheduleTimer(heapTimers.back(), true);
+		scan.timers[1].push_back(new TestTimer(i, interval, useRealTime, 1 << 30, nullptr));
+	}
+
+	Clocks heapClocks, scanClocks;
+	auto start = std::chrono::steady_clock::now();
+	for (u32 frame = 0; frame < frames; frame++)
+	{
+		heapClocks.Advance(frame);
+		ProcessTimers(heapClocks.curtime, heapClocks.realtime);
+	}
+	auto middle = std::chrono::steady_clock::now();
+	for (u32 frame = 0; frame < frames; frame++)
+	{
+		scanClocks.Advance(frame);
+		scan.Process(scanClocks.curtime, scanClocks.realtime);
+	}
+	auto end = std::chrono::steady_clock::now();
+
+	f64 heap = std::chrono::duration<f64, std::micro>(middle - start).count() / frames;
+	f64 scanned = std::chrono::duration<f64, std::micro>(end - middle).count() / frames;
+	printf("%u timers every %g-%gs (%s): %.2f us/frame with the heap, %.2f us/frame scanning (%.1fx)\n", timerCount, minInterval, maxInterval, name,
+		   heap, scanned, scanned / heap);
+
+	for (TestTimer *timer : heapTimers)
+	{
+		CancelTimer(timer);
+		delete timer;
+	}
+	scan.Clear();
+	ProcessTimers(heapClocks.curtime, heapClocks.realtime);
+}
+
+static_function void Benchmark()
+{
+	// Most timers idle on any given frame, like per-player tips, reminders and periodic checks.
+	BenchmarkRepeating("mostly idle", 1.0, 60.0);
+	// A few percent of the timers due on every frame.
+	BenchmarkRepeating("busy", 0.1, 5.0);
+
+	// Scheduling and cancelling a burst of timers, like everyone reconnecting at once.
+	const u32 timerCount = 10000;
+	std::vector<TestTimer *> burst;
+	for (u32 i = 0; i < timerCount; i++)
+	{
+		burst.push_back(new TestTimer(i, 1.0, false, 1, nullptr));
+	}
+	auto start = std::chrono::steady_clock::now();
+	for (TestTimer *timer : burst)
+	{
+		ScheduleTimer(timer, false);
+	}
+	ProcessTimers(0.0, 0.0);
+	for (TestTimer *timer : burst)
+	{
+		CancelTimer(timer);
+	}
+	auto end = std::chrono::steady_clock::now();
+	printf("%u timers scheduled, queued and cancelled in %.2f ms\n", timerCount, std::chrono::duration<f64, std::milli>(end - start).count());
+
+	for (TestTimer *timer : burst)
+	{
+		delete timer;
+	}
+}
+
+int main()
+{
+	TestAgainstScan();
+	TestCancelFromExecute();
+	Benchmark();
+
+	if (failures)
+	{
+		printf("%i check(s) failed\n", failures);
+		return 1;
+	}
+	printf("All timer checks passed.\n");
+	return 0;
+}
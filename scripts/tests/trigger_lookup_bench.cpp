@@ -0,0 +1,182 @@
+// Registers 64, 512 and 2048 mapping API triggers in KZTriggerLookup from src/kz/mappingapi/kz_triggerlookup.h, checks
+// that every touch finds the same trigger as the linear scan over the trigger list it replaced, and times both.
+// Run through scripts/bench-trigger-lookup.sh.
+
+#include <chrono>
+#include <cstdio>
+#include <vector>
+
+#include "../../src/kz/mappingapi/kz_triggerlookup.h"
+
+static_global i32 failures;
+
+#define CHECK(condition, ...) \
+	do \
+	{ \
+		if (!(condition)) \
+		{ \
+			printf("FAILED %s:%i: %s: ", __FILE__, __LINE__, #condition); \
+			printf(__VA_ARGS__); \
+			printf("\n"); \
+			failures++; \
+		} \
+	} while (0)
+
+static_global u32 g_seed = 1;
+
+static_function u32 Random(u32 range)
+{
+	g_seed = g_seed * 1664525u + 1013904223u;
+	return (g_seed >> 8) % range;
+}
+
+// CEntityHandle compares the entity index and the serial number.
+struct Handle
+{
+	u32 index;
+	u32 serial;
+
+	bool operator==(const Handle &other) const
+	{
+		return this->index == other.index && this->serial == other.serial;
+	}
+};
+
+// About the size of KzTrigger, the scan strides over the whole struct.
+struct Trigger
+{
+	i32 type;
+	Handle entity;
+	i32 hammerId;
+	u8 data[140];
+};
+
+struct Map
+{
+	std::vector<Trigger> triggers;
+	KZTriggerLookup lookup;
+	// Touched trigger_multiples: mostly registered ones, some that aren't timer triggers and some stale handles.
+	std::vector<Handle> touches;
+};
+
+static_function void MakeMap(Map &map, u32 triggerCount)
+{
+	map.triggers.clear();
+	map.lookup.Clear();
+	map.touches.clear();
+	// Triggers spawn in between the other entities of the map, with a few past the lookup size so that slots collide.
+	u32 index = 64 + Random(200);
+	for (u32 i = 0; i < triggerCount; i++)
+	{
+		Trigger trigger {};
+		trigger.type = Random(14);
+		trigger.entity = {index, 1 + Random(3)};
+		if (i % 16 == 15)
+		{
+			trigger.entity.index = map.triggers[Random(i)].entity.index + MAPI_TRIGGER_LOOKUP_SIZE;
+		}
+		else
+		{
+			index += 1 + Random(4);
+		}
+		trigger.hammerId = 1000 + i;
+		map.triggers.push_back(trigger);
+		map.lookup.Insert(trigger.entity.index, (i32)i);
+	}
+	for (u32 i = 0; i < 4096; i++)
+	{
+		Handle touched = map.triggers[Random(triggerCount)].entity;
+		switch (Random(8))
+		{
+			case 0:
+				// Not a timer trigger.
+				touched.index = index + 1 + Random(1000);
+				break;
+			case 1:
+				// The entity index was reused since the trigger was registered.
+				touched.serial += 4;
+				break;
+		}
+		map.touches.push_back(touched);
+	}
+}
+
+// Mapi_FindKzTrigger() before the lookup table.
+static_function const Trigger *FindByScan(const Map &map, Handle handle)
+{
+	for (const Trigger &trigger : map.triggers)
+	{
+		if (handle == trigger.entity)
+		{
+			return &trigger;
+		}
+	}
+	return nullptr;
+}
+
+static_function const Trigger *FindByLookup(const Map &map, Handle handle)
+{
+	i32 index = map.lookup.Find(handle.index, [&](i32 i) { return handle == map.triggers[i].entity; });
+	return index != -1 ? &map.triggers[index] : nullptr;
+}
+
+static_function void TestMap(u32 triggerCount)
+{
+	static_persist Map map;
+	MakeMap(map, triggerCount);
+
+	u32 found = 0;
+	for (const Handle &touched : map.touches)
+	{
+		const Trigger *expected = FindByScan(map, touched);
+		const Trigger *trigger = FindByLookup(map, touched);
+		CHECK(trigger == expected, "%u triggers: touching %u:%u found trigger %i instead of %i", triggerCount, touched.index, touched.serial,
+			  trigger ? (i32)(trigger - map.triggers.data()) : -1, expected ? (i32)(expected - map.triggers.data()) : -1);
+		found += expected != nullptr;
+	}
+
+	// The sum of the found hammer IDs keeps the lookups from being optimized out.
+	const u32 rounds = triggerCount >= 512 ? 50 : 500;
+	i64 scanSum = 0, lookupSum = 0;
+	auto start = std::chrono::steady_clock::now();
+	for (u32 round = 0; round < rounds; round++)
+	{
+		for (const Handle &touched : map.touches)
+		{
+			const Trigger *trigger = FindByScan(map, touched);
+			scanSum += trigger ? trigger->hammerId : 0;
+		}
+	}
+	auto mid = std::chrono::steady_clock::now();
+	for (u32 round = 0; round < rounds; round++)
+	{
+		for (const Handle &touched : map.touches)
+		{
+			const Trigger *trigger = FindByLookup(map, touched);
+			lookupSum += trigger ? trigger->hammerId : 0;
+		}
+	}
+	auto end = std::chrono::steady_clock::now();
+	CHECK(scanSum == lookupSum, "%u triggers: timed lookups disagree", triggerCount);
+
+	f64 lookups = (f64)rounds * map.touches.size();
+	f64 scanNs = std::chrono::duration<f64, std::nano>(mid - start).count() / lookups;
+	f64 lookupNs = std::chrono::duration<f64, std::nano>(end - mid).count() / lookups;
+	printf("%4u triggers: %u of %zu touches are timer triggers, scan %7.1f ns/lookup, hash table %5.1f ns/lookup\n", triggerCount, found,
+		   map.touches.size(), scanNs, lookupNs);
+}
+
+int main()
+{
+	TestMap(64);
+	TestMap(512);
+	TestMap(MAPI_MAX_TRIGGERS);
+
+	if (failures)
+	{
+		printf("%i check(s) failed\n", failures);
+		return 1;
+	}
+	printf("All trigger lookup checks passed.\n");
+	return 0;
+}
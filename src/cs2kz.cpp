@@ -17,6 +17,7 @@
 #include "kz/goto/kz_goto.h"
 #include "kz/style/kz_style.h"
 #include "kz/quiet/kz_quiet.h"
+#include "kz/replays/kz_replays.h"
 #include "kz/tip/kz_tip.h"
 #include "kz/option/kz_option.h"
 #include "kz/language/kz_language.h"
@@ -57,6 +58,7 @@ bool KZPlugin::Load(PluginId id, ISmmAPI *ismm, char *error, size_t maxlen, bool
 	KZLanguageService::Init();
 	KZ::misc::Init();
 	KZQuietService::Init();
+	KZReplayService::Init();
 	KZ::misc::RegisterCommands();
 	if (!KZ::mode::InitModeCvars())
 	{
@@ -72,6 +74,7 @@ bool KZPlugin::Load(PluginId id, ISmmAPI *ismm, char *error, size_t maxlen, bool
 
 	KZOptionService::InitOptions();
 	KZTipService::InitTips();
+	KZHUDService::InitSettings();
 	if (late)
 	{
 		g_steamAPI.Init();
@@ -91,6 +94,7 @@ bool KZPlugin::Unload(char *error, size_t maxlen)
 	g_pKZModeManager->Cleanup();
 	g_pKZStyleManager->Cleanup();
 	g_pPlayerManager->Cleanup();
+	KZReplayService::Cleanup();
 	KZDatabaseService::Cleanup();
 	KZGlobalService::Cleanup();
 	return true;
@@ -1,17 +1,16 @@
 #include "kz_db.h"
+#include "statement.h"
 #include "vendor/sql_mm/src/public/sql_mm.h"
 #include "queries/courses.h"
 
+using namespace KZ::Database;
+
 void KZDatabaseService::FindFirstCourseByMapName(CUtlString mapName, TransactionSuccessCallbackFunc onSuccess,
 												 TransactionFailureCallbackFunc onFailure)
 {
-	auto cleanMapName = KZDatabaseService::GetDatabaseConnection()->Escape(mapName.Get());
-
-	char query[1024];
-	V_snprintf(query, sizeof(query), sql_mapcourses_findfirst_mapname, cleanMapName.c_str(), cleanMapName.c_str());
-
 	Transaction txn;
-	txn.queries.push_back(query);
+	std::string pattern = std::string("%") + mapName.Get() + "%";
+	txn.queries.push_back(Statement::Get(sql_mapcourses_findfirst_mapname).Bind(pattern, mapName));
 
-	KZDatabaseService::GetDatabaseConnection()->ExecuteTransaction(txn, onSuccess, onFailure);
+	KZDatabaseService::ExecuteTransaction(__func__, txn, onSuccess, onFailure);
 }
@@ -1,78 +1,57 @@
 #include "kz_db.h"
+#include "statement.h"
 #include "vendor/sql_mm/src/public/sql_mm.h"
 #include "queries/personal_best.h"
 
+using namespace KZ::Database;
+
 void KZDatabaseService::QueryPB(u64 steamID64, CUtlString mapName, CUtlString courseName, u32 modeID, TransactionSuccessCallbackFunc onSuccess,
 								TransactionFailureCallbackFunc onFailure)
 {
-	std::string cleanedMapName = KZDatabaseService::GetDatabaseConnection()->Escape(mapName.Get());
-	std::string cleanedCourseName = KZDatabaseService::GetDatabaseConnection()->Escape(courseName.Get());
-
 	Transaction txn;
 
-	char query[1024];
 	// Get PB
-	V_snprintf(query, sizeof(query), sql_getpb, steamID64, cleanedMapName.c_str(), cleanedCourseName.c_str(), modeID, 0ull, 1);
-	txn.queries.push_back(query);
+	txn.queries.push_back(Statement::Get(sql_getpb).Bind(steamID64, mapName, courseName, modeID, 0ull, 1));
 
 	// Get Rank
-	V_snprintf(query, sizeof(query), sql_getmaprank, cleanedMapName.c_str(), cleanedCourseName.c_str(), modeID, steamID64, cleanedMapName.c_str(),
-			   cleanedCourseName.c_str(), modeID);
-	txn.queries.push_back(query);
+	txn.queries.push_back(Statement::Get(sql_getmaprank).Bind(mapName, courseName, modeID, steamID64, mapName, courseName, modeID));
 
 	// Get Number of Players with Times
-	V_snprintf(query, sizeof(query), sql_getlowestmaprank, cleanedMapName.c_str(), cleanedCourseName.c_str(), modeID);
-	txn.queries.push_back(query);
+	txn.queries.push_back(Statement::Get(sql_getlowestmaprank).Bind(mapName, courseName, modeID));
 
 	// Get PRO PB
-	V_snprintf(query, sizeof(query), sql_getpbpro, steamID64, cleanedMapName.c_str(), cleanedCourseName.c_str(), modeID, 0ull, 1);
-	txn.queries.push_back(query);
+	txn.queries.push_back(Statement::Get(sql_getpbpro).Bind(steamID64, mapName, courseName, modeID, 0ull, 1));
 
 	// Get PRO Rank
-	V_snprintf(query, sizeof(query), sql_getmaprankpro, cleanedMapName.c_str(), cleanedCourseName.c_str(), modeID, steamID64, cleanedMapName.c_str(),
-			   cleanedCourseName.c_str(), modeID);
-	txn.queries.push_back(query);
+	txn.queries.push_back(Statement::Get(sql_getmaprankpro).Bind(mapName, courseName, modeID, steamID64, mapName, courseName, modeID));
 
 	// Get Number of Players with Times
-	V_snprintf(query, sizeof(query), sql_getlowestmaprankpro, cleanedMapName.c_str(), cleanedCourseName.c_str(), modeID);
-	txn.queries.push_back(query);
+	txn.queries.push_back(Statement::Get(sql_getlowestmaprankpro).Bind(mapName, courseName, modeID));
 
-	KZDatabaseService::GetDatabaseConnection()->ExecuteTransaction(txn, onSuccess, onFailure);
+	KZDatabaseService::ExecuteTransaction(__func__, txn, onSuccess, onFailure);
 }
 
 void KZDatabaseService::QueryPBRankless(u64 steamID64, CUtlString mapName, CUtlString courseName, u32 modeID, u64 styleIDFlags,
 										TransactionSuccessCallbackFunc onSuccess, TransactionFailureCallbackFunc onFailure)
 {
-	std::string cleanedMapName = KZDatabaseService::GetDatabaseConnection()->Escape(mapName.Get());
-
-	std::string cleanedCourseName = KZDatabaseService::GetDatabaseConnection()->Escape(courseName.Get());
-
-	char query[1024];
 	Transaction txn;
 	// Get PB
-	V_snprintf(query, sizeof(query), sql_getpb, steamID64, cleanedMapName.c_str(), cleanedCourseName.c_str(), modeID, styleIDFlags, 1);
-	txn.queries.push_back(query);
+	txn.queries.push_back(Statement::Get(sql_getpb).Bind(steamID64, mapName, courseName, modeID, styleIDFlags, 1));
 	// Get PRO PB
-	V_snprintf(query, sizeof(query), sql_getpbpro, steamID64, cleanedMapName.c_str(), cleanedCourseName.c_str(), modeID, styleIDFlags, 1);
-	txn.queries.push_back(query);
+	txn.queries.push_back(Statement::Get(sql_getpbpro).Bind(steamID64, mapName, courseName, modeID, styleIDFlags, 1));
 
-	KZDatabaseService::GetDatabaseConnection()->ExecuteTransaction(txn, onSuccess, onFailure);
+	KZDatabaseService::ExecuteTransaction(__func__, txn, onSuccess, onFailure);
 }
 
 void KZDatabaseService::QueryAllPBs(u64 steamID64, CUtlString mapName, TransactionSuccessCallbackFunc onSuccess,
 									TransactionFailureCallbackFunc onFailure)
 {
-	std::string cleanedMapName = KZDatabaseService::GetDatabaseConnection()->Escape(mapName.Get());
-
 	Transaction txn;
 
-	char query[1024];
 	// Get PB
-	V_snprintf(query, sizeof(query), sql_getpbs, steamID64, cleanedMapName.c_str());
-	txn.queries.push_back(query);
+	txn.queries.push_back(Statement::Get(sql_getpbs).Bind(steamID64, steamID64, mapName));
 	// Get PRO PB
-	V_snprintf(query, sizeof(query), sql_getpbspro, steamID64, cleanedMapName.c_str());
-	txn.queries.push_back(query);
+	txn.queries.push_back(Statement::Get(sql_getpbspro).Bind(steamID64, steamID64, mapName));
 
-	KZDatabaseService::GetDatabaseConnection()->ExecuteTransaction(txn, onSuccess, onFailure);
+	KZDatabaseService::ExecuteTransaction(__func__, txn, onSuccess, onFailure);
 }
@@ -1,8 +1,11 @@
 #include "kz_db.h"
+#include "statement.h"
 #include "vendor/sql_mm/src/public/sql_mm.h"
 
 #include "queries/players.h"
 
+using namespace KZ::Database;
+
 void KZDatabaseService::FindPlayerByAlias(CUtlString playerName, TransactionSuccessCallbackFunc onSuccess, TransactionFailureCallbackFunc onFailure)
 {
 	if (!KZDatabaseService::IsReady())
@@ -11,12 +14,10 @@ void KZDatabaseService::FindPlayerByAlias(CUtlString playerName, TransactionSucc
 	}
 
 	Transaction txn;
-	char query[1024];
 
 	// Get player's steamID through their alias.
-	std::string cleanedPlayerName = KZDatabaseService::GetDatabaseConnection()->Escape(playerName.Get());
-	V_snprintf(query, sizeof(query), sql_players_searchbyalias, cleanedPlayerName.c_str(), cleanedPlayerName.c_str());
-	txn.queries.push_back(query);
+	std::string pattern = std::string("%") + playerName.Get() + "%";
+	txn.queries.push_back(Statement::Get(sql_players_searchbyalias).Bind(pattern, playerName));
 
-	KZDatabaseService::GetDatabaseConnection()->ExecuteTransaction(txn, onSuccess, onFailure);
+	KZDatabaseService::ExecuteTransaction(__func__, txn, onSuccess, onFailure);
 }
@@ -1,41 +1,33 @@
 #include "kz_db.h"
+#include "statement.h"
 #include "vendor/sql_mm/src/public/sql_mm.h"
 #include "queries/course_top.h"
 
+using namespace KZ::Database;
+
 void KZDatabaseService::QueryAllRecords(CUtlString mapName, TransactionSuccessCallbackFunc onSuccess, TransactionFailureCallbackFunc onFailure)
 {
-	std::string cleanedMapName = KZDatabaseService::GetDatabaseConnection()->Escape(mapName.Get());
-
 	Transaction txn;
 
-	char query[1024];
 	// Get PB
-	V_snprintf(query, sizeof(query), sql_getsrs, cleanedMapName.c_str());
-	txn.queries.push_back(query);
+	txn.queries.push_back(Statement::Get(sql_getsrs).Bind(mapName));
 
 	// Get Rank
-	V_snprintf(query, sizeof(query), sql_getsrspro, cleanedMapName.c_str());
-	txn.queries.push_back(query);
+	txn.queries.push_back(Statement::Get(sql_getsrspro).Bind(mapName));
 
-	KZDatabaseService::GetDatabaseConnection()->ExecuteTransaction(txn, onSuccess, onFailure);
+	KZDatabaseService::ExecuteTransaction(__func__, txn, onSuccess, onFailure);
 }
 
 void KZDatabaseService::QueryRecords(CUtlString mapName, CUtlString courseName, u32 modeID, u32 count, u32 offset,
 									 TransactionSuccessCallbackFunc onSuccess, TransactionFailureCallbackFunc onFailure)
 {
-	std::string cleanedMapName = KZDatabaseService::GetDatabaseConnection()->Escape(mapName.Get());
-	std::string cleanedCourseName = KZDatabaseService::GetDatabaseConnection()->Escape(courseName.Get());
-
 	Transaction txn;
 
-	char query[1024];
 	// Get PB
-	V_snprintf(query, sizeof(query), sql_getcoursetop, cleanedMapName.c_str(), cleanedCourseName.c_str(), modeID, count, offset);
-	txn.queries.push_back(query);
+	txn.queries.push_back(Statement::Get(sql_getcoursetop).Bind(mapName, courseName, modeID, count, offset));
 
 	// Get Rank
-	V_snprintf(query, sizeof(query), sql_getcoursetoppro, cleanedMapName.c_str(), cleanedCourseName.c_str(), modeID, count, offset);
-	txn.queries.push_back(query);
+	txn.queries.push_back(Statement::Get(sql_getcoursetoppro).Bind(mapName, courseName, modeID, count, offset));
 
-	KZDatabaseService::GetDatabaseConnection()->ExecuteTransaction(txn, onSuccess, onFailure);
+	KZDatabaseService::ExecuteTransaction(__func__, txn, onSuccess, onFailure);
 }
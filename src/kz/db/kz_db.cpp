@@ -1,4 +1,5 @@
 #include "kz_db.h"
+#include "statement.h"
 #include "vendor/sql_mm/src/public/sql_mm.h"
 
 using namespace KZ::Database;
@@ -32,6 +33,8 @@ void KZDatabaseService::Cleanup()
 {
 	if (databaseConnection)
 	{
+		KZDatabaseService::FlushWrites(true);
+		Statement::ClearCache();
 		databaseConnection->Destroy();
 		databaseConnection = NULL;
 	}
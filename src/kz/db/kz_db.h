@@ -1,13 +1,22 @@
 #pragma once
+#include <unordered_map>
+
 #include "../kz.h"
 #include "kz/jumpstats/kz_jumpstats.h"
 #include "kz/timer/kz_timer.h"
 
 class ISQLConnection;
 class ISQLQuery;
+struct Transaction;
 typedef std::function<void(std::vector<ISQLQuery *>)> TransactionSuccessCallbackFunc;
 typedef std::function<void(std::string, int)> TransactionFailureCallbackFunc;
 
+// Jumpstats are stored as integers with this many steps per unit.
+#define KZ_JUMPSTATS_DISTANCE_PRECISION 10000
+#define KZ_JUMPSTATS_SYNC_PRECISION     100
+#define KZ_JUMPSTATS_SPEED_PRECISION    100
+#define KZ_JUMPSTATS_AIRTIME_PRECISION  10000
+
 namespace KZ
 {
 	namespace Database
@@ -93,6 +102,16 @@ public:
 
 	static void OnGenericQuerySuccess(ISQLQuery *query) {}
 
+	// All transactions go through here so their latency is recorded under the label.
+	static void ExecuteTransaction(const char *label, const Transaction &txn, TransactionSuccessCallbackFunc onSuccess,
+								   TransactionFailureCallbackFunc onFailure);
+	// Writes that nobody waits on right away are held back for a moment and sent together in one transaction.
+	// A non-zero key replaces the queued write with the same label and key, only the latest one matters.
+	static void QueueWrite(const char *label, std::vector<std::string> queries, TransactionSuccessCallbackFunc onSuccess = OnGenericTxnSuccess,
+						   TransactionFailureCallbackFunc onFailure = OnGenericTxnFailure, u64 key = 0);
+	static void FlushWrites(bool force = false);
+	static void RegisterCommands();
+
 	static void SetupDatabase();
 	static void OnDatabaseConnected(bool connect);
 
@@ -129,6 +148,20 @@ public:
 		return isSetUp;
 	}
 
+	// Jumpstats
+	void SaveJumpstat(Jump *jump);
+
+private:
+	// Best distance for each mode and jump type, loaded with the client so that jumps that aren't PBs never reach the database.
+	std::unordered_map<u32, i32> jumpstatPBs;
+	bool jumpstatPBsLoaded {};
+
+	static u32 GetJumpstatPBKey(i32 modeID, JumpType jumpType)
+	{
+		return ((u32)modeID << 8) | (u32)jumpType;
+	}
+
+public:
 	static void FindPlayerByAlias(CUtlString playerName, TransactionSuccessCallbackFunc onSuccess, TransactionFailureCallbackFunc onFailure);
 
 	// Mode
@@ -1,4 +1,5 @@
 #include "kz_db.h"
+#include "statement.h"
 #include "kz/option/kz_option.h"
 
 #include <regex>
@@ -41,6 +42,14 @@ static_global const std::string mysqlMigrations[] =
 	trimString(mysql_times_create),
 	trimString(mysql_jumpstats_create),
 	trimString(mysql_startpos_create),
+	trimString(mysql_times_create_index_leaderboard),
+	trimString(mysql_times_create_index_player),
+	trimString(mysql_jumpstats_create_index_player),
+	trimString(mysql_personalbests_create),
+	trimString(sql_personalbests_backfill),
+	trimString(sql_personalbests_create_index_leaderboard),
+	trimString(sql_personalbests_create_index_leaderboard_pro),
+	trimString(mysql_jumpstats_create_index_ranking),
 };
 
 static_global const std::string sqliteMigrations[] = 
@@ -53,6 +62,14 @@ static_global const std::string sqliteMigrations[] =
 	trimString(sqlite_times_create),
 	trimString(sqlite_jumpstats_create),
 	trimString(sqlite_startpos_create),
+	trimString(sqlite_times_create_index_leaderboard),
+	trimString(sqlite_times_create_index_player),
+	trimString(sqlite_jumpstats_create_index_player),
+	trimString(sqlite_personalbests_create),
+	trimString(sql_personalbests_backfill),
+	trimString(sql_personalbests_create_index_leaderboard),
+	trimString(sql_personalbests_create_index_leaderboard_pro),
+	trimString(sqlite_jumpstats_create_index_ranking),
 };
 
 // clang-format on
@@ -75,7 +92,7 @@ void KZDatabaseService::RunMigrations()
 	}
 	txn.queries.push_back(sql_migrations_fetchall);
 
-	GetDatabaseConnection()->ExecuteTransaction(txn, KZDatabaseService::CheckMigrations, OnGenericTxnFailure);
+	KZDatabaseService::ExecuteTransaction(__func__, txn, KZDatabaseService::CheckMigrations, OnGenericTxnFailure);
 }
 
 void KZDatabaseService::CheckMigrations(std::vector<ISQLQuery *> queries)
@@ -159,7 +176,6 @@ void KZDatabaseService::CheckMigrations(std::vector<ISQLQuery *> queries)
 	}
 
 	Transaction txn;
-	char query[1024];
 	for (u32 i = current; i < max; i++)
 	{
 		switch (KZDatabaseService::GetDatabaseType())
@@ -167,23 +183,22 @@ void KZDatabaseService::CheckMigrations(std::vector<ISQLQuery *> queries)
 			case DatabaseType::MySQL:
 			{
 				txn.queries.push_back(mysqlMigrations[i]);
-				V_snprintf(query, sizeof(query), sql_migrations_insert,
-						   CRC32_ProcessSingleBuffer(mysqlMigrations[i].c_str(), mysqlMigrations[i].length()));
+				txn.queries.push_back(Statement::Get(sql_migrations_insert)
+										  .Bind((u32)CRC32_ProcessSingleBuffer(mysqlMigrations[i].c_str(), mysqlMigrations[i].length())));
 				break;
 			}
 			case DatabaseType::SQLite:
 			{
 				txn.queries.push_back(sqliteMigrations[i]);
-				V_snprintf(query, sizeof(query), sql_migrations_insert,
-						   CRC32_ProcessSingleBuffer(sqliteMigrations[i].c_str(), sqliteMigrations[i].length()));
+				txn.queries.push_back(Statement::Get(sql_migrations_insert)
+										  .Bind((u32)CRC32_ProcessSingleBuffer(sqliteMigrations[i].c_str(), sqliteMigrations[i].length())));
 				break;
 			}
 		}
-		txn.queries.push_back(query);
 	}
 
-	GetDatabaseConnection()->ExecuteTransaction(
-		txn, [onSuccess](std::vector<ISQLQuery *> queries) { onSuccess(); }, [onFailure](std::string error, int failIndex) { onFailure(); });
+	KZDatabaseService::ExecuteTransaction(
+		__func__, txn, [onSuccess](std::vector<ISQLQuery *> queries) { onSuccess(); }, [onFailure](std::string error, int failIndex) { onFailure(); });
 }
 
 bool KZDatabaseService::IsReady()
@@ -1,59 +1,54 @@
 constexpr char sql_getcoursetop[] = R"(
-    SELECT t.ID, t.SteamID64, p.Alias, t.RunTime AS PBTime, t.Teleports 
-        FROM Times t 
-        INNER JOIN MapCourses mc ON mc.ID = t.MapCourseID 
+    SELECT pb.TimeID, pb.SteamID64, p.Alias, pb.RunTime AS PBTime, pb.Teleports 
+        FROM PersonalBests pb 
+        INNER JOIN MapCourses mc ON mc.ID = pb.MapCourseID 
         INNER JOIN Maps ON Maps.ID = mc.MapID
-        INNER JOIN Players p ON p.SteamID64=t.SteamID64 
-        LEFT OUTER JOIN Times t2 ON t2.SteamID64=t.SteamID64 
-        AND t2.MapCourseID=t.MapCourseID AND t2.ModeID=t.ModeID
-        AND t2.StyleIDFlags=t.StyleIDFlags AND t2.RunTime<t.RunTime 
-        WHERE t2.ID IS NULL AND p.Cheater=0 AND Maps.Name='%s' AND mc.Name='%s' AND t.ModeID=%d AND t.StyleIDFlags=0
+        INNER JOIN Players p ON p.SteamID64=pb.SteamID64 
+        WHERE p.Cheater=0 AND Maps.Name=? AND mc.Name=? AND pb.ModeID=? AND pb.StyleIDFlags=0
         ORDER BY PBTime ASC
-        LIMIT %d
-        OFFSET %d
+        LIMIT ?
+        OFFSET ?
 )";
 
 constexpr char sql_getcoursetoppro[] = R"(
-    SELECT t.ID, t.SteamID64, p.Alias, t.RunTime AS PBTime, t.Teleports 
-        FROM Times t 
-        INNER JOIN MapCourses mc ON mc.ID=t.MapCourseID 
+    SELECT pb.ProTimeID, pb.SteamID64, p.Alias, pb.ProRunTime AS PBTime, 0 AS Teleports 
+        FROM PersonalBests pb 
+        INNER JOIN MapCourses mc ON mc.ID=pb.MapCourseID 
         INNER JOIN Maps ON Maps.ID = mc.MapID
-        INNER JOIN Players p ON p.SteamID64=t.SteamID64 
-        LEFT OUTER JOIN Times t2 ON t2.SteamID64=t.SteamID64 AND t2.MapCourseID=t.MapCourseID 
-        AND t2.ModeID=t.ModeID AND t2.StyleIDFlags=t.StyleIDFlags 
-        AND t2.RunTime<t.RunTime AND t.Teleports=0 AND t2.Teleports=0 
-        WHERE t2.ID IS NULL AND p.Cheater=0 AND Maps.Name='%s'
-        AND mc.Name='%s' AND t.ModeID=%d AND t.Teleports=0 AND t.StyleIDFlags=0 
+        INNER JOIN Players p ON p.SteamID64=pb.SteamID64 
+        WHERE p.Cheater=0 AND Maps.Name=? AND mc.Name=? 
+        AND pb.ModeID=? AND pb.StyleIDFlags=0 AND pb.ProRunTime IS NOT NULL 
         ORDER BY PBTime ASC
-        LIMIT %d
-        OFFSET %d
+        LIMIT ?
+        OFFSET ?
 )";
 
 // Caching PBs
 
 constexpr char sql_getsrs[] = R"(
     SELECT x.RunTime, x.MapCourseID, x.ModeID, t.Metadata
-        FROM Times t
-        INNER JOIN MapCourses mc ON mc.ID = t.MapCourseID
-        INNER JOIN Maps m ON m.ID = mc.MapID
+        FROM PersonalBests pb
+        INNER JOIN Times t ON t.ID = pb.TimeID
         INNER JOIN (
-            SELECT MIN(t.RunTime) AS RunTime, t.MapCourseID, t.ModeID
-                FROM Times t
-                GROUP BY t.MapCourseID, t.ModeID
-        ) x ON x.RunTime = t.RunTime AND x.MapCourseID = t.MapCourseID AND x.ModeID = t.ModeID
-        WHERE m.Name = '%s'
+            SELECT MIN(pb.RunTime) AS RunTime, pb.MapCourseID, pb.ModeID
+                FROM PersonalBests pb
+                INNER JOIN MapCourses mc ON mc.ID = pb.MapCourseID
+                INNER JOIN Maps m ON m.ID = mc.MapID
+                WHERE m.Name = ?
+                GROUP BY pb.MapCourseID, pb.ModeID
+        ) x ON x.RunTime = pb.RunTime AND x.MapCourseID = pb.MapCourseID AND x.ModeID = pb.ModeID
 )";
 
 constexpr char sql_getsrspro[] = R"(
     SELECT x.RunTime, x.MapCourseID, x.ModeID, t.Metadata
-        FROM Times t
-        INNER JOIN MapCourses mc ON mc.ID = t.MapCourseID
-        INNER JOIN Maps m ON m.ID = mc.MapID
+        FROM PersonalBests pb
+        INNER JOIN Times t ON t.ID = pb.ProTimeID
         INNER JOIN (
-            SELECT MIN(t.RunTime) AS RunTime, t.MapCourseID, t.ModeID
-                FROM Times t
-                WHERE t.Teleports=0 
-                GROUP BY t.MapCourseID, t.ModeID
-        ) x ON x.RunTime = t.RunTime AND x.MapCourseID = t.MapCourseID AND x.ModeID = t.ModeID
-        WHERE m.Name = '%s' 
+            SELECT MIN(pb.ProRunTime) AS RunTime, pb.MapCourseID, pb.ModeID
+                FROM PersonalBests pb
+                INNER JOIN MapCourses mc ON mc.ID = pb.MapCourseID
+                INNER JOIN Maps m ON m.ID = mc.MapID
+                WHERE m.Name = ? AND pb.ProRunTime IS NOT NULL
+                GROUP BY pb.MapCourseID, pb.ModeID
+        ) x ON x.RunTime = pb.ProRunTime AND x.MapCourseID = pb.MapCourseID AND x.ModeID = pb.ModeID
 )";
@@ -31,14 +31,14 @@ constexpr char mysql_mapcourses_create[] = R"(
 
 constexpr char sqlite_mapcourses_insert[] = R"(
     INSERT INTO MapCourses (MapID, Name, StageID)
-        VALUES (%d, '%s', %d)
+        VALUES (?, ?, ?)
         ON CONFLICT(MapID, StageID) DO UPDATE SET
             Name = excluded.Name
 )";
 
 constexpr char mysql_mapcourses_insert[] = R"(
     INSERT INTO MapCourses (MapID, Name, StageID) 
-        VALUES (%d, '%s', %d)
+        VALUES (?, ?, ?)
         ON DUPLICATE KEY UPDATE 
             Name = VALUES(Name)
 )";
@@ -47,27 +47,27 @@ constexpr char sql_mapcourses_findfirst_mapname[] = R"(
     SELECT MapCourses.Name
         FROM MapCourses
         INNER JOIN Maps ON Maps.ID = MapCourses.MapID
-        WHERE Maps.Name LIKE '%%%s%%'
-        ORDER BY (Maps.Name='%s') DESC, StageID ASC
+        WHERE Maps.Name LIKE ?
+        ORDER BY (Maps.Name=?) DESC, StageID ASC
         LIMIT 1
 )";
 
 constexpr char sql_mapcourses_findname[] = R"(
     SELECT ID 
         FROM MapCourses 
-        WHERE MapID=%d AND Name='%s';
+        WHERE MapID=? AND Name=?;
 )";
 
 constexpr char sql_mapcourses_findstageid[] = R"(
     SELECT ID 
         FROM MapCourses 
-        WHERE MapID=%d AND StageID=%d;
+        WHERE MapID=? AND StageID=?;
 )";
 
 constexpr char sql_mapcourses_findfirst[] = R"(
     SELECT ID
         FROM MapCourses
-        WHERE MapID=%d
+        WHERE MapID=?
         ORDER BY StageID
         LIMIT 1
 )";
@@ -75,5 +75,5 @@ constexpr char sql_mapcourses_findfirst[] = R"(
 constexpr char sql_mapcourses_findall[] = R"(
     SELECT Name, ID 
         FROM MapCourses 
-        WHERE MapID=%d;
+        WHERE MapID=?;
 )";
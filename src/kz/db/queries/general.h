@@ -6,7 +6,7 @@ constexpr char sql_getwrs[] = R"(
         INNER JOIN MapCourses ON MapCourses.ID=Times.MapCourseID 
         INNER JOIN Maps ON Maps.ID = MapCourses.MapID
         INNER JOIN Players ON Players.SteamID64=Times.SteamID64 
-        WHERE Players.Cheater=0 AND Maps.Name='%s'
+        WHERE Players.Cheater=0 AND Maps.Name=?
         GROUP BY MapCourses.Name, Times.ModeID
 )";
 
@@ -16,7 +16,7 @@ constexpr char sql_getwrspro[] = R"(
         INNER JOIN MapCourses ON MapCourses.ID=Times.MapCourseID 
         INNER JOIN Maps ON Maps.ID = MapCourses.MapID
         INNER JOIN Players ON Players.SteamID64=Times.SteamID64 
-        WHERE Players.Cheater=0 AND Maps.Name='%s' AND Times.Teleports=0 
+        WHERE Players.Cheater=0 AND Maps.Name=? AND Times.Teleports=0 
         GROUP BY MapCourses.Name, Times.ModeID
 )";
 
@@ -31,7 +31,7 @@ constexpr char sql_getcount_coursescompleted[] = R"(
         FROM Times 
         INNER JOIN MapCourses ON MapCourses.ID=Times.MapCourseID 
         INNER JOIN Maps ON Maps.MapID=MapCourses.MapID 
-        AND Times.SteamID64=%llu AND Times.ModeID=%d AND Times.StyleIDFlags=0
+        AND Times.SteamID64=? AND Times.ModeID=? AND Times.StyleIDFlags=0
 )";
 
 constexpr char sql_getcount_coursescompletedpro[] = R"(
@@ -39,7 +39,7 @@ constexpr char sql_getcount_coursescompletedpro[] = R"(
         FROM Times 
         INNER JOIN MapCourses ON MapCourses.ID=Times.MapCourseID 
         INNER JOIN Maps ON Maps.MapID=MapCourses.MapID 
-        AND Times.SteamID64=%llu AND Times.ModeID=%d 
+        AND Times.SteamID64=? AND Times.ModeID=? 
         AND Times.StyleIDFlags=0 AND Times.Teleports=0
 )";
 
@@ -53,13 +53,13 @@ constexpr char sql_gettopplayers[] = R"(
         INNER JOIN Maps ON Maps.MapID=MapCourses.MapID 
         INNER JOIN Players ON Players.SteamID64=Times.SteamID64 
         WHERE Players.Cheater=0 
-        AND Times.ModeID=%d AND Times.StyleIDFlags=0 
+        AND Times.ModeID=? AND Times.StyleIDFlags=0 
         GROUP BY Times.MapCourseID) Records 
         ON Times.MapCourseID=Records.MapCourseID AND Times.ModeID=Records.ModeID AND Times.RunTime=Records.RecordTime 
         INNER JOIN Players ON Players.SteamID64=Times.SteamID64 
         GROUP BY Players.SteamID64, Players.Alias 
         ORDER BY RecordCount DESC 
-        LIMIT %d
+        LIMIT ?
 )";
 
 constexpr char sql_gettopplayerspro[] = R"(
@@ -72,13 +72,13 @@ constexpr char sql_gettopplayerspro[] = R"(
             INNER JOIN Maps ON Maps.MapID=MapCourses.MapID 
             INNER JOIN Players ON Players.SteamID64=Times.SteamID64 
             WHERE Players.Cheater=0 AND 
-            AND Times.ModeID=%d AND Times.Teleports=0 
+            AND Times.ModeID=? AND Times.Teleports=0 
             GROUP BY Times.MapCourseID) Records 
         ON Times.MapCourseID=Records.MapCourseID AND Times.ModeID=Records.ModeID AND Times.RunTime=Records.RecordTime AND Times.Teleports=0 
         INNER JOIN Players ON Players.SteamID64=Times.SteamID64 
         GROUP BY Players.SteamID64, Players.Alias 
         ORDER BY RecordCount DESC 
-        LIMIT %d
+        LIMIT ?
 )";
 
 constexpr char sql_getaverage[] = R"(
@@ -88,8 +88,8 @@ constexpr char sql_getaverage[] = R"(
             FROM Times 
             INNER JOIN MapCourses ON Times.MapCourseID=MapCourses.ID 
             INNER JOIN Players ON Times.SteamID64=Players.SteamID64 
-            WHERE Players.Cheater=0 AND MapCourses.MapID=%d 
-            AND MapCourses.Name='%s' AND Times.ModeID=%d 
+            WHERE Players.Cheater=0 AND MapCourses.MapID=? 
+            AND MapCourses.Name=? AND Times.ModeID=? 
             GROUP BY Times.SteamID64) AS PBTimes
 )";
 
@@ -100,7 +100,7 @@ constexpr char sql_getaverage_pro[] = R"(
             FROM Times 
             INNER JOIN MapCourses ON Times.MapCourseID=MapCourses.ID 
             INNER JOIN Players ON Times.SteamID64=Players.SteamID64 
-            WHERE Players.Cheater=0 AND MapCourses.MapID=%d 
-            AND MapCourses.Name='%s' AND Times.ModeID=%d AND Times.Teleports=0 
+            WHERE Players.Cheater=0 AND MapCourses.MapID=? 
+            AND MapCourses.Name=? AND Times.ModeID=? AND Times.Teleports=0 
             GROUP BY Times.SteamID64) AS PBTimes
 )";
@@ -40,9 +40,43 @@ constexpr char mysql_jumpstats_create[] = R"(
         ON UPDATE CASCADE ON DELETE CASCADE)
 )";
 
+// Personal best lookups always filter on (SteamID64, JumpType, Mode, IsBlockJump) and order by Block, Distance.
+constexpr char sqlite_jumpstats_create_index_player[] = R"(
+    CREATE INDEX IF NOT EXISTS IX_Jumpstats_Player 
+        ON Jumpstats (SteamID64, JumpType, Mode, IsBlockJump, Block, Distance)
+)";
+
+constexpr char mysql_jumpstats_create_index_player[] = R"(
+    CREATE INDEX IX_Jumpstats_Player 
+        ON Jumpstats (SteamID64, JumpType, Mode, IsBlockJump, Block, Distance)
+)";
+
+// Leaderboards rank every player's best jump of a single JumpType/Mode.
+constexpr char sqlite_jumpstats_create_index_ranking[] = R"(
+    CREATE INDEX IF NOT EXISTS IX_Jumpstats_Ranking 
+        ON Jumpstats (JumpType, Mode, IsBlockJump, SteamID64, Block, Distance)
+)";
+
+constexpr char mysql_jumpstats_create_index_ranking[] = R"(
+    CREATE INDEX IX_Jumpstats_Ranking 
+        ON Jumpstats (JumpType, Mode, IsBlockJump, SteamID64, Block, Distance)
+)";
+
 constexpr char sql_jumpstats_insert[] = R"(
     INSERT INTO Jumpstats (SteamID64, JumpType, Mode, Distance, IsBlockJump, Block, Strafes, Sync, Pre, Max, Airtime) 
-        VALUES (%d, %d, %d, %d, %d, %d, %d, %d, %d, %d, %d)
+        VALUES (?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?)
+)";
+
+// Only the best jump is kept, the previous one is removed right before the new PB is inserted.
+constexpr char sql_jumpstats_deletepbs[] = R"(
+    DELETE 
+        FROM 
+            Jumpstats 
+        WHERE 
+            SteamID64=? AND 
+            JumpType=? AND 
+            Mode=? AND 
+            IsBlockJump=?
 )";
 
 constexpr char sql_jumpstats_update[] = R"(
@@ -117,7 +151,8 @@ constexpr char sql_jumpstats_getpbs[] = R"(
         FROM 
             Jumpstats 
         WHERE 
-            SteamID64=%llu 
+            SteamID64=? AND 
+            IsBlockJump=0 
         GROUP BY 
             Mode, JumpType
 )";
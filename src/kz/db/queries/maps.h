@@ -21,18 +21,18 @@ constexpr char mysql_maps_create[] = R"(
 
 constexpr char sqlite_maps_insert[] = R"(
     INSERT OR IGNORE INTO Maps (Name, LastPlayed) 
-        VALUES ('%s', CURRENT_TIMESTAMP)
+        VALUES (?, CURRENT_TIMESTAMP)
 )";
 
 constexpr char sqlite_maps_update[] = R"(
     UPDATE OR IGNORE Maps 
         SET LastPlayed=CURRENT_TIMESTAMP 
-        WHERE Name='%s'
+        WHERE Name=?
 )";
 
 constexpr char mysql_maps_upsert[] = R"(
     INSERT INTO Maps (Name, LastPlayed) 
-        VALUES ('%s', CURRENT_TIMESTAMP) 
+        VALUES (?, CURRENT_TIMESTAMP) 
         ON DUPLICATE KEY UPDATE 
         LastPlayed=CURRENT_TIMESTAMP
 )";
@@ -40,21 +40,21 @@ constexpr char mysql_maps_upsert[] = R"(
 constexpr char sql_maps_findid[] = R"(
     SELECT ID, Name 
         FROM Maps 
-        WHERE Name LIKE '%%%s%%' 
-        ORDER BY (Name='%s') DESC, LENGTH(Name) 
+        WHERE Name LIKE ? 
+        ORDER BY (Name=?) DESC, LENGTH(Name) 
         LIMIT 1
 )";
 
 constexpr char sql_maps_getname[] = R"(
     SELECT Name 
         FROM Maps 
-        WHERE ID=%d
+        WHERE ID=?
 )";
 
 constexpr char sql_maps_searchbyname[] = R"(
     SELECT ID, Name 
         FROM Maps 
-        WHERE Name LIKE '%%%s%%' 
-        ORDER BY (Name='%s') DESC, LENGTH(Name) 
+        WHERE Name LIKE ? 
+        ORDER BY (Name=?) DESC, LENGTH(Name) 
         LIMIT 1
 )";
@@ -17,15 +17,15 @@ constexpr char sqlite_modes_create[] = R"(
 )";
 
 constexpr char sqlite_modes_insert[] = R"(
-    INSERT OR IGNORE INTO Modes (Name, ShortName) VALUES ('%s', '%s');
+    INSERT OR IGNORE INTO Modes (Name, ShortName) VALUES (?, ?);
 )";
 
 constexpr char mysql_modes_insert[] = R"(
-    INSERT IGNORE INTO Modes (Name, ShortName) VALUES ('%s', '%s');
+    INSERT IGNORE INTO Modes (Name, ShortName) VALUES (?, ?);
 )";
 
 constexpr char sql_modes_findid[] = R"(
-    SELECT ID FROM Modes WHERE Name = '%s'
+    SELECT ID FROM Modes WHERE Name = ?
 )";
 
 constexpr char sql_modes_fetch_all[] = R"(
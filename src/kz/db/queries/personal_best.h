@@ -4,11 +4,11 @@ constexpr char sql_getpb[] = R"(
         FROM Times
         INNER JOIN MapCourses ON Times.MapCourseID = MapCourses.ID
         INNER JOIN Maps ON MapCourses.MapID = Maps.ID
-        WHERE Times.SteamID64=%llu 
-        AND Maps.Name='%s' AND MapCourses.Name='%s' 
-        AND Times.ModeID=%d AND Times.StyleIDFlags=%llu
+        WHERE Times.SteamID64=? 
+        AND Maps.Name=? AND MapCourses.Name=? 
+        AND Times.ModeID=? AND Times.StyleIDFlags=?
         ORDER BY Times.RunTime 
-        LIMIT %d
+        LIMIT ?
 )";
 
 constexpr char sql_getpbpro[] = R"(
@@ -16,102 +16,100 @@ constexpr char sql_getpbpro[] = R"(
         FROM Times
         INNER JOIN MapCourses ON MapCourses.ID = Times.MapCourseID
         INNER JOIN Maps ON Maps.ID = MapCourses.MapID
-        WHERE Times.SteamID64=%llu
-        AND Maps.Name='%s' AND MapCourses.Name='%s' 
-        AND Times.ModeID=%d AND Times.StyleIDFlags=%llu
+        WHERE Times.SteamID64=?
+        AND Maps.Name=? AND MapCourses.Name=? 
+        AND Times.ModeID=? AND Times.StyleIDFlags=?
         AND Times.Teleports=0 
         ORDER BY Times.RunTime 
-        LIMIT %d
+        LIMIT ?
 )";
 
 // The following queries should have no style!
 
 constexpr char sql_getmaprank[] = R"(
-    SELECT COUNT(DISTINCT Times.SteamID64) 
-        FROM Times 
-        INNER JOIN MapCourses ON MapCourses.ID=Times.MapCourseID 
+    SELECT COUNT(*) 
+        FROM PersonalBests 
+        INNER JOIN MapCourses ON MapCourses.ID=PersonalBests.MapCourseID 
         INNER JOIN Maps ON Maps.ID = MapCourses.MapID
-        INNER JOIN Players ON Players.SteamID64=Times.SteamID64 
-        WHERE Players.Cheater=0 AND Maps.Name='%s' AND MapCourses.Name='%s' 
-        AND Times.ModeID=%d AND Times.StyleIDFlags=0 AND Times.RunTime < 
-            (SELECT MIN(Times.RunTime) 
-            FROM Times 
-            INNER JOIN MapCourses ON MapCourses.ID=Times.MapCourseID 
+        INNER JOIN Players ON Players.SteamID64=PersonalBests.SteamID64 
+        WHERE Players.Cheater=0 AND Maps.Name=? AND MapCourses.Name=? 
+        AND PersonalBests.ModeID=? AND PersonalBests.StyleIDFlags=0 AND PersonalBests.RunTime <= 
+            (SELECT PersonalBests.RunTime 
+            FROM PersonalBests 
+            INNER JOIN MapCourses ON MapCourses.ID=PersonalBests.MapCourseID 
             INNER JOIN Maps ON Maps.ID = MapCourses.MapID
-            INNER JOIN Players ON Players.SteamID64=Times.SteamID64 
-            WHERE Players.Cheater=0 AND Times.SteamID64=%llu AND Maps.Name='%s'
-            AND MapCourses.Name='%s' AND Times.ModeID=%d AND Times.StyleIDFlags=0) 
-    + 1
+            WHERE PersonalBests.SteamID64=? AND Maps.Name=?
+            AND MapCourses.Name=? AND PersonalBests.ModeID=? AND PersonalBests.StyleIDFlags=0)
 )";
 
 constexpr char sql_getmaprankpro[] = R"(
-    SELECT COUNT(DISTINCT Times.SteamID64) 
-        FROM Times 
-        INNER JOIN MapCourses ON MapCourses.ID=Times.MapCourseID 
+    SELECT COUNT(*) 
+        FROM PersonalBests 
+        INNER JOIN MapCourses ON MapCourses.ID=PersonalBests.MapCourseID 
         INNER JOIN Maps ON Maps.ID = MapCourses.MapID
-        INNER JOIN Players ON Players.SteamID64=Times.SteamID64 
-        WHERE Players.Cheater=0 AND Maps.Name='%s' AND MapCourses.Name='%s' 
-        AND Times.ModeID=%d AND Times.StyleIDFlags=0 AND Times.Teleports=0 
-        AND Times.RunTime < 
-            (SELECT MIN(Times.RunTime) 
-            FROM Times 
-            INNER JOIN MapCourses ON MapCourses.ID=Times.MapCourseID 
+        INNER JOIN Players ON Players.SteamID64=PersonalBests.SteamID64 
+        WHERE Players.Cheater=0 AND Maps.Name=? AND MapCourses.Name=? 
+        AND PersonalBests.ModeID=? AND PersonalBests.StyleIDFlags=0 
+        AND PersonalBests.ProRunTime <= 
+            (SELECT PersonalBests.ProRunTime 
+            FROM PersonalBests 
+            INNER JOIN MapCourses ON MapCourses.ID=PersonalBests.MapCourseID 
             INNER JOIN Maps ON Maps.ID = MapCourses.MapID
-            INNER JOIN Players ON Players.SteamID64=Times.SteamID64 
-            WHERE Players.Cheater=0 AND Times.SteamID64=%llu AND Maps.Name='%s' 
-            AND MapCourses.Name='%s' AND Times.ModeID=%d 
-            AND Times.StyleIDFlags=0 AND Times.Teleports=0) 
-    + 1
+            WHERE PersonalBests.SteamID64=? AND Maps.Name=? 
+            AND MapCourses.Name=? AND PersonalBests.ModeID=? 
+            AND PersonalBests.StyleIDFlags=0)
 )";
 
 constexpr char sql_getlowestmaprank[] = R"(
-    SELECT COUNT(DISTINCT Times.SteamID64) 
-        FROM Times 
-        INNER JOIN MapCourses ON MapCourses.ID=Times.MapCourseID 
+    SELECT COUNT(*) 
+        FROM PersonalBests 
+        INNER JOIN MapCourses ON MapCourses.ID=PersonalBests.MapCourseID 
         INNER JOIN Maps ON Maps.ID = MapCourses.MapID
-        INNER JOIN Players ON Players.SteamID64=Times.SteamID64 
-        WHERE Players.Cheater=0 AND Maps.Name='%s' 
-        AND MapCourses.Name='%s' AND Times.ModeID=%d 
-        AND Times.StyleIDFlags=0 AND Times.StyleIDFlags=0
+        INNER JOIN Players ON Players.SteamID64=PersonalBests.SteamID64 
+        WHERE Players.Cheater=0 AND Maps.Name=? 
+        AND MapCourses.Name=? AND PersonalBests.ModeID=? 
+        AND PersonalBests.StyleIDFlags=0
 )";
 
 constexpr char sql_getlowestmaprankpro[] = R"(
-    SELECT COUNT(DISTINCT Times.SteamID64) 
-        FROM Times 
-        INNER JOIN MapCourses ON MapCourses.ID=Times.MapCourseID 
+    SELECT COUNT(*) 
+        FROM PersonalBests 
+        INNER JOIN MapCourses ON MapCourses.ID=PersonalBests.MapCourseID 
         INNER JOIN Maps ON Maps.ID = MapCourses.MapID
-        INNER JOIN Players ON Players.SteamID64=Times.SteamID64 
-        WHERE Players.Cheater=0 AND Maps.Name='%s'
-        AND MapCourses.Name='%s' AND Times.ModeID=%d 
-        AND Times.StyleIDFlags=0 AND Times.Teleports=0
+        INNER JOIN Players ON Players.SteamID64=PersonalBests.SteamID64 
+        WHERE Players.Cheater=0 AND Maps.Name=?
+        AND MapCourses.Name=? AND PersonalBests.ModeID=? 
+        AND PersonalBests.StyleIDFlags=0 AND PersonalBests.ProRunTime IS NOT NULL
 )";
 
 // Caching PBs
 
 constexpr char sql_getpbs[] = R"(
     SELECT x.RunTime, x.MapCourseID, x.ModeID, t.Metadata
-        FROM Times t
-        INNER JOIN MapCourses mc ON mc.ID = t.MapCourseID
+        FROM PersonalBests pb
+        INNER JOIN Times t ON t.ID = pb.TimeID
+        INNER JOIN MapCourses mc ON mc.ID = pb.MapCourseID
         INNER JOIN Maps m ON m.ID = mc.MapID
         INNER JOIN (
-            SELECT MIN(t.RunTime) AS RunTime, t.MapCourseID, t.ModeID
-                FROM Times t
-                WHERE t.SteamID64=%llu
-                GROUP BY t.MapCourseID, t.ModeID
-        ) x ON x.RunTime = t.RunTime AND x.MapCourseID = t.MapCourseID AND x.ModeID = t.ModeID
-        WHERE m.Name = '%s'
+            SELECT MIN(RunTime) AS RunTime, MapCourseID, ModeID
+                FROM PersonalBests
+                WHERE SteamID64=?
+                GROUP BY MapCourseID, ModeID
+        ) x ON x.RunTime = pb.RunTime AND x.MapCourseID = pb.MapCourseID AND x.ModeID = pb.ModeID
+        WHERE pb.SteamID64=? AND m.Name = ?
 )";
 
 constexpr char sql_getpbspro[] = R"(
     SELECT x.RunTime, x.MapCourseID, x.ModeID, t.Metadata
-        FROM Times t
-        INNER JOIN MapCourses mc ON mc.ID = t.MapCourseID
+        FROM PersonalBests pb
+        INNER JOIN Times t ON t.ID = pb.ProTimeID
+        INNER JOIN MapCourses mc ON mc.ID = pb.MapCourseID
         INNER JOIN Maps m ON m.ID = mc.MapID
         INNER JOIN (
-            SELECT MIN(t.RunTime) AS RunTime, t.MapCourseID, t.ModeID
-                FROM Times t
-                WHERE t.SteamID64=%llu AND t.Teleports=0 
-                GROUP BY t.MapCourseID, t.ModeID
-        ) x ON x.RunTime = t.RunTime AND x.MapCourseID = t.MapCourseID AND x.ModeID = t.ModeID
-        WHERE m.Name = '%s'
+            SELECT MIN(ProRunTime) AS RunTime, MapCourseID, ModeID
+                FROM PersonalBests
+                WHERE SteamID64=? AND ProRunTime IS NOT NULL
+                GROUP BY MapCourseID, ModeID
+        ) x ON x.RunTime = pb.ProRunTime AND x.MapCourseID = pb.MapCourseID AND x.ModeID = pb.ModeID
+        WHERE pb.SteamID64=? AND m.Name = ?
 )";
@@ -27,18 +27,18 @@ constexpr char mysql_players_create[] = R"(
 
 constexpr char sqlite_players_insert[] = R"(
     INSERT OR IGNORE INTO Players (Alias, IP, SteamID64, LastPlayed) 
-        VALUES ('%s', '%s', %lld, CURRENT_TIMESTAMP)
+        VALUES (?, ?, ?, CURRENT_TIMESTAMP)
 )";
 
 constexpr char sqlite_players_update[] = R"(
     UPDATE OR IGNORE Players 
-        SET Alias='%s', IP='%s', LastPlayed=CURRENT_TIMESTAMP 
-        WHERE SteamID64=%lld
+        SET Alias=?, IP=?, LastPlayed=CURRENT_TIMESTAMP 
+        WHERE SteamID64=?
 )";
 
 constexpr char mysql_players_upsert[] = R"(
     INSERT INTO Players (Alias, IP, SteamID64, LastPlayed) 
-        VALUES ('%s', '%s', %lld, CURRENT_TIMESTAMP) 
+        VALUES (?, ?, ?, CURRENT_TIMESTAMP) 
         ON DUPLICATE KEY UPDATE 
         SteamID64=VALUES(SteamID64), Alias=VALUES(Alias), 
         IP=VALUES(IP), LastPlayed=VALUES(LastPlayed)
@@ -47,31 +47,31 @@ constexpr char mysql_players_upsert[] = R"(
 constexpr char sql_players_get_infos[] = R"(
     SELECT Cheater, Preferences
         FROM Players 
-        WHERE SteamID64=%lld
+        WHERE SteamID64=?
 )";
 
 constexpr char sql_players_set_prefs[] = R"(
     UPDATE Players 
-        SET Preferences='%s'
-        WHERE SteamID64=%lld
+        SET Preferences=?
+        WHERE SteamID64=?
 )";
 
 constexpr char sql_players_set_cheater[] = R"(
     UPDATE Players 
-        SET Cheater=%lld 
-        WHERE SteamID64=%lld
+        SET Cheater=? 
+        WHERE SteamID64=?
 )";
 
 constexpr char sql_players_getalias[] = R"(
     SELECT Alias 
         FROM Players 
-        WHERE SteamID64=%lld
+        WHERE SteamID64=?
 )";
 
 constexpr char sql_players_searchbyalias[] = R"(
     SELECT SteamID64, Alias 
         FROM Players 
-        WHERE LOWER(Alias) LIKE '%%%s%%' 
-        ORDER BY (Players.Cheater=0) DESC, (LOWER(Alias)='%s') DESC, LastPlayed DESC 
+        WHERE LOWER(Alias) LIKE ? 
+        ORDER BY (Players.Cheater=0) DESC, (LOWER(Alias)=?) DESC, LastPlayed DESC 
         LIMIT 1
 )";
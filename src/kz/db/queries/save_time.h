@@ -3,67 +3,61 @@
 constexpr char sql_getpb[] = R"(
     SELECT Times.RunTime, Times.Teleports 
         FROM Times 
-        WHERE Times.MapCourseID=%d
-        AND Times.SteamID64=%llu
-        AND Times.ModeID=%d AND Times.StyleIDFlags=%llu
+        WHERE Times.MapCourseID=?
+        AND Times.SteamID64=?
+        AND Times.ModeID=? AND Times.StyleIDFlags=?
         ORDER BY Times.RunTime 
-        LIMIT %d
+        LIMIT ?
 )";
 
 constexpr char sql_getpbpro[] = R"(
     SELECT Times.RunTime 
         FROM Times 
-        WHERE Times.MapCourseID=%d
-        AND Times.SteamID64=%llu
-        AND Times.ModeID=%d AND Times.StyleIDFlags=%llu
+        WHERE Times.MapCourseID=?
+        AND Times.SteamID64=?
+        AND Times.ModeID=? AND Times.StyleIDFlags=?
         AND Times.Teleports=0 
         ORDER BY Times.RunTime 
-        LIMIT %d
+        LIMIT ?
 )";
 // The following queries should have no style!
 
 constexpr char sql_getmaprank[] = R"(
-    SELECT COUNT(DISTINCT Times.SteamID64) 
-        FROM Times 
-        INNER JOIN Players ON Players.SteamID64=Times.SteamID64 
-        WHERE Players.Cheater=0 AND Times.MapCourseID=%d
-        AND Times.ModeID=%d AND Times.StyleIDFlags=0 AND Times.RunTime < 
-        (SELECT MIN(Times.RunTime) 
-        FROM Times 
-        INNER JOIN Players ON Players.SteamID64=Times.SteamID64 
-        WHERE Players.Cheater=0 AND Times.SteamID64=%llu AND Times.MapCourseID=%d
-        AND Times.ModeID=%d AND Times.StyleIDFlags=0) 
-    + 1
+    SELECT COUNT(*) 
+        FROM PersonalBests 
+        INNER JOIN Players ON Players.SteamID64=PersonalBests.SteamID64 
+        WHERE Players.Cheater=0 AND PersonalBests.MapCourseID=?
+        AND PersonalBests.ModeID=? AND PersonalBests.StyleIDFlags=0 AND PersonalBests.RunTime <= 
+        (SELECT RunTime 
+        FROM PersonalBests 
+        WHERE SteamID64=? AND MapCourseID=?
+        AND ModeID=? AND StyleIDFlags=0)
 )";
 
 constexpr char sql_getmaprankpro[] = R"(
-    SELECT COUNT(DISTINCT Times.SteamID64) 
-        FROM Times 
-        INNER JOIN Players ON Players.SteamID64=Times.SteamID64 
-        WHERE Players.Cheater=0 AND Times.MapCourseID=%d
-        AND Times.ModeID=%d AND Times.StyleIDFlags=0 AND Times.Teleports=0 
-        AND Times.RunTime < 
-        (SELECT MIN(Times.RunTime) 
-        FROM Times 
-        INNER JOIN Players ON Players.SteamID64=Times.SteamID64 
-        WHERE Players.Cheater=0 AND Times.SteamID64=%llu 
-        AND Times.MapCourseID=%d AND Times.ModeID=%d 
-        AND Times.StyleIDFlags=0 AND Times.Teleports=0) 
-    + 1
+    SELECT COUNT(*) 
+        FROM PersonalBests 
+        INNER JOIN Players ON Players.SteamID64=PersonalBests.SteamID64 
+        WHERE Players.Cheater=0 AND PersonalBests.MapCourseID=?
+        AND PersonalBests.ModeID=? AND PersonalBests.StyleIDFlags=0 AND PersonalBests.ProRunTime <= 
+        (SELECT ProRunTime 
+        FROM PersonalBests 
+        WHERE SteamID64=? AND MapCourseID=?
+        AND ModeID=? AND StyleIDFlags=0)
 )";
 
 constexpr char sql_getlowestmaprank[] = R"(
-    SELECT COUNT(DISTINCT Times.SteamID64) 
-        FROM Times 
-        INNER JOIN Players ON Players.SteamID64=Times.SteamID64 
-        WHERE Players.Cheater=0 AND Times.MapCourseID=%d
-        AND Times.ModeID=%d AND Times.StyleIDFlags=0
+    SELECT COUNT(*) 
+        FROM PersonalBests 
+        INNER JOIN Players ON Players.SteamID64=PersonalBests.SteamID64 
+        WHERE Players.Cheater=0 AND PersonalBests.MapCourseID=?
+        AND PersonalBests.ModeID=? AND PersonalBests.StyleIDFlags=0
 )";
 
 constexpr char sql_getlowestmaprankpro[] = R"(
-    SELECT COUNT(DISTINCT Times.SteamID64) 
-        FROM Times 
-        INNER JOIN Players ON Players.SteamID64=Times.SteamID64 
-        WHERE Players.Cheater=0 AND Times.MapCourseID=%d
-        AND Times.ModeID=%d AND Times.StyleIDFlags=0 AND Times.Teleports=0
+    SELECT COUNT(*) 
+        FROM PersonalBests 
+        INNER JOIN Players ON Players.SteamID64=PersonalBests.SteamID64 
+        WHERE Players.Cheater=0 AND PersonalBests.MapCourseID=?
+        AND PersonalBests.ModeID=? AND PersonalBests.StyleIDFlags=0 AND PersonalBests.ProRunTime IS NOT NULL
 )";
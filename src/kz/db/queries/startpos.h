@@ -32,7 +32,7 @@ constexpr char mysql_startpos_create[] = R"(
 
 constexpr char sql_startpos_upsert[] = R"(
 	REPLACE INTO StartPosition (SteamID64, MapID, X, Y, Z, Angle0, Angle1) 
-		VALUES (%llu, %d, %f, %f, %f, %f, %f)
+		VALUES (?, ?, ?, ?, ?, ?, ?)
 )";
 
 constexpr char sql_startpos_get[] = R"(
@@ -40,6 +40,6 @@ constexpr char sql_startpos_get[] = R"(
 		FROM 
 			StartPosition 
 		WHERE 
-			SteamID64 = %llu AND 
-			MapID = %d
+			SteamID64 = ? AND 
+			MapID = ?
 )";
@@ -17,15 +17,15 @@ constexpr char sqlite_styles_create[] = R"(
 )";
 
 constexpr char sqlite_styles_insert[] = R"(
-    INSERT OR IGNORE INTO Styles (Name, ShortName) VALUES ('%s', '%s')
+    INSERT OR IGNORE INTO Styles (Name, ShortName) VALUES (?, ?)
 )";
 
 constexpr char mysql_styles_insert[] = R"(
-    INSERT IGNORE INTO Styles (Name, ShortName) VALUES ('%s', '%s')
+    INSERT IGNORE INTO Styles (Name, ShortName) VALUES (?, ?)
 )";
 
 constexpr char sql_styles_findid[] = R"(
-    SELECT ID FROM Styles WHERE Name = '%s'
+    SELECT ID FROM Styles WHERE Name = ?
 )";
 
 constexpr char sql_styles_fetch_all[] = R"(
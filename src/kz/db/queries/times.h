@@ -43,10 +43,135 @@ constexpr char mysql_times_create[] = R"(
 
 constexpr char sql_times_insert[] = R"(
     INSERT INTO Times (SteamID64, MapCourseID, ModeID, StyleIDFlags, RunTime, Teleports, Metadata) 
-        VALUES (%llu, %d, %d, %llu, %.7f, %llu, '%s')
+        VALUES (?, ?, ?, ?, ?, ?, ?)
 )";
 
 constexpr char sql_times_delete[] = R"(
     DELETE FROM Times 
         WHERE ID=%d
 )";
+
+// Leaderboard access path: course tops, map ranks and server records all filter on
+// (MapCourseID, ModeID, StyleIDFlags) and range/sort on RunTime.
+constexpr char sqlite_times_create_index_leaderboard[] = R"(
+    CREATE INDEX IF NOT EXISTS IX_Times_Leaderboard 
+        ON Times (MapCourseID, ModeID, StyleIDFlags, RunTime, Teleports, SteamID64)
+)";
+
+constexpr char mysql_times_create_index_leaderboard[] = R"(
+    CREATE INDEX IX_Times_Leaderboard 
+        ON Times (MapCourseID, ModeID, StyleIDFlags, RunTime, Teleports, SteamID64)
+)";
+
+// Player access path: personal bests and the SteamID64 self-join used to find each player's best run.
+constexpr char sqlite_times_create_index_player[] = R"(
+    CREATE INDEX IF NOT EXISTS IX_Times_Player 
+        ON Times (SteamID64, MapCourseID, ModeID, StyleIDFlags, RunTime, Teleports)
+)";
+
+constexpr char mysql_times_create_index_player[] = R"(
+    CREATE INDEX IX_Times_Player 
+        ON Times (SteamID64, MapCourseID, ModeID, StyleIDFlags, RunTime, Teleports)
+)";
+
+// =====[ PERSONAL BESTS ]=====
+
+// One row per (player, course, mode, styles), kept up to date in the same transaction as every time insert.
+// Nub columns track the fastest run overall, Pro columns the fastest run without teleports (NULL if there is none).
+
+constexpr char sqlite_personalbests_create[] = R"(
+    CREATE TABLE IF NOT EXISTS PersonalBests ( 
+        SteamID64 INTEGER NOT NULL, 
+        MapCourseID INTEGER NOT NULL, 
+        ModeID INTEGER NOT NULL, 
+        StyleIDFlags INTEGER NOT NULL, 
+        TimeID INTEGER NOT NULL, 
+        RunTime REAL NOT NULL, 
+        Teleports INTEGER NOT NULL, 
+        ProTimeID INTEGER, 
+        ProRunTime REAL, 
+        CONSTRAINT PK_PersonalBests PRIMARY KEY (SteamID64, MapCourseID, ModeID, StyleIDFlags), 
+        CONSTRAINT FK_PersonalBests_SteamID64 FOREIGN KEY (SteamID64) REFERENCES Players(SteamID64) 
+        ON UPDATE CASCADE ON DELETE CASCADE, 
+        CONSTRAINT FK_PersonalBests_MapCourseID FOREIGN KEY (MapCourseID) REFERENCES MapCourses(ID) 
+        ON UPDATE CASCADE ON DELETE CASCADE, 
+        CONSTRAINT FK_PersonalBests_Mode FOREIGN KEY (ModeID) REFERENCES Modes(ID) 
+        ON UPDATE CASCADE ON DELETE CASCADE)
+)";
+
+constexpr char mysql_personalbests_create[] = R"(
+    CREATE TABLE IF NOT EXISTS PersonalBests ( 
+        SteamID64 BIGINT UNSIGNED NOT NULL, 
+        MapCourseID INTEGER UNSIGNED NOT NULL, 
+        ModeID INTEGER UNSIGNED NOT NULL, 
+        StyleIDFlags INTEGER UNSIGNED NOT NULL, 
+        TimeID INTEGER UNSIGNED NOT NULL, 
+        RunTime DOUBLE UNSIGNED NOT NULL, 
+        Teleports SMALLINT UNSIGNED NOT NULL, 
+        ProTimeID INTEGER UNSIGNED, 
+        ProRunTime DOUBLE UNSIGNED, 
+        CONSTRAINT PK_PersonalBests PRIMARY KEY (SteamID64, MapCourseID, ModeID, StyleIDFlags), 
+        CONSTRAINT FK_PersonalBests_SteamID64 FOREIGN KEY (SteamID64) REFERENCES Players(SteamID64) 
+        ON UPDATE CASCADE ON DELETE CASCADE, 
+        CONSTRAINT FK_PersonalBests_MapCourseID FOREIGN KEY (MapCourseID) REFERENCES MapCourses(ID) 
+        ON UPDATE CASCADE ON DELETE CASCADE, 
+        CONSTRAINT FK_PersonalBests_Mode FOREIGN KEY (ModeID) REFERENCES Modes(ID) 
+        ON UPDATE CASCADE ON DELETE CASCADE)
+)";
+
+// Fills the table from the existing run history. Ties are broken by the lowest Times ID.
+constexpr char sql_personalbests_backfill[] = R"(
+    INSERT INTO PersonalBests (SteamID64, MapCourseID, ModeID, StyleIDFlags, TimeID, RunTime, Teleports, ProTimeID, ProRunTime) 
+        SELECT t.SteamID64, t.MapCourseID, t.ModeID, t.StyleIDFlags, t.ID, t.RunTime, t.Teleports, pro.ID, pro.RunTime 
+            FROM Times t 
+            LEFT OUTER JOIN Times t2 ON t2.SteamID64=t.SteamID64 
+            AND t2.MapCourseID=t.MapCourseID AND t2.ModeID=t.ModeID AND t2.StyleIDFlags=t.StyleIDFlags 
+            AND (t2.RunTime<t.RunTime OR (t2.RunTime=t.RunTime AND t2.ID<t.ID)) 
+            LEFT OUTER JOIN ( 
+                SELECT p.ID, p.SteamID64, p.MapCourseID, p.ModeID, p.StyleIDFlags, p.RunTime 
+                    FROM Times p 
+                    LEFT OUTER JOIN Times p2 ON p2.SteamID64=p.SteamID64 
+                    AND p2.MapCourseID=p.MapCourseID AND p2.ModeID=p.ModeID AND p2.StyleIDFlags=p.StyleIDFlags 
+                    AND p2.Teleports=0 AND (p2.RunTime<p.RunTime OR (p2.RunTime=p.RunTime AND p2.ID<p.ID)) 
+                    WHERE p.Teleports=0 AND p2.ID IS NULL 
+            ) pro ON pro.SteamID64=t.SteamID64 AND pro.MapCourseID=t.MapCourseID 
+            AND pro.ModeID=t.ModeID AND pro.StyleIDFlags=t.StyleIDFlags 
+            WHERE t2.ID IS NULL
+)";
+
+// Rank lookups: count of PBs faster than a given time on a course/mode/style.
+constexpr char sql_personalbests_create_index_leaderboard[] = R"(
+    CREATE INDEX IX_PersonalBests_Leaderboard 
+        ON PersonalBests (MapCourseID, ModeID, StyleIDFlags, RunTime)
+)";
+
+constexpr char sql_personalbests_create_index_leaderboard_pro[] = R"(
+    CREATE INDEX IX_PersonalBests_LeaderboardPro 
+        ON PersonalBests (MapCourseID, ModeID, StyleIDFlags, ProRunTime)
+)";
+
+// Must directly follow sql_times_insert in the same transaction, the new run's ID is read back from the connection.
+// The assignment order matters on MySQL: the RunTime columns are updated last as the other columns compare against their old values.
+constexpr char sqlite_personalbests_upsert[] = R"(
+    INSERT INTO PersonalBests (SteamID64, MapCourseID, ModeID, StyleIDFlags, TimeID, RunTime, Teleports, ProTimeID, ProRunTime) 
+        VALUES (?, ?, ?, ?, last_insert_rowid(), ?, ?, 
+            CASE WHEN ?=0 THEN last_insert_rowid() END, CASE WHEN ?=0 THEN ? END) 
+        ON CONFLICT(SteamID64, MapCourseID, ModeID, StyleIDFlags) DO UPDATE SET 
+            TimeID = CASE WHEN excluded.RunTime < RunTime THEN excluded.TimeID ELSE TimeID END, 
+            Teleports = CASE WHEN excluded.RunTime < RunTime THEN excluded.Teleports ELSE Teleports END, 
+            RunTime = MIN(excluded.RunTime, RunTime), 
+            ProTimeID = CASE WHEN excluded.ProRunTime < IFNULL(ProRunTime, excluded.ProRunTime + 1) THEN excluded.ProTimeID ELSE ProTimeID END, 
+            ProRunTime = CASE WHEN excluded.ProRunTime < IFNULL(ProRunTime, excluded.ProRunTime + 1) THEN excluded.ProRunTime ELSE ProRunTime END
+)";
+
+constexpr char mysql_personalbests_upsert[] = R"(
+    INSERT INTO PersonalBests (SteamID64, MapCourseID, ModeID, StyleIDFlags, TimeID, RunTime, Teleports, ProTimeID, ProRunTime) 
+        VALUES (?, ?, ?, ?, LAST_INSERT_ID(), ?, ?, 
+            CASE WHEN ?=0 THEN LAST_INSERT_ID() END, CASE WHEN ?=0 THEN ? END) 
+        ON DUPLICATE KEY UPDATE 
+            TimeID = IF(VALUES(RunTime) < RunTime, VALUES(TimeID), TimeID), 
+            Teleports = IF(VALUES(RunTime) < RunTime, VALUES(Teleports), Teleports), 
+            RunTime = LEAST(VALUES(RunTime), RunTime), 
+            ProTimeID = IF(VALUES(ProRunTime) < IFNULL(ProRunTime, VALUES(ProRunTime) + 1), VALUES(ProTimeID), ProTimeID), 
+            ProRunTime = IF(VALUES(ProRunTime) < IFNULL(ProRunTime, VALUES(ProRunTime) + 1), VALUES(ProRunTime), ProRunTime)
+)";
@@ -0,0 +1,47 @@
+#include "kz_db.h"
+#include "statement.h"
+#include "kz/mode/kz_mode.h"
+#include "vendor/sql_mm/src/public/sql_mm.h"
+
+#include "queries/jumpstats.h"
+
+using namespace KZ::Database;
+
+void KZDatabaseService::SaveJumpstat(Jump *jump)
+{
+	if (!KZDatabaseService::IsReady() || !this->IsSetup() || !this->jumpstatPBsLoaded)
+	{
+		return;
+	}
+	i32 modeID = KZ::mode::GetModeInfo(this->player->modeService).databaseID;
+	if (modeID < 0)
+	{
+		return;
+	}
+
+	i32 distance = (i32)(jump->GetDistance() * KZ_JUMPSTATS_DISTANCE_PRECISION);
+	u32 key = GetJumpstatPBKey(modeID, jump->GetJumpType());
+	auto it = this->jumpstatPBs.find(key);
+	if (it != this->jumpstatPBs.end() && it->second >= distance)
+	{
+		return;
+	}
+	this->jumpstatPBs[key] = distance;
+
+	u64 steamID64 = this->player->GetSteamId64();
+	u32 strafes = jump->strafes.Count();
+	CALL_FORWARD(eventListeners, OnJumpstatPB, this->player, jump->GetJumpType(), modeID, jump->GetDistance(), 0, strafes, jump->GetSync(),
+				 jump->GetTakeoffSpeed(), jump->GetMaxSpeed(), jump->GetAirtime());
+
+	// Block jumps aren't detected yet, every jump is saved as a regular one.
+	std::vector<std::string> queries;
+	queries.push_back(Statement::Get(sql_jumpstats_deletepbs).Bind(steamID64, (i32)jump->GetJumpType(), modeID, 0));
+	queries.push_back(Statement::Get(sql_jumpstats_insert)
+						  .Bind(steamID64, (i32)jump->GetJumpType(), modeID, distance, 0, 0, strafes,
+								(i32)(jump->GetSync() * KZ_JUMPSTATS_SYNC_PRECISION), (i32)(jump->GetTakeoffSpeed() * KZ_JUMPSTATS_SPEED_PRECISION),
+								(i32)(jump->GetMaxSpeed() * KZ_JUMPSTATS_SPEED_PRECISION), (i32)(jump->GetAirtime() * KZ_JUMPSTATS_AIRTIME_PRECISION)));
+
+	// A better jump of the same kind replaces this one if it is still queued.
+	u64 writeKey = ((steamID64 & 0xFFFFFFFF) << 32) | key;
+	KZDatabaseService::QueueWrite(__func__, std::move(queries), OnGenericTxnSuccess, OnGenericTxnFailure, writeKey);
+}
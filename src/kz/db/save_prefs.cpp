@@ -1,10 +1,13 @@
 #include "kz_db.h"
+#include "statement.h"
 #include "kz/option/kz_option.h"
 
 #include "vendor/sql_mm/src/public/sql_mm.h"
 
 #include "queries/players.h"
 
+using namespace KZ::Database;
+
 void KZDatabaseService::SavePrefs(CUtlString prefs)
 {
 	if (!KZDatabaseService::IsReady() || !this->IsSetup())
@@ -12,14 +15,10 @@ void KZDatabaseService::SavePrefs(CUtlString prefs)
 		return;
 	}
 	u64 steamID64 = this->player->GetSteamId64();
-	std::string cleanedPrefs = KZDatabaseService::GetDatabaseConnection()->Escape(prefs);
-
-	Transaction txn;
-
-	CUtlString query;
-	query.Format(sql_players_set_prefs, prefs.Get(), steamID64);
 
-	txn.queries.push_back(query.Get());
+	std::vector<std::string> queries;
+	queries.push_back(Statement::Get(sql_players_set_prefs).Bind(prefs, steamID64));
 
-	KZDatabaseService::GetDatabaseConnection()->ExecuteTransaction(txn, OnGenericTxnSuccess, OnGenericTxnFailure);
+	// Only the latest preferences of a player need to be written.
+	KZDatabaseService::QueueWrite(__func__, std::move(queries), OnGenericTxnSuccess, OnGenericTxnFailure, steamID64);
 }
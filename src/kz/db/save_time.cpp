@@ -1,4 +1,5 @@
 #include "kz_db.h"
+#include "statement.h"
 #include "kz/mode/kz_mode.h"
 #include "kz/style/kz_style.h"
 #include "kz/timer/kz_timer.h"
@@ -16,37 +17,54 @@ void KZDatabaseService::SaveTime(u64 steamID, u32 courseID, i32 modeID, f64 time
 		return;
 	}
 
-	char query[1024];
-	Transaction txn;
-	V_snprintf(query, sizeof(query), sql_times_insert, steamID, courseID, modeID, styleIDs, time, teleportsUsed, metadata.data());
-	txn.queries.push_back(query);
+	std::vector<std::string> queries;
+	queries.push_back(Statement::Get(sql_times_insert).Bind(steamID, courseID, modeID, styleIDs, time, teleportsUsed, metadata));
+	// Update the player's personal best with the run that was just inserted.
+	switch (KZDatabaseService::GetDatabaseType())
+	{
+		case DatabaseType::SQLite:
+		{
+			queries.push_back(Statement::Get(sqlite_personalbests_upsert)
+								  .Bind(steamID, courseID, modeID, styleIDs, time, teleportsUsed, teleportsUsed, teleportsUsed, time));
+			break;
+		}
+		case DatabaseType::MySQL:
+		{
+			queries.push_back(Statement::Get(mysql_personalbests_upsert)
+								  .Bind(steamID, courseID, modeID, styleIDs, time, teleportsUsed, teleportsUsed, teleportsUsed, time));
+			break;
+		}
+	}
+	// Styled runs don't report anything back to the player.
 	if (styleIDs != 0)
 	{
-		KZDatabaseService::GetDatabaseConnection()->ExecuteTransaction(txn, OnGenericTxnSuccess, OnGenericTxnFailure);
+		onSuccess = OnGenericTxnSuccess;
+		onFailure = OnGenericTxnFailure;
 	}
 	else
 	{
 		// Get Top 2 PRO PBs
-		V_snprintf(query, sizeof(query), sql_getpb, courseID, steamID, modeID, styleIDs, 2);
-		txn.queries.push_back(query);
+		queries.push_back(Statement::Get(sql_getpb).Bind(courseID, steamID, modeID, styleIDs, 2));
 		// Get Rank
-		V_snprintf(query, sizeof(query), sql_getmaprank, courseID, modeID, steamID, courseID, modeID);
-		txn.queries.push_back(query);
+		queries.push_back(Statement::Get(sql_getmaprank).Bind(courseID, modeID, steamID, courseID, modeID));
 		// Get Number of Players with Times
-		V_snprintf(query, sizeof(query), sql_getlowestmaprank, courseID, modeID);
-		txn.queries.push_back(query);
+		queries.push_back(Statement::Get(sql_getlowestmaprank).Bind(courseID, modeID));
 		if (teleportsUsed == 0)
 		{
 			// Get Top 2 PRO PBs
-			V_snprintf(query, sizeof(query), sql_getpbpro, courseID, steamID, modeID, styleIDs, 2);
-			txn.queries.push_back(query);
+			queries.push_back(Statement::Get(sql_getpbpro).Bind(courseID, steamID, modeID, styleIDs, 2));
 			// Get PRO Rank
-			V_snprintf(query, sizeof(query), sql_getmaprankpro, courseID, modeID, steamID, courseID, modeID);
-			txn.queries.push_back(query);
+			queries.push_back(Statement::Get(sql_getmaprankpro).Bind(courseID, modeID, steamID, courseID, modeID));
 			// Get Number of Players with Times
-			V_snprintf(query, sizeof(query), sql_getlowestmaprankpro, courseID, modeID);
-			txn.queries.push_back(query);
+			queries.push_back(Statement::Get(sql_getlowestmaprankpro).Bind(courseID, modeID));
 		}
-		KZDatabaseService::GetDatabaseConnection()->ExecuteTransaction(txn, onSuccess, onFailure);
 	}
+	u32 mapID = KZDatabaseService::GetMapID();
+	auto onInserted = [steamID, mapID, courseID, modeID, styleIDs, time, teleportsUsed, onSuccess](std::vector<ISQLQuery *> queries)
+	{
+		Player *player = g_pPlayerManager->SteamIdToPlayer(steamID);
+		CALL_FORWARD(eventListeners, OnTimeInserted, player, steamID, mapID, courseID, modeID, styleIDs, (u64)(time * 1000), teleportsUsed);
+		onSuccess(queries);
+	};
+	KZDatabaseService::QueueWrite(__func__, std::move(queries), onInserted, onFailure);
 }
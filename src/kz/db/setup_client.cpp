@@ -1,7 +1,9 @@
 #include "kz_db.h"
+#include "statement.h"
 #include "kz/option/kz_option.h"
 #include "vendor/sql_mm/src/public/sql_mm.h"
 
+#include "queries/jumpstats.h"
 #include "queries/players.h"
 
 using namespace KZ::Database;
@@ -17,11 +19,8 @@ void KZDatabaseService::SetupClient()
 		return;
 	}
 	// Setup Client Step 1 - Upsert them into Players Table
-	char query[1024];
-
 	// Note: The player must have been authenticated and have a valid steamID at this point.
 	const char *clientName = this->player->GetName();
-	std::string escapedName = GetDatabaseConnection()->Escape(clientName);
 	u64 steamID64 = this->player->GetClient()->GetClientSteamID()->ConvertToUint64();
 	const char *clientIP = this->player->GetIpAddress();
 
@@ -32,28 +31,27 @@ void KZDatabaseService::SetupClient()
 		case DatabaseType::SQLite:
 		{
 			// UPDATE OR IGNORE
-			V_snprintf(query, sizeof(query), sqlite_players_update, escapedName.c_str(), clientIP, steamID64);
-			txn.queries.push_back(query);
+			txn.queries.push_back(Statement::Get(sqlite_players_update).Bind(clientName, clientIP, steamID64));
 			// INSERT OR IGNORE
-			V_snprintf(query, sizeof(query), sqlite_players_insert, escapedName.c_str(), clientIP, steamID64);
-			txn.queries.push_back(query);
+			txn.queries.push_back(Statement::Get(sqlite_players_insert).Bind(clientName, clientIP, steamID64));
 			break;
 		}
 		case DatabaseType::MySQL:
 		{
 			// INSERT ... ON DUPLICATE KEY ...
-			V_snprintf(query, sizeof(query), mysql_players_upsert, escapedName.c_str(), clientIP, steamID64);
-			txn.queries.push_back(query);
+			txn.queries.push_back(Statement::Get(mysql_players_upsert).Bind(clientName, clientIP, steamID64));
 			break;
 		}
 	}
 
-	V_snprintf(query, sizeof(query), sql_players_get_infos, steamID64);
-	txn.queries.push_back(query);
+	txn.queries.push_back(Statement::Get(sql_players_get_infos).Bind(steamID64));
+	txn.queries.push_back(Statement::Get(sql_jumpstats_getpbs).Bind(steamID64));
+	this->jumpstatPBs.clear();
+	this->jumpstatPBsLoaded = false;
 	CPlayerUserId userID = this->player->GetClient()->GetUserID();
 
-	GetDatabaseConnection()->ExecuteTransaction(
-		txn,
+	KZDatabaseService::ExecuteTransaction(
+		__func__, txn,
 		[&, userID, steamID64](std::vector<ISQLQuery *> queries)
 		{
 			KZPlayer *pl = g_pKZPlayerManager->ToPlayer(userID);
@@ -83,6 +81,13 @@ void KZDatabaseService::SetupClient()
 				pl->optionService->InitializeLocalPrefs(prefs);
 				CALL_FORWARD(KZDatabaseService::eventListeners, OnClientSetup, pl, pl->GetSteamId64(), isCheater);
 			}
+			ISQLResult *jumpstats = queries.back()->GetResultSet();
+			while (jumpstats && jumpstats->FetchRow())
+			{
+				u32 key = GetJumpstatPBKey(jumpstats->GetInt(1), (JumpType)jumpstats->GetInt(2));
+				pl->databaseService->jumpstatPBs[key] = jumpstats->GetInt(0);
+			}
+			pl->databaseService->jumpstatPBsLoaded = true;
 		},
 		OnGenericTxnFailure);
 }
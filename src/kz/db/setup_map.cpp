@@ -1,4 +1,5 @@
 #include "kz_db.h"
+#include "statement.h"
 #include "queries/maps.h"
 #include "vendor/sql_mm/src/public/sql_mm.h"
 
@@ -27,39 +28,33 @@ void KZDatabaseService::SetupMap()
 	}
 
 	Transaction txn;
-	char query[1024];
 	CUtlString mapName = g_pKZUtils->GetServerGlobals()->mapname.ToCStr();
-	auto escapedMapName = KZDatabaseService::GetDatabaseConnection()->Escape(mapName.Get());
 	auto databaseType = KZDatabaseService::GetDatabaseType();
 	switch (databaseType)
 	{
 		case DatabaseType::SQLite:
 		{
-			V_snprintf(query, sizeof(query), sqlite_maps_insert, escapedMapName.c_str());
-			txn.queries.push_back(query);
-			V_snprintf(query, sizeof(query), sqlite_maps_update, escapedMapName.c_str());
-			txn.queries.push_back(query);
+			txn.queries.push_back(Statement::Get(sqlite_maps_insert).Bind(mapName));
+			txn.queries.push_back(Statement::Get(sqlite_maps_update).Bind(mapName));
 			break;
 		}
 		case DatabaseType::MySQL:
 		{
-			V_snprintf(query, sizeof(query), mysql_maps_upsert, escapedMapName.c_str());
-			txn.queries.push_back(query);
+			txn.queries.push_back(Statement::Get(mysql_maps_upsert).Bind(mapName));
 			break;
 		}
 		default:
 		{
 			// This shouldn't happen.
-			query[0] = 0;
 			break;
 		}
 	}
 
-	V_snprintf(query, sizeof(query), sql_maps_findid, escapedMapName.c_str(), escapedMapName.c_str());
-	txn.queries.push_back(query);
+	std::string pattern = std::string("%") + mapName.Get() + "%";
+	txn.queries.push_back(Statement::Get(sql_maps_findid).Bind(pattern, mapName));
 	// clang-format off
-	KZDatabaseService::GetDatabaseConnection()->ExecuteTransaction(
-		txn, 
+	KZDatabaseService::ExecuteTransaction(
+		__func__, txn, 
 		[databaseType, mapName](std::vector<ISQLQuery *> queries) 
 		{
 			auto currentMapName = g_pKZUtils->GetServerGlobals()->mapname.ToCStr();
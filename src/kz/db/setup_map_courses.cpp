@@ -1,4 +1,5 @@
 #include "kz_db.h"
+#include "statement.h"
 
 #include "queries/courses.h"
 
@@ -15,39 +16,33 @@ bool KZDatabaseService::AreCoursesSetUp()
 
 void KZDatabaseService::SetupCourses(CUtlVector<KZCourseDescriptor *> &courses)
 {
-	char query[1024];
 	Transaction txn;
 	FOR_EACH_VEC(courses, i)
 	{
 		KZCourseDescriptor *course = courses[i];
-		std::string cleanCourseName = KZDatabaseService::GetDatabaseConnection()->Escape(course->GetName());
 		switch (databaseType)
 		{
 			case DatabaseType::SQLite:
 			{
-				V_snprintf(query, sizeof(query), sqlite_mapcourses_insert, KZDatabaseService::GetMapID(), cleanCourseName.c_str(), course->id);
-				txn.queries.push_back(query);
+				txn.queries.push_back(Statement::Get(sqlite_mapcourses_insert).Bind(KZDatabaseService::GetMapID(), course->name, course->id));
 				break;
 			}
 			case DatabaseType::MySQL:
 			{
-				V_snprintf(query, sizeof(query), mysql_mapcourses_insert, KZDatabaseService::GetMapID(), cleanCourseName.c_str(), course->id);
-				txn.queries.push_back(query);
+				txn.queries.push_back(Statement::Get(mysql_mapcourses_insert).Bind(KZDatabaseService::GetMapID(), course->name, course->id));
 				break;
 			}
 			default:
 			{
 				// This shouldn't happen.
-				query[0] = 0;
 				break;
 			}
 		}
 	}
-	V_snprintf(query, sizeof(query), sql_mapcourses_findall, KZDatabaseService::GetMapID());
-	txn.queries.push_back(query);
+	txn.queries.push_back(Statement::Get(sql_mapcourses_findall).Bind(KZDatabaseService::GetMapID()));
 	// clang-format off
-	KZDatabaseService::GetDatabaseConnection()->ExecuteTransaction(
-		txn,
+	KZDatabaseService::ExecuteTransaction(
+		__func__, txn,
 		[](std::vector<ISQLQuery *> queries) 
 		{
 			auto resultSet = queries.back()->GetResultSet();
@@ -1,4 +1,5 @@
 #include "kz_db.h"
+#include "statement.h"
 #include "kz/mode/kz_mode.h"
 #include "queries/modes.h"
 #include "vendor/sql_mm/src/public/sql_mm.h"
@@ -31,32 +32,29 @@ void KZDatabaseService::InsertAndUpdateModeIDs(CUtlString modeName, CUtlString s
 		return;
 	}
 	Transaction txn;
-	char query[1024];
 	switch (KZDatabaseService::GetDatabaseType())
 	{
 		case DatabaseType::SQLite:
 		{
-			V_snprintf(query, sizeof(query), sqlite_modes_insert, modeName.Get(), shortName.Get());
+			txn.queries.push_back(Statement::Get(sqlite_modes_insert).Bind(modeName, shortName));
 			break;
 		}
 		case DatabaseType::MySQL:
 		{
-			V_snprintf(query, sizeof(query), mysql_modes_insert, modeName.Get(), shortName.Get());
+			txn.queries.push_back(Statement::Get(mysql_modes_insert).Bind(modeName, shortName));
 			break;
 		}
 		default:
 		{
 			// Should never happen.
-			query[0] = 0;
+			txn.queries.push_back("");
 		}
 	}
-	txn.queries.push_back(query);
 
-	V_snprintf(query, sizeof(query), sql_modes_findid, modeName.Get());
-	txn.queries.push_back(query);
+	txn.queries.push_back(Statement::Get(sql_modes_findid).Bind(modeName));
 	// clang-format off
-	KZDatabaseService::GetDatabaseConnection()->ExecuteTransaction(
-		txn, 
+	KZDatabaseService::ExecuteTransaction(
+		__func__, txn, 
 		[modeName](std::vector<ISQLQuery *> queries) 
 		{
 			auto resultSet = queries[1]->GetResultSet();
@@ -1,4 +1,5 @@
 #include "kz_db.h"
+#include "statement.h"
 #include "kz/style/kz_style.h"
 #include "queries/styles.h"
 #include "vendor/sql_mm/src/public/sql_mm.h"
@@ -31,32 +32,29 @@ void KZDatabaseService::InsertAndUpdateStyleIDs(CUtlString styleName, CUtlString
 		return;
 	}
 	Transaction txn;
-	char query[1024];
 	switch (KZDatabaseService::GetDatabaseType())
 	{
 		case DatabaseType::SQLite:
 		{
-			V_snprintf(query, sizeof(query), sqlite_styles_insert, styleName.Get(), shortName.Get());
+			txn.queries.push_back(Statement::Get(sqlite_styles_insert).Bind(styleName, shortName));
 			break;
 		}
 		case DatabaseType::MySQL:
 		{
-			V_snprintf(query, sizeof(query), mysql_styles_insert, styleName.Get(), shortName.Get());
+			txn.queries.push_back(Statement::Get(mysql_styles_insert).Bind(styleName, shortName));
 			break;
 		}
 		default:
 		{
 			// Should never happen.
-			query[0] = 0;
+			txn.queries.push_back("");
 		}
 	}
-	txn.queries.push_back(query);
 
-	V_snprintf(query, sizeof(query), sql_styles_findid, styleName.Get());
-	txn.queries.push_back(query);
+	txn.queries.push_back(Statement::Get(sql_styles_findid).Bind(styleName));
 	// clang-format off
-	KZDatabaseService::GetDatabaseConnection()->ExecuteTransaction(
-		txn, 
+	KZDatabaseService::ExecuteTransaction(
+		__func__, txn, 
 		[styleName](std::vector<ISQLQuery *> queries) 
 		{
 			auto resultSet = queries[1]->GetResultSet();
@@ -0,0 +1,67 @@
+#include <unordered_map>
+
+#include "kz_db.h"
+#include "statement.h"
+#include "vendor/sql_mm/src/public/sql_mm.h"
+
+using namespace KZ::Database;
+
+static_global std::unordered_map<const char *, Statement> statementCache;
+
+Statement::Statement(const char *sql)
+{
+	std::string_view query(sql);
+	bool quoted = false;
+	size_t start = 0;
+	for (size_t i = 0; i < query.size(); i++)
+	{
+		if (query[i] == '\'')
+		{
+			quoted = !quoted;
+		}
+		else if (query[i] == '?' && !quoted)
+		{
+			this->parts.push_back(query.substr(start, i - start));
+			start = i + 1;
+		}
+	}
+	this->parts.push_back(query.substr(start));
+	this->length = query.size();
+}
+
+const Statement &Statement::Get(const char *sql)
+{
+	auto it = statementCache.find(sql);
+	if (it == statementCache.end())
+	{
+		it = statementCache.emplace(sql, Statement(sql)).first;
+	}
+	return it->second;
+}
+
+void Statement::ClearCache()
+{
+	statementCache.clear();
+}
+
+std::string Statement::Mismatch(size_t argCount) const
+{
+	// Sending a broken query would only fail later with a less useful error.
+	META_CONPRINTF("[KZ::DB] Statement expects %i parameters but got %i:\n%s\n", (i32)this->parts.size() - 1, (i32)argCount,
+				   std::string(this->parts[0]).c_str());
+	return {};
+}
+
+void Statement::AppendValue(std::string &query, const char *value)
+{
+	query.push_back('\'');
+	query.append(KZDatabaseService::GetDatabaseConnection()->Escape(value));
+	query.push_back('\'');
+}
+
+void Statement::AppendValue(std::string &query, f64 value)
+{
+	char buffer[32];
+	V_snprintf(buffer, sizeof(buffer), "%.7f", value);
+	query.append(buffer);
+}
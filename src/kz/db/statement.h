@@ -0,0 +1,68 @@
+#pragma once
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+#include "common.h"
+
+namespace KZ::Database
+{
+	// A query template with '?' placeholders, split into its literal parts once and cached afterwards.
+	// sql_mm doesn't expose bound parameters, so values are rendered here: numbers as they are,
+	// strings always quoted and escaped by the connection. The query is built on the heap and never truncated.
+	class Statement
+	{
+	public:
+		explicit Statement(const char *sql);
+
+		// Statements are cached by their template for as long as the connection lives.
+		static const Statement &Get(const char *sql);
+		static void ClearCache();
+
+		template<typename... Args>
+		std::string Bind(const Args &...args) const
+		{
+			if (this->parts.size() != sizeof...(Args) + 1)
+			{
+				return Mismatch(sizeof...(Args));
+			}
+			std::string query;
+			query.reserve(this->length + sizeof...(Args) * 24);
+			query.append(this->parts[0]);
+			size_t i = 1;
+			((AppendValue(query, args), query.append(this->parts[i++])), ...);
+			return query;
+		}
+
+	private:
+		std::vector<std::string_view> parts;
+		size_t length {};
+
+		std::string Mismatch(size_t argCount) const;
+
+		static void AppendValue(std::string &query, const char *value);
+		static void AppendValue(std::string &query, f64 value);
+
+		static void AppendValue(std::string &query, const std::string &value)
+		{
+			AppendValue(query, value.c_str());
+		}
+
+		static void AppendValue(std::string &query, std::string_view value)
+		{
+			AppendValue(query, std::string(value).c_str());
+		}
+
+		static void AppendValue(std::string &query, const CUtlString &value)
+		{
+			AppendValue(query, value.Get());
+		}
+
+		template<typename T, std::enable_if_t<std::is_integral_v<T>, int> = 0>
+		static void AppendValue(std::string &query, T value)
+		{
+			query.append(std::to_string(value));
+		}
+	};
+} // namespace KZ::Database
@@ -0,0 +1,195 @@
+#include <map>
+
+#include "kz_db.h"
+#include "utils/simplecmds.h"
+#include "vendor/sql_mm/src/public/sql_mm.h"
+
+// How long queued writes are held back so that others can join the same transaction.
+#define KZ_DB_WRITE_BATCH_INTERVAL 0.25
+#define KZ_DB_WRITE_BATCH_SIZE     64
+// Latency buckets are powers of two in milliseconds, the last one takes everything slower.
+#define KZ_DB_LATENCY_BUCKETS 14
+
+struct QueuedWrite
+{
+	const char *label;
+	u64 key;
+	f64 queueTime;
+	std::vector<std::string> queries;
+	TransactionSuccessCallbackFunc onSuccess;
+	TransactionFailureCallbackFunc onFailure;
+};
+
+struct LatencyHistogram
+{
+	u64 count;
+	u64 failures;
+	f64 totalTime;
+	f64 maxTime;
+	u64 buckets[KZ_DB_LATENCY_BUCKETS];
+};
+
+static_global std::vector<QueuedWrite> writeQueue;
+static_global f64 writeQueueStartTime;
+static_global u64 batchesSent;
+static_global u64 writesBatched;
+static_global std::map<std::string, LatencyHistogram> latencies;
+
+static_function void RecordLatency(const char *label, f64 startTime, bool success)
+{
+	f64 elapsedMS = (Plat_FloatTime() - startTime) * 1000.0;
+	LatencyHistogram &histogram = latencies[label];
+	histogram.count++;
+	histogram.failures += !success;
+	histogram.totalTime += elapsedMS;
+	histogram.maxTime = MAX(histogram.maxTime, elapsedMS);
+
+	u32 bucket = 0;
+	for (f64 limit = 1.0; elapsedMS >= limit && bucket < KZ_DB_LATENCY_BUCKETS - 1; limit *= 2.0)
+	{
+		bucket++;
+	}
+	histogram.buckets[bucket]++;
+}
+
+void KZDatabaseService::ExecuteTransaction(const char *label, const Transaction &txn, TransactionSuccessCallbackFunc onSuccess,
+										   TransactionFailureCallbackFunc onFailure)
+{
+	f64 startTime = Plat_FloatTime();
+	GetDatabaseConnection()->ExecuteTransaction(
+		txn,
+		[label, startTime, onSuccess](std::vector<ISQLQuery *> queries)
+		{
+			RecordLatency(label, startTime, true);
+			onSuccess(queries);
+		},
+		[label, startTime, onFailure](std::string error, int failIndex)
+		{
+			RecordLatency(label, startTime, false);
+			onFailure(error, failIndex);
+		});
+}
+
+void KZDatabaseService::QueueWrite(const char *label, std::vector<std::string> queries, TransactionSuccessCallbackFunc onSuccess,
+								   TransactionFailureCallbackFunc onFailure, u64 key)
+{
+	if (!KZDatabaseService::IsReady())
+	{
+		return;
+	}
+	if (key != 0)
+	{
+		for (QueuedWrite &write : writeQueue)
+		{
+			if (write.key == key && !V_strcmp(write.label, label))
+			{
+				write.queries = std::move(queries);
+				write.onSuccess = onSuccess;
+				write.onFailure = onFailure;
+				return;
+			}
+		}
+	}
+	if (writeQueue.empty())
+	{
+		writeQueueStartTime = Plat_FloatTime();
+	}
+	writeQueue.push_back({label, key, Plat_FloatTime(), std::move(queries), onSuccess, onFailure});
+	if (writeQueue.size() >= KZ_DB_WRITE_BATCH_SIZE)
+	{
+		KZDatabaseService::FlushWrites(true);
+	}
+}
+
+void KZDatabaseService::FlushWrites(bool force)
+{
+	if (writeQueue.empty() || !KZDatabaseService::IsReady())
+	{
+		return;
+	}
+	if (!force && Plat_FloatTime() - writeQueueStartTime < KZ_DB_WRITE_BATCH_INTERVAL)
+	{
+		return;
+	}
+
+	auto batch = std::make_shared<std::vector<QueuedWrite>>(std::move(writeQueue));
+	writeQueue.clear();
+
+	Transaction txn;
+	for (const QueuedWrite &write : *batch)
+	{
+		txn.queries.insert(txn.queries.end(), write.queries.begin(), write.queries.end());
+	}
+	batchesSent++;
+	writesBatched += batch->size();
+
+	auto onSuccess = [batch](std::vector<ISQLQuery *> queries)
+	{
+		// Every write gets back the results of its own queries only.
+		auto first = queries.begin();
+		for (QueuedWrite &write : *batch)
+		{
+			RecordLatency(write.label, write.queueTime, true);
+			write.onSuccess(std::vector<ISQLQuery *>(first, first + write.queries.size()));
+			first += write.queries.size();
+		}
+	};
+	auto onFailure = [batch](std::string error, int failIndex)
+	{
+		if (batch->size() == 1)
+		{
+			QueuedWrite &write = batch->front();
+			RecordLatency(write.label, write.queueTime, false);
+			write.onFailure(error, failIndex);
+			return;
+		}
+		// The whole batch was rolled back, retry each write on its own so one bad write doesn't take the others down with it.
+		for (QueuedWrite &write : *batch)
+		{
+			Transaction retry;
+			retry.queries = write.queries;
+			const char *label = write.label;
+			f64 queueTime = write.queueTime;
+			auto onSuccess = write.onSuccess;
+			auto onFailure = write.onFailure;
+			GetDatabaseConnection()->ExecuteTransaction(
+				retry,
+				[label, queueTime, onSuccess](std::vector<ISQLQuery *> queries)
+				{
+					RecordLatency(label, queueTime, true);
+					onSuccess(queries);
+				},
+				[label, queueTime, onFailure](std::string error, int failIndex)
+				{
+					RecordLatency(label, queueTime, false);
+					onFailure(error, failIndex);
+				});
+		}
+	};
+	KZDatabaseService::ExecuteTransaction("WriteBatch", txn, onSuccess, onFailure);
+}
+
+static_function SCMD_CALLBACK(Command_KzDBStats)
+{
+	KZPlayer *player = g_pKZPlayerManager->ToPlayer(controller);
+	player->PrintConsole(false, false, "[KZ::DB] %llu write batches, %.1f writes per batch, %i queued", batchesSent,
+						 batchesSent ? (f64)writesBatched / batchesSent : 0.0, (i32)writeQueue.size());
+	player->PrintConsole(false, false, "%-28s %8s %6s %9s %9s  <1ms/2/4/8/16/32/64/128/256/512/1s/2s/4s/more", "Label", "Count", "Fails",
+						 "Avg (ms)", "Max (ms)");
+	for (auto &[label, histogram] : latencies)
+	{
+		char buckets[256] {};
+		for (u32 i = 0; i < KZ_DB_LATENCY_BUCKETS; i++)
+		{
+			V_snprintf(buckets + V_strlen(buckets), sizeof(buckets) - V_strlen(buckets), i ? "/%llu" : "%llu", histogram.buckets[i]);
+		}
+		player->PrintConsole(false, false, "%-28s %8llu %6llu %9.2f %9.2f  %s", label.c_str(), histogram.count, histogram.failures,
+							 histogram.totalTime / histogram.count, histogram.maxTime, buckets);
+	}
+	return MRES_SUPERCEDE;
+}
+
+void KZDatabaseService::RegisterCommands()
+{
+	scmd::RegisterCmd("kz_dbstats", Command_KzDBStats, true);
+}
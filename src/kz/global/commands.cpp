@@ -143,8 +143,21 @@ static_function SCMD_CALLBACK(Command_KzGlobalCheck)
 	return MRES_SUPERCEDE;
 }
 
+static_function SCMD_CALLBACK(Command_KzGlobalStats)
+{
+	KZPlayer *player = g_pKZPlayerManager->ToPlayer(controller);
+	KZGlobalService::SendStats stats = KZGlobalService::GetSendStats();
+
+	player->PrintConsole(false, false, "[KZ::Global] Messages sent: %llu, bytes sent: %llu, flushes: %llu", stats.messagesSent, stats.bytesSent,
+						 stats.flushes);
+	player->PrintConsole(false, false, "[KZ::Global] Queue depth: %u (max %u)", stats.queueDepth, stats.maxQueueDepth);
+
+	return MRES_SUPERCEDE;
+}
+
 void KZGlobalService::RegisterCommands()
 {
 	scmd::RegisterCmd("kz_globalcheck", Command_KzGlobalCheck);
 	scmd::RegisterCmd("kz_gc", Command_KzGlobalCheck);
+	scmd::RegisterCmd("kz_globalstats", Command_KzGlobalStats, true);
 }
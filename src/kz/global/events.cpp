@@ -1,6 +1,351 @@
 #include "events.h"
 
-bool KZ::API::events::MapChange::ToJson(Json &json) const
+/**
+ * Streaming decoder for messages of the form `{ "data": { "records": [...] } }`.
+ */
+class RecordsMessageReader : public JsonSaxReader
+{
+public:
+	RecordsMessageReader(std::vector<KZ::API::Record> &records) : records(records) {}
+
+	bool Finish()
+	{
+		return this->foundRecords && this->depth == 0;
+	}
+
+	bool number_integer(number_integer_t value) override
+	{
+		if (value < 0)
+		{
+			return true;
+		}
+
+		return this->number_unsigned(static_cast<number_unsigned_t>(value));
+	}
+
+	bool number_unsigned(number_unsigned_t value) override
+	{
+		switch (this->CurrentContext())
+		{
+			case Context::Record:
+			{
+				if (this->currentKey == "id")
+				{
+					this->Current().id = static_cast<u32>(value);
+					this->seenFields |= RECORD_ID;
+				}
+				else if (this->currentKey == "teleports")
+				{
+					this->Current().teleports = static_cast<u32>(value);
+					this->seenFields |= RECORD_TELEPORTS;
+				}
+				else if (this->currentKey == "nub_rank")
+				{
+					this->Current().nubRank = static_cast<u32>(value);
+				}
+				else if (this->currentKey == "nub_max_rank")
+				{
+					this->Current().nubMaxRank = static_cast<u32>(value);
+				}
+				else if (this->currentKey == "pro_rank")
+				{
+					this->Current().proRank = static_cast<u32>(value);
+				}
+				else if (this->currentKey == "pro_max_rank")
+				{
+					this->Current().proMaxRank = static_cast<u32>(value);
+				}
+				else
+				{
+					// Whole numbers are valid JSON for float fields too.
+					this->SetFloat(static_cast<f64>(value));
+				}
+			}
+			break;
+
+			case Context::Player:
+			{
+				if (this->currentKey == "id")
+				{
+					this->Current().player.id = value;
+					this->seenFields |= RECORD_PLAYER;
+				}
+			}
+			break;
+
+			case Context::Map:
+			{
+				if (this->currentKey == "id")
+				{
+					this->Current().map.id = static_cast<u16>(value);
+					this->seenFields |= RECORD_MAP;
+				}
+			}
+			break;
+
+			case Context::Course:
+			{
+				if (this->currentKey == "id")
+				{
+					this->Current().course.id = static_cast<u16>(value);
+					this->seenFields |= RECORD_COURSE;
+				}
+			}
+			break;
+
+			default:
+				break;
+		}
+
+		return true;
+	}
+
+	bool number_float(number_float_t value, const string_t &text) override
+	{
+		if (this->CurrentContext() == Context::Record)
+		{
+			this->SetFloat(value);
+		}
+
+		return true;
+	}
+
+	bool string(string_t &value) override
+	{
+		switch (this->CurrentContext())
+		{
+			case Context::Record:
+			{
+				if (this->currentKey == "mode")
+				{
+					if (!KZ::API::DecodeModeString(value, this->Current().mode))
+					{
+						return false;
+					}
+
+					this->seenFields |= RECORD_MODE;
+				}
+			}
+			break;
+
+			case Context::Player:
+			{
+				if (this->currentKey == "id")
+				{
+					// Same as `PlayerInfo::FromJson`, the ID is either a SteamID64 or a SteamID2 string.
+					if (!utils::ParseSteamID2(value, this->Current().player.id))
+					{
+						META_CONPRINTF("[KZ::Global] Failed to parse SteamID2.\n");
+						return false;
+					}
+
+					this->seenFields |= RECORD_PLAYER;
+				}
+				else if (this->currentKey == "name")
+				{
+					this->Current().player.name = std::move(value);
+					this->seenFields |= RECORD_PLAYER_NAME;
+				}
+			}
+			break;
+
+			case Context::Map:
+			{
+				if (this->currentKey == "name")
+				{
+					this->Current().map.name = std::move(value);
+					this->seenFields |= RECORD_MAP_NAME;
+				}
+			}
+			break;
+
+			case Context::Course:
+			{
+				if (this->currentKey == "name")
+				{
+					this->Current().course.name = std::move(value);
+					this->seenFields |= RECORD_COURSE_NAME;
+				}
+			}
+			break;
+
+			default:
+				break;
+		}
+
+		return true;
+	}
+
+	bool key(string_t &value) override
+	{
+		// Reuses the capacity of `currentKey`, so this only allocates for unusually long keys.
+		this->currentKey.assign(value);
+		return true;
+	}
+
+	bool start_object(std::size_t elements) override
+	{
+		Context context = Context::Ignored;
+
+		switch (this->CurrentContext())
+		{
+			case Context::Root:
+				context = Context::Message;
+				break;
+			case Context::Message:
+				context = (this->currentKey == "data") ? Context::Data : Context::Ignored;
+				break;
+			case Context::Records:
+				context = Context::Record;
+				this->records.emplace_back();
+				this->seenFields = 0;
+				break;
+			case Context::Record:
+				if (this->currentKey == "player")
+				{
+					context = Context::Player;
+				}
+				else if (this->currentKey == "map")
+				{
+					context = Context::Map;
+				}
+				else if (this->currentKey == "course")
+				{
+					context = Context::Course;
+				}
+				break;
+			default:
+				break;
+		}
+
+		return this->Push(context);
+	}
+
+	bool end_object() override
+	{
+		if (this->CurrentContext() == Context::Record && (this->seenFields & RECORD_REQUIRED) != RECORD_REQUIRED)
+		{
+			META_CONPRINTF("[KZ::Global] Record is missing required fields.\n");
+			return false;
+		}
+
+		return this->Pop();
+	}
+
+	bool start_array(std::size_t elements) override
+	{
+		if (this->CurrentContext() == Context::Data && this->currentKey == "records")
+		{
+			this->foundRecords = true;
+			return this->Push(Context::Records);
+		}
+
+		return this->Push(Context::Ignored);
+	}
+
+	bool end_array() override
+	{
+		return this->Pop();
+	}
+
+private:
+	enum class Context : u8
+	{
+		Root,
+		Message,
+		Data,
+		Records,
+		Record,
+		Player,
+		Map,
+		Course,
+		Ignored,
+	};
+
+	enum : u16
+	{
+		RECORD_ID = 1 << 0,
+		RECORD_PLAYER = 1 << 1,
+		RECORD_MAP = 1 << 2,
+		RECORD_COURSE = 1 << 3,
+		RECORD_MODE = 1 << 4,
+		RECORD_TELEPORTS = 1 << 5,
+		RECORD_TIME = 1 << 6,
+		RECORD_PLAYER_NAME = 1 << 7,
+		RECORD_MAP_NAME = 1 << 8,
+		RECORD_COURSE_NAME = 1 << 9,
+		RECORD_REQUIRED = (1 << 10) - 1,
+	};
+
+	// Deep enough for the message layout; anything deeper is skipped as a whole.
+	static constexpr i32 MAX_DEPTH = 16;
+
+	std::vector<KZ::API::Record> &records;
+	std::string currentKey;
+	Context contexts[MAX_DEPTH] = {};
+	i32 depth = 0;
+	i32 ignoredDepth = 0;
+	u16 seenFields = 0;
+	bool foundRecords = false;
+
+	Context CurrentContext() const
+	{
+		if (this->ignoredDepth > 0)
+		{
+			return Context::Ignored;
+		}
+
+		return this->depth == 0 ? Context::Root : this->contexts[this->depth - 1];
+	}
+
+	KZ::API::Record &Current()
+	{
+		return this->records.back();
+	}
+
+	void SetFloat(f64 value)
+	{
+		if (this->currentKey == "time")
+		{
+			this->Current().time = value;
+			this->seenFields |= RECORD_TIME;
+		}
+		else if (this->currentKey == "nub_points")
+		{
+			this->Current().nubPoints = value;
+		}
+		else if (this->currentKey == "pro_points")
+		{
+			this->Current().proPoints = value;
+		}
+	}
+
+	bool Push(Context context)
+	{
+		if (this->ignoredDepth > 0 || context == Context::Ignored || this->depth == MAX_DEPTH)
+		{
+			this->ignoredDepth++;
+			return true;
+		}
+
+		this->contexts[this->depth++] = context;
+		return true;
+	}
+
+	bool Pop()
+	{
+		if (this->ignoredDepth > 0)
+		{
+			this->ignoredDepth--;
+			return true;
+		}
+
+		this->depth--;
+		return true;
+	}
+};
+
+bool KZ::API::events::MapChange::ToJson(JsonWriter &json) const
 {
 	return json.Set("new_map", this->mapName);
 }
@@ -10,7 +355,7 @@ bool KZ::API::events::MapInfo::FromJson(const Json &json)
 	return json.Get("map", this->data);
 }
 
-bool KZ::API::events::PlayerJoin::ToJson(Json &json) const
+bool KZ::API::events::PlayerJoin::ToJson(JsonWriter &json) const
 {
 	// clang-format off
 	return json.Set("id", this->steamID)
@@ -24,7 +369,7 @@ bool KZ::API::events::PlayerJoinAck::FromJson(const Json &json)
 	return json.Get("is_banned", this->isBanned) && json.Get("preferences", this->preferences);
 }
 
-bool KZ::API::events::PlayerLeave::ToJson(Json &json) const
+bool KZ::API::events::PlayerLeave::ToJson(JsonWriter &json) const
 {
 	// clang-format off
 	return json.Set("id", this->steamID)
@@ -33,7 +378,7 @@ bool KZ::API::events::PlayerLeave::ToJson(Json &json) const
 	// clang-format on
 }
 
-bool KZ::API::events::NewRecord::ToJson(Json &json) const
+bool KZ::API::events::NewRecord::ToJson(JsonWriter &json) const
 {
 	// clang-format off
 	return json.Set("player_id", this->playerID)
@@ -46,7 +391,7 @@ bool KZ::API::events::NewRecord::ToJson(Json &json) const
 	// clang-format on
 }
 
-bool KZ::API::events::NewRecord::StyleInfo::ToJson(Json &json) const
+bool KZ::API::events::NewRecord::StyleInfo::ToJson(JsonWriter &json) const
 {
 	return json.Set("style", this->name) && json.Set("checksum", this->checksum);
 }
@@ -99,7 +444,7 @@ bool KZ::API::events::NewRecordAck::FromJson(const Json &json)
 	return true;
 }
 
-bool KZ::API::events::WantWorldRecordsForCache::ToJson(Json &json) const
+bool KZ::API::events::WantWorldRecordsForCache::ToJson(JsonWriter &json) const
 {
 	return json.Set("map_id", this->mapID);
 }
@@ -109,6 +454,12 @@ bool KZ::API::events::WorldRecordsForCache::FromJson(const Json &json)
 	return json.Get("records", this->records);
 }
 
+bool KZ::API::events::WorldRecordsForCache::FromMessage(std::string_view message)
+{
+	RecordsMessageReader reader(this->records);
+	return JsonSaxReader::Parse(message, reader) && reader.Finish();
+}
+
 bool KZ::API::events::MapDetails::FromJson(const Json &json)
 {
 	return json.Get("id", this->id) && json.Get("name", this->name);
@@ -146,7 +497,7 @@ bool KZ::API::events::CourseDetails::FromJson(const Json &json)
 	return true;
 }
 
-bool KZ::API::events::WantCourseTop::ToJson(Json &json) const
+bool KZ::API::events::WantCourseTop::ToJson(JsonWriter &json) const
 {
 	// clang-format off
 	return json.Set("map_name", this->mapName)
@@ -167,7 +518,7 @@ bool KZ::API::events::CourseTop::FromJson(const Json &json)
 	// clang-format on
 }
 
-bool KZ::API::events::WantWorldRecords::ToJson(Json &json) const
+bool KZ::API::events::WantWorldRecords::ToJson(JsonWriter &json) const
 {
 	// clang-format off
 	return json.Set("map", this->mapName)
@@ -186,7 +537,7 @@ bool KZ::API::events::WorldRecords::FromJson(const Json &json)
 	// clang-format on
 }
 
-bool KZ::API::events::WantPersonalBest::ToJson(Json &json) const
+bool KZ::API::events::WantPersonalBest::ToJson(JsonWriter &json) const
 {
 	bool success = true;
 
@@ -218,7 +569,7 @@ bool KZ::API::events::PersonalBest::FromJson(const Json &json)
 	// clang-format on
 }
 
-bool KZ::API::events::WantPlayerRecords::ToJson(Json &json) const
+bool KZ::API::events::WantPlayerRecords::ToJson(JsonWriter &json) const
 {
 	return json.Set("map_id", this->mapID) && json.Set("player_id", this->playerID);
 }
@@ -227,3 +578,9 @@ bool KZ::API::events::PlayerRecords::FromJson(const Json &json)
 {
 	return json.Get("records", this->records);
 }
+
+bool KZ::API::events::PlayerRecords::FromMessage(std::string_view message)
+{
+	RecordsMessageReader reader(this->records);
+	return JsonSaxReader::Parse(message, reader) && reader.Finish();
+}
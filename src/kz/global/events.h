@@ -13,7 +13,7 @@ namespace KZ::API::events
 
 		MapChange(std::string_view mapName) : mapName(mapName) {}
 
-		bool ToJson(Json &json) const;
+		bool ToJson(JsonWriter &json) const;
 	};
 
 	struct MapInfo
@@ -29,7 +29,7 @@ namespace KZ::API::events
 		std::string name;
 		std::string ipAddress;
 
-		bool ToJson(Json &json) const;
+		bool ToJson(JsonWriter &json) const;
 	};
 
 	struct PlayerJoinAck
@@ -46,7 +46,7 @@ namespace KZ::API::events
 		std::string name;
 		Json preferences;
 
-		bool ToJson(Json &json) const;
+		bool ToJson(JsonWriter &json) const;
 	};
 
 	struct NewRecord
@@ -56,7 +56,7 @@ namespace KZ::API::events
 			std::string_view name;
 			std::string_view checksum;
 
-			bool ToJson(Json &json) const;
+			bool ToJson(JsonWriter &json) const;
 		};
 
 		u64 playerID;
@@ -67,7 +67,7 @@ namespace KZ::API::events
 		std::vector<StyleInfo> styles;
 		std::string_view metadata;
 
-		bool ToJson(Json &json) const;
+		bool ToJson(JsonWriter &json) const;
 	};
 
 	struct NewRecordAck
@@ -91,7 +91,7 @@ namespace KZ::API::events
 	{
 		u16 mapID;
 
-		bool ToJson(Json &json) const;
+		bool ToJson(JsonWriter &json) const;
 	};
 
 	struct WorldRecordsForCache
@@ -99,6 +99,9 @@ namespace KZ::API::events
 		std::vector<KZ::API::Record> records {};
 
 		bool FromJson(const Json &json);
+
+		// Decodes the `data` field of a whole message without building a `Json` tree.
+		bool FromMessage(std::string_view message);
 	};
 
 	struct MapDetails
@@ -127,7 +130,7 @@ namespace KZ::API::events
 		u32 limit;
 		u32 offset;
 
-		bool ToJson(Json &json) const;
+		bool ToJson(JsonWriter &json) const;
 	};
 
 	struct CourseTop
@@ -146,7 +149,7 @@ namespace KZ::API::events
 		std::string_view courseNameOrNumber;
 		Mode mode;
 
-		bool ToJson(Json &json) const;
+		bool ToJson(JsonWriter &json) const;
 	};
 
 	struct WorldRecords
@@ -168,7 +171,7 @@ namespace KZ::API::events
 		Mode mode;
 		std::vector<std::string> styles;
 
-		bool ToJson(Json &json) const;
+		bool ToJson(JsonWriter &json) const;
 	};
 
 	struct PersonalBest
@@ -187,7 +190,7 @@ namespace KZ::API::events
 		u16 mapID;
 		u64 playerID;
 
-		bool ToJson(Json &json) const;
+		bool ToJson(JsonWriter &json) const;
 	};
 
 	struct PlayerRecords
@@ -195,5 +198,8 @@ namespace KZ::API::events
 		std::vector<Record> records {};
 
 		bool FromJson(const Json &json);
+
+		// Decodes the `data` field of a whole message without building a `Json` tree.
+		bool FromMessage(std::string_view message);
 	};
 } // namespace KZ::API::events
@@ -1,6 +1,6 @@
 #include "handshake.h"
 
-bool KZ::API::handshake::Hello::ToJson(Json &json) const
+bool KZ::API::handshake::Hello::ToJson(JsonWriter &json) const
 {
 	// clang-format off
 	return json.Set("plugin_version", VERSION_STRING)
@@ -10,7 +10,7 @@ bool KZ::API::handshake::Hello::ToJson(Json &json) const
 	// clang-format on
 }
 
-bool KZ::API::handshake::Hello::PlayerInfo::ToJson(Json &json) const
+bool KZ::API::handshake::Hello::PlayerInfo::ToJson(JsonWriter &json) const
 {
 	return json.Set("id", this->id) && json.Set("name", this->name);
 }
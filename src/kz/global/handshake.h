@@ -15,7 +15,7 @@ namespace KZ::API::handshake
 			u64 id;
 			std::string_view name;
 
-			bool ToJson(Json &json) const;
+			bool ToJson(JsonWriter &json) const;
 		};
 
 		std::string_view checksum;
@@ -29,7 +29,7 @@ namespace KZ::API::handshake
 			this->players[id] = {id, name};
 		}
 
-		bool ToJson(Json &json) const;
+		bool ToJson(JsonWriter &json) const;
 	};
 
 	struct HelloAck
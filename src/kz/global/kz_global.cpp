@@ -157,6 +157,9 @@ void KZGlobalService::Cleanup()
 
 	KZGlobalService::RestoreConVars();
 
+	// Whatever is still queued (e.g. `player-leave` events from the shutdown) goes out before the socket closes.
+	KZGlobalService::FlushMessages();
+
 	if (KZGlobalService::socket != nullptr)
 	{
 		KZGlobalService::socket->stop();
@@ -166,6 +169,23 @@ void KZGlobalService::Cleanup()
 
 	KZGlobalService::state.store(KZGlobalService::State::Uninitialized);
 
+	{
+		std::unique_lock lock(KZGlobalService::outgoingMessages.mutex);
+
+		for (std::vector<std::string> &queue : KZGlobalService::outgoingMessages.queues)
+		{
+			queue.clear();
+		}
+
+		KZGlobalService::sendStats.queueDepth.store(0);
+	}
+
+	// No responses can arrive on a closed socket, so none of the pending handlers will ever run.
+	{
+		std::unique_lock lock(KZGlobalService::messageCallbacks.mutex);
+		KZGlobalService::messageCallbacks.queue.clear();
+	}
+
 	ix::uninitNetSystem();
 }
 
@@ -194,6 +214,70 @@ void KZGlobalService::OnServerGamePostSimulate()
 	{
 		callback();
 	}
+
+	// Callbacks above may have queued more messages, so flush afterwards.
+	KZGlobalService::FlushMessages();
+}
+
+KZGlobalService::SendStats KZGlobalService::GetSendStats()
+{
+	return {
+		KZGlobalService::sendStats.messagesSent.load(), KZGlobalService::sendStats.bytesSent.load(), KZGlobalService::sendStats.flushes.load(),
+		KZGlobalService::sendStats.queueDepth.load(),   KZGlobalService::sendStats.maxQueueDepth.load(),
+	};
+}
+
+void KZGlobalService::QueueMessage(std::string_view event, std::string message)
+{
+	std::unique_lock lock(KZGlobalService::outgoingMessages.mutex);
+	KZGlobalService::outgoingMessages.queues[static_cast<int>(KZGlobalService::GetMessagePriority(event))].emplace_back(std::move(message));
+	u32 queueDepth = ++KZGlobalService::sendStats.queueDepth;
+
+	// Only updated under the lock, so the check and the store can't interleave with another queuer.
+	if (queueDepth > KZGlobalService::sendStats.maxQueueDepth.load())
+	{
+		KZGlobalService::sendStats.maxQueueDepth.store(queueDepth);
+	}
+}
+
+void KZGlobalService::FlushMessages()
+{
+	std::vector<std::string> queues[static_cast<int>(MessagePriority::Count)];
+
+	{
+		std::unique_lock lock(KZGlobalService::outgoingMessages.mutex);
+
+		if (KZGlobalService::sendStats.queueDepth.load() == 0)
+		{
+			return;
+		}
+
+		for (int i = 0; i < static_cast<int>(MessagePriority::Count); i++)
+		{
+			KZGlobalService::outgoingMessages.queues[i].swap(queues[i]);
+		}
+
+		KZGlobalService::sendStats.queueDepth.store(0);
+	}
+
+	if (KZGlobalService::socket == nullptr)
+	{
+		return;
+	}
+
+	KZGlobalService::sendStats.flushes++;
+
+	for (const std::vector<std::string> &queue : queues)
+	{
+		for (const std::string &message : queue)
+		{
+			if (KZGlobalService::socket->send(message).success)
+			{
+				KZGlobalService::sendStats.messagesSent++;
+				KZGlobalService::sendStats.bytesSent += message.size();
+			}
+		}
+	}
 }
 
 void KZGlobalService::OnActivateServer()
@@ -395,6 +479,8 @@ void KZGlobalService::OnClientDisconnect()
 	{
 		case KZGlobalService::State::HandshakeCompleted:
 			KZGlobalService::SendMessage(event, data);
+			// The server stops simulating once the last player is gone, so don't wait for the end of the frame.
+			KZGlobalService::FlushMessages();
 			break;
 
 		default:
@@ -483,12 +569,11 @@ void KZGlobalService::OnWebSocketMessage(const ix::WebSocketMessagePtr &message)
 		{
 			META_CONPRINTF("[KZ::Global] Received WebSocket message:\n-----\n%s\n------\n", message->str.substr(0, 1024).c_str());
 
-			Json payload(message->str);
-
 			switch (KZGlobalService::state.load())
 			{
 				case KZGlobalService::State::HandshakeInitiated:
 				{
+					Json payload(message->str);
 					KZ::API::handshake::HelloAck helloAck;
 
 					if (!helloAck.FromJson(payload))
@@ -503,21 +588,15 @@ void KZGlobalService::OnWebSocketMessage(const ix::WebSocketMessagePtr &message)
 
 				case KZGlobalService::State::HandshakeCompleted:
 				{
-					if (!payload.IsValid())
-					{
-						META_CONPRINTF("[KZ::Global] WebSocket message is not valid JSON.\n");
-						break;
-					}
-
 					u32 messageID = 0;
 
-					if (!payload.Get("id", messageID))
+					if (!KZGlobalService::ReadMessageID(message->str, messageID))
 					{
 						META_CONPRINTF("[KZ::Global] Ignoring message without valid ID\n");
 						break;
 					}
 
-					KZGlobalService::AddMainThreadCallback([=]() { KZGlobalService::ExecuteMessageCallback(messageID, payload); });
+					KZGlobalService::ExecuteMessageCallback(messageID, message->str);
 				}
 				break;
 			}
@@ -606,23 +685,99 @@ void KZGlobalService::CompleteHandshake(KZ::API::handshake::HelloAck &ack)
 	META_CONPRINTF("[KZ::Global] Completed handshake!\n");
 }
 
-void KZGlobalService::ExecuteMessageCallback(u32 messageID, const Json &payload)
+bool KZGlobalService::ReadMessageID(std::string_view message, u32 &messageID)
+{
+	class Reader : public JsonSaxReader
+	{
+	public:
+		u32 messageID = 0;
+		bool found = false;
+
+		bool number_unsigned(number_unsigned_t value) override
+		{
+			if (this->depth == 1 && this->isIDKey)
+			{
+				this->messageID = static_cast<u32>(value);
+				this->found = true;
+
+				// Stop right away, we don't care about the rest of the message.
+				return false;
+			}
+
+			return true;
+		}
+
+		bool key(string_t &value) override
+		{
+			this->isIDKey = (value == "id");
+			return true;
+		}
+
+		bool start_object(std::size_t elements) override
+		{
+			this->depth++;
+			return true;
+		}
+
+		bool end_object() override
+		{
+			this->depth--;
+			return true;
+		}
+
+		bool start_array(std::size_t elements) override
+		{
+			this->depth++;
+			return true;
+		}
+
+		bool end_array() override
+		{
+			this->depth--;
+			return true;
+		}
+
+	private:
+		i32 depth = 0;
+		bool isIDKey = false;
+	};
+
+	Reader reader;
+	JsonSaxReader::Parse(message, reader);
+
+	if (!reader.found)
+	{
+		return false;
+	}
+
+	messageID = reader.messageID;
+	return true;
+}
+
+void KZGlobalService::ExecuteMessageCallback(u32 messageID, const std::string &message)
 {
-	std::function<void(u32, const Json &)> callback;
+	MessageHandler handler;
 
 	{
 		std::unique_lock lock(KZGlobalService::messageCallbacks.mutex);
-		std::unordered_map<u32, std::function<void(u32, const Json &)>> &callbacks = KZGlobalService::messageCallbacks.queue;
+		std::unordered_map<u32, MessageHandler> &handlers = KZGlobalService::messageCallbacks.queue;
 
-		if (auto found = callbacks.extract(messageID); !found.empty())
+		if (auto found = handlers.extract(messageID); !found.empty())
 		{
-			callback = found.mapped();
+			handler = std::move(found.mapped());
 		}
 	}
 
+	if (!handler)
+	{
+		return;
+	}
+
+	std::function<void()> callback = handler(messageID, message);
+
 	if (callback)
 	{
-		META_CONPRINTF("[KZ::Global] Executing callback #%i\n", messageID);
-		callback(messageID, payload);
+		META_CONPRINTF("[KZ::Global] Queueing callback #%i\n", messageID);
+		KZGlobalService::AddMainThreadCallback(std::move(callback));
 	}
 }
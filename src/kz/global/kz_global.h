@@ -95,6 +95,20 @@ public:
 	static void OnServerGamePostSimulate();
 	static void OnActivateServer();
 
+	/**
+	 * Counters about the messages we send to the API.
+	 */
+	struct SendStats
+	{
+		u64 messagesSent;
+		u64 bytesSent;
+		u64 flushes;
+		u32 queueDepth;
+		u32 maxQueueDepth;
+	};
+
+	static SendStats GetSendStats();
+
 public:
 	void OnPlayerAuthorized();
 	void OnClientDisconnect();
@@ -306,15 +320,20 @@ private:
 	static inline std::atomic<u32> nextMessageID = 1;
 
 	/**
-	 * Callbacks to execute when we receive responses to messages we sent earlier.
+	 * Decodes the response to a message and returns the callback to run on the main thread, if any.
+	 */
+	using MessageHandler = std::function<std::function<void()>(u32, const std::string &)>;
+
+	/**
+	 * Handlers to execute when we receive responses to messages we sent earlier.
 	 *
-	 * The key is the message ID we're looking for, and the callback will be
-	 * invoked with that message ID and the payload.
+	 * The key is the message ID we're looking for, and the handler will be
+	 * invoked on the WebSocket thread with that message ID and the payload.
 	 */
 	static inline struct
 	{
 		std::mutex mutex;
-		std::unordered_map<u32, std::function<void(u32, const Json &)>> queue;
+		std::unordered_map<u32, MessageHandler> queue;
 	} messageCallbacks {};
 
 	/**
@@ -344,6 +363,76 @@ private:
 		std::vector<KZ::API::handshake::HelloAck::StyleInfo> data;
 	} globalStyles;
 
+	/**
+	 * Order in which queued messages are sent at the end of a frame.
+	 */
+	enum class MessagePriority
+	{
+		/**
+		 * Messages that should never wait behind anything else, like new records.
+		 */
+		High,
+
+		/**
+		 * Regular requests and events.
+		 */
+		Normal,
+
+		/**
+		 * Bulk requests, like cache refreshes or fetching records of joining players.
+		 */
+		Low,
+
+		Count,
+	};
+
+	static MessagePriority GetMessagePriority(std::string_view event)
+	{
+		if (event == "new-record")
+		{
+			return MessagePriority::High;
+		}
+
+		if (event == "want-world-records-for-cache" || event == "want-player-records")
+		{
+			return MessagePriority::Low;
+		}
+
+		return MessagePriority::Normal;
+	}
+
+	/**
+	 * Serialized messages waiting to be sent, one queue per priority.
+	 *
+	 * Flushed once per frame in `OnServerGamePostSimulate()`, and right away for `player-leave` and on cleanup.
+	 */
+	static inline struct
+	{
+		std::mutex mutex;
+		std::vector<std::string> queues[static_cast<int>(MessagePriority::Count)];
+	} outgoingMessages {};
+
+	static inline struct
+	{
+		std::atomic<u64> messagesSent;
+		std::atomic<u64> bytesSent;
+		std::atomic<u64> flushes;
+		std::atomic<u32> queueDepth;
+		std::atomic<u32> maxQueueDepth;
+	} sendStats {};
+
+	/**
+	 * Queues a serialized message to be sent at the end of the frame.
+	 */
+	static void QueueMessage(std::string_view event, std::string message);
+
+	/**
+	 * Sends all queued messages, highest priority first.
+	 *
+	 * Has to be called from the main thread.
+	 */
+	static void FlushMessages();
+
 	static void EnforceConVars();
 	static void RestoreConVars();
 
@@ -389,9 +478,9 @@ private:
 	}
 
 	/**
-	 * Queues a callback to be executed when we receive a message with the given ID.
+	 * Queues a handler to be executed when we receive a message with the given ID.
 	 *
-	 * The callback will be executed on the main thread.
+	 * The handler is executed on the WebSocket thread, the callback it returns on the main thread.
 	 */
 	template<typename CB>
 	static void AddMessageCallback(u32 messageID, CB &&callback)
@@ -401,18 +490,59 @@ private:
 	}
 
 	/**
-	 * Executes the callback with the given ID, if any.
+	 * Reads the top-level `id` field of a message without decoding the rest of it.
+	 */
+	static bool ReadMessageID(std::string_view message, u32 &messageID);
+
+	/**
+	 * Decodes the message for the handler with the given ID, if any, and queues its result on the main thread.
 	 *
-	 * The callback will be executed on the main thread.
+	 * Called from the WebSocket thread, so the main thread never has to decode anything.
 	 */
-	static void ExecuteMessageCallback(u32 messageID, const Json &payload);
+	static void ExecuteMessageCallback(u32 messageID, const std::string &message);
+
+	template<typename T, typename = void>
+	struct HasStreamingDecoder : std::false_type
+	{
+	};
+
+	template<typename T>
+	struct HasStreamingDecoder<T, std::void_t<decltype(std::declval<T &>().FromMessage(std::string_view()))>> : std::true_type
+	{
+	};
+
+	/**
+	 * Decodes the `data` field of a message.
+	 *
+	 * Types with a `FromMessage()` decoder are read straight from the text, everything else goes through `Json`.
+	 */
+	template<typename T>
+	static bool DecodeMessage(const std::string &message, T &decoded)
+	{
+		if constexpr (HasStreamingDecoder<T>::value)
+		{
+			return decoded.FromMessage(message);
+		}
+		else
+		{
+			Json payload(message);
+
+			if (!payload.IsValid())
+			{
+				META_CONPRINTF("[KZ::Global] WebSocket message is not valid JSON.\n");
+				return false;
+			}
+
+			return payload.Get("data", decoded);
+		}
+	}
 
 	/**
 	 * Prepares a message to be sent to the API.
 	 *
 	 * Note: we specialize `handshake::Hello` here because the format is slightly different from all other messages
 	 */
-	static bool PrepareMessage(std::string_view event, u32 messageID, const KZ::API::handshake::Hello &data, Json &payload)
+	static bool PrepareMessage(std::string_view event, u32 messageID, const KZ::API::handshake::Hello &data, JsonWriter &payload)
 	{
 		if (KZGlobalService::state.load() != State::Connected)
 		{
@@ -420,14 +550,18 @@ private:
 			return false;
 		}
 
-		return payload.Set("id", messageID) && data.ToJson(payload);
+		payload.BeginObject();
+		bool success = payload.Set("id", messageID) && data.ToJson(payload);
+		payload.EndObject();
+
+		return success;
 	}
 
 	/**
 	 * Prepares a message to be sent to the API.
 	 */
 	template<typename T>
-	static bool PrepareMessage(std::string_view event, u32 messageID, const T &data, Json &payload)
+	static bool PrepareMessage(std::string_view event, u32 messageID, const T &data, JsonWriter &payload)
 	{
 		if (KZGlobalService::state.load() != State::HandshakeCompleted)
 		{
@@ -435,12 +569,16 @@ private:
 			return false;
 		}
 
+		payload.BeginObject();
+
 		// clang-format off
 		bool success = payload.Set("id", messageID)
 			&& payload.Set("event", event)
 			&& payload.Set("data", data);
 		// clang-format on
 
+		payload.EndObject();
+
 		if (!success)
 		{
 			META_CONPRINTF("[KZ::Global] Failed to serialize message for event `%s`.\n", event);
@@ -455,14 +593,14 @@ private:
 	template<typename T>
 	static bool SendMessage(std::string_view event, const T &data)
 	{
-		Json payload;
+		JsonWriter &payload = JsonWriter::ForCurrentThread();
 
 		if (!KZGlobalService::PrepareMessage(event, KZGlobalService::nextMessageID++, data, payload))
 		{
 			return false;
 		}
 
-		KZGlobalService::socket->send(payload.ToString());
+		KZGlobalService::QueueMessage(event, payload.TakeBuffer());
 		return true;
 	}
 
@@ -473,7 +611,7 @@ private:
 	static bool SendMessage(std::string_view event, const T &data, CB &&callback)
 	{
 		u32 messageID = KZGlobalService::nextMessageID++;
-		Json payload;
+		JsonWriter &payload = JsonWriter::ForCurrentThread();
 
 		if (!KZGlobalService::PrepareMessage(event, messageID, data, payload))
 		{
@@ -481,27 +619,22 @@ private:
 		}
 
 		// clang-format off
-		KZGlobalService::AddMessageCallback(messageID, [callback = std::move(callback)](u32 messageID, const Json& payload)
+		KZGlobalService::AddMessageCallback(messageID, [callback = std::move(callback)](u32 messageID, const std::string& message) mutable -> std::function<void()>
 		{
-			if (!payload.IsValid())
-			{
-				META_CONPRINTF("[KZ::Global] WebSocket message is not valid JSON.\n");
-				return;
-			}
-
 			std::remove_reference_t<typename decltype(std::function(callback))::argument_type> decoded;
 
-			if (!payload.Get("data", decoded))
+			if (!KZGlobalService::DecodeMessage(message, decoded))
 			{
 				META_CONPRINTF("[KZ::Global] WebSocket message does not contain a valid `data` field.\n");
-				return;
+				return nullptr;
 			}
 
-			callback(decoded);
+			// Handlers only ever run once, so both can be moved into the main thread callback.
+			return [callback = std::move(callback), decoded = std::move(decoded)]() mutable { callback(decoded); };
 		});
 		// clang-format on
 
-		KZGlobalService::socket->send(payload.ToString());
+		KZGlobalService::QueueMessage(event, payload.TakeBuffer());
 		return true;
 	}
 };
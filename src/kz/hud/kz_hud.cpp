@@ -2,6 +2,7 @@
 #include "cs2kz.h"
 #include "kz_hud.h"
 #include "sdk/datatypes.h"
+#include "sdk/recipientfilters.h"
 #include "utils/utils.h"
 #include "utils/simplecmds.h"
 
@@ -10,6 +11,8 @@
 #include "kz/language/kz_language.h"
 #include "kz/checkpoint/kz_checkpoint.h"
 
+#include "vprof.h"
+
 #include "tier0/memdbgon.h"
 
 #define HUD_ON_GROUND_THRESHOLD 0.07f
@@ -28,129 +31,380 @@ static_global class KZOptionServiceEventListener_HUD : public KZOptionServiceEve
 	}
 } optionEventListener;
 
+// Resolved once, these are formatted for every player and spectator each tick.
+static_global KZPhrase speedTextTakeoffPhrase("HUD - Speed Text (Takeoff)");
+static_global KZPhrase speedTextPhrase("HUD - Speed Text");
+static_global KZPhrase keyTextPhrase("HUD - Key Text");
+static_global KZPhrase checkpointTextPhrase("HUD - Checkpoint Text");
+static_global KZPhrase timerTextPhrase("HUD - Timer Text");
+static_global KZPhrase stoppedTextPhrase("HUD - Stopped Text");
+static_global KZPhrase pausedTextPhrase("HUD - Paused Text");
+static_global KZPhrase centerTextPhrase("HUD - Center Text");
+static_global KZPhrase alertTextPhrase("HUD - Alert Text");
+static_global KZPhrase htmlTextPhrase("HUD - Html Center Text");
+
+static_global const char *updateIntervalOptions[HUDPANEL_COUNT] = {"hudCentreUpdateInterval", "hudAlertUpdateInterval", "hudHtmlUpdateInterval"};
+
+static_global struct
+{
+	f64 updateInterval[HUDPANEL_COUNT];
+	f64 refreshInterval = KZ_DEFAULT_HUD_REFRESH_INTERVAL;
+} hudSettings;
+
+static_global struct
+{
+	HUDStats totals;
+	u64 windowBytes;
+	f64 windowStart;
+} hudStats;
+
+// Players with a panel queued this tick, see FlushPanels.
+static_global CUtlVector<KZPlayer *> pendingTargets;
+
+// Order of the key segment, one bit each in HUDPanelState::buttons.
+static_global const InputBitMask_t keyButtons[] = {IN_MOVELEFT, IN_FORWARD, IN_BACK, IN_MOVERIGHT, IN_DUCK, IN_JUMP};
+static_global const char keyLetters[] = {'A', 'W', 'S', 'D', 'C', 'J'};
+
 void KZHUDService::Init()
 {
 	KZTimerService::RegisterEventListener(&timerEventListener);
 	KZOptionService::RegisterEventListener(&optionEventListener);
 }
 
+void KZHUDService::InitSettings()
+{
+	for (u32 i = 0; i < HUDPANEL_COUNT; i++)
+	{
+		hudSettings.updateInterval[i] = KZOptionService::GetOptionFloat(updateIntervalOptions[i], 0.0f);
+	}
+	hudSettings.refreshInterval = KZOptionService::GetOptionFloat("hudRefreshInterval", KZ_DEFAULT_HUD_REFRESH_INTERVAL);
+}
+
+HUDStats KZHUDService::GetStats()
+{
+	return hudStats.totals;
+}
+
 void KZHUDService::Reset()
 {
 	this->showPanel = this->player->optionService->GetPreferenceBool("showPanel", true);
 	this->timerStoppedTime = {};
 	this->currentTimeWhenTimerStopped = {};
+	this->renders.clear();
+	this->ResetSentPanels();
+}
+
+void KZHUDService::ResetSentPanels()
+{
+	for (u32 i = 0; i < HUDPANEL_COUNT; i++)
+	{
+		this->panels[i] = {};
+	}
 }
 
-std::string KZHUDService::GetSpeedText(const char *language)
+HUDPanelState KZHUDService::GetPanelState()
 {
+	HUDPanelState state {};
+
+	for (u32 i = 0; i < Q_ARRAYSIZE(keyButtons); i++)
+	{
+		if (this->player->IsButtonPressed(keyButtons[i]))
+		{
+			state.buttons |= 1 << i;
+		}
+	}
+
+	state.currentCpIndex = this->player->checkpointService->GetCurrentCpIndex();
+	state.checkpointCount = this->player->checkpointService->GetCheckpointCount();
+	state.teleportCount = this->player->checkpointService->GetTeleportCount();
+
 	Vector velocity;
 	this->player->GetVelocity(&velocity);
+	state.speed = RoundFloatToInt(velocity.Length2D());
+	state.takeoffSpeed = -1;
 	// Keep the takeoff velocity on for a while after landing so the speed values flicker less.
-	if ((this->player->GetPlayerPawn()->m_fFlags & FL_ONGROUND
-		 && g_pKZUtils->GetServerGlobals()->curtime - this->player->landingTime > HUD_ON_GROUND_THRESHOLD)
-		|| (this->player->GetPlayerPawn()->m_MoveType == MOVETYPE_LADDER && !player->IsButtonPressed(IN_JUMP)))
+	if (!((this->player->GetPlayerPawn()->m_fFlags & FL_ONGROUND
+		   && g_pKZUtils->GetServerGlobals()->curtime - this->player->landingTime > HUD_ON_GROUND_THRESHOLD)
+		  || (this->player->GetPlayerPawn()->m_MoveType == MOVETYPE_LADDER && !player->IsButtonPressed(IN_JUMP))))
 	{
-		return KZLanguageService::PrepareMessageWithLang(language, "HUD - Speed Text", velocity.Length2D());
+		state.takeoffSpeed = RoundFloatToInt(this->player->takeoffVelocity.Length2D());
 	}
-	return KZLanguageService::PrepareMessageWithLang(language, "HUD - Speed Text (Takeoff)", velocity.Length2D(),
-													 this->player->takeoffVelocity.Length2D());
+
+	state.timerRunning = this->player->timerService->GetTimerRunning();
+	state.timerPaused = this->player->timerService->GetPaused();
+	state.time = -1;
+	if (state.timerRunning || this->ShouldShowTimerAfterStop())
+	{
+		f64 time = state.timerRunning ? this->player->timerService->GetTime() : this->currentTimeWhenTimerStopped;
+		state.time = RoundFloatToInt(time * 1000);
+	}
+	return state;
 }
 
-std::string KZHUDService::GetKeyText(const char *language)
+std::string KZHUDService::GetSpeedText(const HUDPanelState &state, const char *language)
 {
+	if (state.takeoffSpeed < 0)
+	{
+		return KZLanguageService::PrepareMessageWithLang(language, speedTextPhrase, (f32)state.speed);
+	}
+	return KZLanguageService::PrepareMessageWithLang(language, speedTextTakeoffPhrase, (f32)state.speed, (f32)state.takeoffSpeed);
+}
+
+std::string KZHUDService::GetKeyText(const HUDPanelState &state, const char *language)
+{
+	char keys[Q_ARRAYSIZE(keyLetters)];
+	for (u32 i = 0; i < Q_ARRAYSIZE(keyLetters); i++)
+	{
+		keys[i] = state.buttons & (1 << i) ? keyLetters[i] : '_';
+	}
+
 	// clang-format off
 
-	return KZLanguageService::PrepareMessageWithLang(language, "HUD - Key Text",
-		this->player->IsButtonPressed(IN_MOVELEFT) ? 'A' : '_',
-		this->player->IsButtonPressed(IN_FORWARD) ? 'W' : '_',
-		this->player->IsButtonPressed(IN_BACK) ? 'S' : '_',
-		this->player->IsButtonPressed(IN_MOVERIGHT) ? 'D' : '_',
-		this->player->IsButtonPressed(IN_DUCK) ? 'C' : '_',
-		this->player->IsButtonPressed(IN_JUMP) ? 'J' : '_'
+	return KZLanguageService::PrepareMessageWithLang(language, keyTextPhrase,
+		keys[0], keys[1], keys[2], keys[3], keys[4], keys[5]
 	);
 
 	// clang-format on
 }
 
-std::string KZHUDService::GetCheckpointText(const char *language)
+std::string KZHUDService::GetCheckpointText(const HUDPanelState &state, const char *language)
 {
+	return KZLanguageService::PrepareMessageWithLang(language, checkpointTextPhrase, state.currentCpIndex, state.checkpointCount,
+													 state.teleportCount);
+}
+
+std::string KZHUDService::GetTimerText(const HUDPanelState &state, const char *language)
+{
+	if (state.time < 0)
+	{
+		return std::string("");
+	}
+
+	char timeText[128];
+	KZTimerService::FormatTime(state.time / 1000.0, timeText, sizeof(timeText));
+
 	// clang-format off
 
-	return KZLanguageService::PrepareMessageWithLang(language, "HUD - Checkpoint Text",
-		this->player->checkpointService->GetCurrentCpIndex(),
-		this->player->checkpointService->GetCheckpointCount(),
-		this->player->checkpointService->GetTeleportCount()
+	return KZLanguageService::PrepareMessageWithLang(language, timerTextPhrase,
+		timeText,
+		state.timerRunning ? "" : KZLanguageService::PrepareMessageWithLang(language, stoppedTextPhrase).c_str(),
+		state.timerPaused ? KZLanguageService::PrepareMessageWithLang(language, pausedTextPhrase).c_str() : ""
 	);
 
 	// clang-format on
 }
 
-std::string KZHUDService::GetTimerText(const char *language)
+i32 KZHUDService::RenderPanels(const char *language)
 {
-	if (this->player->timerService->GetTimerRunning() || this->ShouldShowTimerAfterStop())
+	i32 index = 0;
+	for (; index < (i32)this->renders.size(); index++)
 	{
-		char timeText[128];
+		if (this->renders[index].language == language)
+		{
+			break;
+		}
+	}
 
-		// clang-format off
+	bool rebuild = index == (i32)this->renders.size();
+	if (rebuild)
+	{
+		this->renders.emplace_back();
+		this->renders[index].language = language;
+	}
 
-		f64 time = this->player->timerService->GetTimerRunning()
-			? player->timerService->GetTime()
-			: this->currentTimeWhenTimerStopped;
+	HUDRender &render = this->renders[index];
+	i32 tick = g_pKZUtils->GetGlobals()->tickcount;
+	if (!rebuild && render.tick == tick)
+	{
+		return index;
+	}
+	render.tick = tick;
 
+	HUDPanelState state = this->GetPanelState();
+	bool changed = rebuild;
+	if (rebuild || state.buttons != render.state.buttons)
+	{
+		render.keyText = GetKeyText(state, language);
+		changed = true;
+	}
+	if (rebuild || state.currentCpIndex != render.state.currentCpIndex || state.checkpointCount != render.state.checkpointCount
+		|| state.teleportCount != render.state.teleportCount)
+	{
+		render.checkpointText = GetCheckpointText(state, language);
+		changed = true;
+	}
+	if (rebuild || state.time != render.state.time || state.timerRunning != render.state.timerRunning
+		|| state.timerPaused != render.state.timerPaused)
+	{
+		render.timerText = GetTimerText(state, language);
+		changed = true;
+	}
+	if (rebuild || state.speed != render.state.speed || state.takeoffSpeed != render.state.takeoffSpeed)
+	{
+		render.speedText = GetSpeedText(state, language);
+		changed = true;
+	}
+	render.state = state;
 
-		KZTimerService::FormatTime(time, timeText, sizeof(timeText));
-		return KZLanguageService::PrepareMessageWithLang(language, "HUD - Timer Text",
-			timeText,
-			player->timerService->GetTimerRunning() ? "" : KZLanguageService::PrepareMessageWithLang(language, "HUD - Stopped Text").c_str(),
-			player->timerService->GetPaused() ? KZLanguageService::PrepareMessageWithLang(language, "HUD - Paused Text").c_str() : ""
-		);
+	if (!changed)
+	{
+		return index;
+	}
+
+	static_persist KZPhrase *panelPhrases[HUDPANEL_COUNT] = {&centerTextPhrase, &alertTextPhrase, &htmlTextPhrase};
+	for (u32 i = 0; i < HUDPANEL_COUNT; i++)
+	{
+		// clang-format off
+		std::string &text = render.panels[i];
+		text = KZLanguageService::PrepareMessageWithLang(language, *panelPhrases[i],
+			render.keyText.c_str(), render.checkpointText.c_str(), render.timerText.c_str(), render.speedText.c_str());
 		// clang-format on
+
+		// Remove trailing newlines just in case a line is empty.
+		text.erase(text.find_last_not_of('\n') + 1);
 	}
-	return std::string("");
+	return index;
+}
+
+bool KZHUDService::IsPanelDue(HUDPanelType type, const std::string &text, f64 now)
+{
+	if (text.empty())
+	{
+		return false;
+	}
+
+	f64 elapsed = now - this->panels[type].lastSendTime;
+	if (text == this->panels[type].sentText && elapsed < hudSettings.refreshInterval)
+	{
+		hudStats.totals.identicalSkipped++;
+		return false;
+	}
+	if (elapsed < hudSettings.updateInterval[type])
+	{
+		hudStats.totals.rateLimited++;
+		return false;
+	}
+	return true;
 }
 
 void KZHUDService::DrawPanels(KZPlayer *player, KZPlayer *target)
 {
+	VPROF_BUDGET(__func__, "CS2KZ");
+
 	if (!target->hudService->IsShowingPanel())
 	{
 		return;
 	}
-	const char *language = target->languageService->GetLanguage();
 
-	std::string keyText = player->hudService->GetKeyText(language);
-	std::string checkpointText = player->hudService->GetCheckpointText(language);
-	std::string timerText = player->hudService->GetTimerText(language);
-	std::string speedText = player->hudService->GetSpeedText(language);
+	if (!target->hudService->pendingObserved)
+	{
+		pendingTargets.AddToTail(target);
+	}
+	target->hudService->pendingObserved = player;
+	target->hudService->pendingRender = player->hudService->RenderPanels(target->languageService->GetLanguage());
+}
 
-	// clang-format off
-	std::string centerText = KZLanguageService::PrepareMessageWithLang(language, "HUD - Center Text", 
-		keyText.c_str(), checkpointText.c_str(), timerText.c_str(), speedText.c_str());
-	std::string alertText = KZLanguageService::PrepareMessageWithLang(language, "HUD - Alert Text", 
-		keyText.c_str(), checkpointText.c_str(), timerText.c_str(), speedText.c_str());
-	std::string htmlText = KZLanguageService::PrepareMessageWithLang(language, "HUD - Html Center Text",
-		keyText.c_str(), checkpointText.c_str(), timerText.c_str(), speedText.c_str());
+const KZHUDService::HUDRender *KZHUDService::GetPendingRender()
+{
+	// The observed player might have been reset since the panel was queued.
+	if (!this->pendingObserved || this->pendingRender < 0 || this->pendingRender >= (i32)this->pendingObserved->hudService->renders.size())
+	{
+		return nullptr;
+	}
+	return &this->pendingObserved->hudService->renders[this->pendingRender];
+}
 
-	// clang-format on
+void KZHUDService::FlushPanels()
+{
+	VPROF_BUDGET(__func__, "CS2KZ");
 
-	centerText = centerText.substr(0, centerText.find_last_not_of('\n') + 1);
-	alertText = alertText.substr(0, alertText.find_last_not_of('\n') + 1);
-	htmlText = htmlText.substr(0, htmlText.find_last_not_of('\n') + 1);
+	f64 now = g_pKZUtils->GetServerGlobals()->realtime;
+	bool due[MAXPLAYERS + 1][HUDPANEL_COUNT];
+	FOR_EACH_VEC(pendingTargets, i)
+	{
+		const HUDRender *render = pendingTargets[i]->hudService->GetPendingRender();
+		for (u32 type = 0; type < HUDPANEL_COUNT; type++)
+		{
+			due[i][type] = render && pendingTargets[i]->GetController()
+						   && pendingTargets[i]->hudService->IsPanelDue((HUDPanelType)type, render->panels[type], now);
+		}
+	}
 
-	// Remove trailing newlines just in case a line is empty.
-	if (!centerText.empty())
+	// Every target watching the same render in the same language gets the panel from a single message.
+	for (u32 type = 0; type < HUDPANEL_COUNT; type++)
+	{
+		FOR_EACH_VEC(pendingTargets, i)
+		{
+			if (!due[i][type])
+			{
+				continue;
+			}
+			KZHUDService *service = pendingTargets[i]->hudService;
+			const std::string &text = service->GetPendingRender()->panels[type];
+
+			CRecipientFilter filter;
+			for (i32 j = i; j < pendingTargets.Count(); j++)
+			{
+				KZHUDService *other = pendingTargets[j]->hudService;
+				if (!due[j][type] || other->pendingObserved != service->pendingObserved || other->pendingRender != service->pendingRender)
+				{
+					continue;
+				}
+				due[j][type] = false;
+				filter.AddRecipient(pendingTargets[j]->GetPlayerSlot());
+				other->panels[type].sentText = text;
+				other->panels[type].lastSendTime = now;
+			}
+
+			switch (type)
+			{
+				case HUDPANEL_CENTRE:
+				{
+					utils::ClientPrintFilter(&filter, HUD_PRINTCENTER, text.c_str(), "", "", "", "");
+					break;
+				}
+				case HUDPANEL_ALERT:
+				{
+					utils::ClientPrintFilter(&filter, HUD_PRINTALERT, text.c_str(), "", "", "", "");
+					break;
+				}
+				case HUDPANEL_HTML:
+				{
+					utils::PrintHTMLCentreFilter(&filter, text.c_str());
+					break;
+				}
+			}
+
+			u64 bytes = text.size() * filter.GetRecipientCount();
+			hudStats.totals.messagesSent++;
+			hudStats.totals.bytesSent[type] += bytes;
+			hudStats.windowBytes += bytes;
+		}
+	}
+	FOR_EACH_VEC(pendingTargets, i)
 	{
-		target->PrintCentre(false, false, centerText.c_str());
+		pendingTargets[i]->hudService->pendingObserved = nullptr;
+		pendingTargets[i]->hudService->pendingRender = -1;
 	}
-	if (!alertText.empty())
+	pendingTargets.RemoveAll();
+
+	if (hudStats.windowStart == 0.0)
 	{
-		target->PrintAlert(false, false, alertText.c_str());
+		hudStats.windowStart = now;
 	}
-	if (!htmlText.empty())
+	else if (now - hudStats.windowStart >= 1.0)
 	{
-		target->PrintHTMLCentre(false, false, htmlText.c_str());
+		hudStats.totals.bytesPerSecond = hudStats.windowBytes / (now - hudStats.windowStart);
+		hudStats.windowBytes = 0;
+		hudStats.windowStart = now;
 	}
 }
 
+void KZHUDService::OnServerGamePostSimulate()
+{
+	FlushPanels();
+}
+
 void KZHUDService::ResetShowPanel()
 {
 	this->showPanel = this->player->optionService->GetPreferenceBool("showPanel", true);
@@ -166,6 +420,7 @@ void KZHUDService::TogglePanel()
 		utils::PrintCentre(this->player->GetController(), "#SFUI_EmptyString");
 		this->player->languageService->PrintHTMLCentre(false, false, "HUD - HTML Panel Disabled");
 	}
+	this->ResetSentPanels();
 }
 
 void KZHUDService::OnTimerStopped(f64 currentTimeWhenTimerStopped)
@@ -204,7 +459,21 @@ static_function SCMD_CALLBACK(Command_KzPanel)
 	return MRES_SUPERCEDE;
 }
 
+static_function SCMD_CALLBACK(Command_KzHudStats)
+{
+	KZPlayer *player = g_pKZPlayerManager->ToPlayer(controller);
+	HUDStats stats = KZHUDService::GetStats();
+
+	player->PrintConsole(false, false, "[KZ::HUD] Messages sent: %llu, identical skipped: %llu, rate limited: %llu", stats.messagesSent,
+						 stats.identicalSkipped, stats.rateLimited);
+	player->PrintConsole(false, false, "[KZ::HUD] Bytes sent: %llu centre, %llu alert, %llu html (%.0f bytes/s)", stats.bytesSent[HUDPANEL_CENTRE],
+						 stats.bytesSent[HUDPANEL_ALERT], stats.bytesSent[HUDPANEL_HTML], stats.bytesPerSecond);
+
+	return MRES_SUPERCEDE;
+}
+
 void KZHUDService::RegisterCommands()
 {
 	scmd::RegisterCmd("kz_panel", Command_KzPanel);
+	scmd::RegisterCmd("kz_hudstats", Command_KzHudStats, true);
 }
@@ -1,9 +1,47 @@
 #pragma once
+#include <vector>
+
 #include "../kz.h"
 #include "../timer/kz_timer.h"
 
 #define KZ_HUD_TIMER_STOPPED_GRACE_TIME 3.0f
 
+// Identical panels are still resent this often, as the client fades HUD messages out after a while.
+#define KZ_DEFAULT_HUD_REFRESH_INTERVAL 0.5f
+
+enum HUDPanelType
+{
+	HUDPANEL_CENTRE = 0,
+	HUDPANEL_ALERT,
+	HUDPANEL_HTML,
+	HUDPANEL_COUNT
+};
+
+// Everything the panel segments of a player are rendered from, quantized to what the phrases can display.
+struct HUDPanelState
+{
+	u8 buttons;
+	i32 currentCpIndex;
+	i32 checkpointCount;
+	u32 teleportCount;
+	i32 speed;
+	// -1 while the ground speed phrase is used.
+	i32 takeoffSpeed;
+	// In milliseconds, -1 while the timer text is hidden.
+	i32 time;
+	bool timerRunning;
+	bool timerPaused;
+};
+
+struct HUDStats
+{
+	u64 messagesSent;
+	u64 bytesSent[HUDPANEL_COUNT];
+	u64 identicalSkipped;
+	u64 rateLimited;
+	f64 bytesPerSecond;
+};
+
 class KZHUDService : public KZBaseService
 {
 	using KZBaseService::KZBaseService;
@@ -13,12 +51,41 @@ private:
 	f64 timerStoppedTime {};
 	f64 currentTimeWhenTimerStopped {};
 
+	// Panels rendered from this player, one per language of the players watching it. Each is formatted at most
+	// once per tick and only the segments whose inputs changed get formatted again.
+	struct HUDRender
+	{
+		std::string language;
+		i32 tick;
+		HUDPanelState state;
+		std::string keyText;
+		std::string checkpointText;
+		std::string timerText;
+		std::string speedText;
+		std::string panels[HUDPANEL_COUNT];
+	};
+
+	std::vector<HUDRender> renders;
+
+	// Render queued for this player, sent together with every other player sharing it at the end of the tick.
+	KZPlayer *pendingObserved {};
+	i32 pendingRender = -1;
+
+	struct
+	{
+		std::string sentText;
+		f64 lastSendTime;
+	} panels[HUDPANEL_COUNT] {};
+
 public:
 	virtual void Reset() override;
 	static void Init();
+	static void InitSettings();
 	static void RegisterCommands();
+	static HUDStats GetStats();
+	static void OnServerGamePostSimulate();
 
-	// Draw the panel from a player to a specific target.
+	// Draw the panel from a player to a specific target, the panel is sent at the end of the tick.
 	static void DrawPanels(KZPlayer *player, KZPlayer *target);
 
 	void ResetShowPanel();
@@ -38,8 +105,16 @@ public:
 	}
 
 private:
-	std::string GetSpeedText(const char *language = KZ_DEFAULT_LANGUAGE);
-	std::string GetKeyText(const char *language = KZ_DEFAULT_LANGUAGE);
-	std::string GetCheckpointText(const char *language = KZ_DEFAULT_LANGUAGE);
-	std::string GetTimerText(const char *language = KZ_DEFAULT_LANGUAGE);
+	HUDPanelState GetPanelState();
+	void ResetSentPanels();
+	const HUDRender *GetPendingRender();
+	// Render the panels of this player in a language, returns the index of the render.
+	i32 RenderPanels(const char *language);
+	bool IsPanelDue(HUDPanelType type, const std::string &text, f64 now);
+	static void FlushPanels();
+
+	static std::string GetSpeedText(const HUDPanelState &state, const char *language = KZ_DEFAULT_LANGUAGE);
+	static std::string GetKeyText(const HUDPanelState &state, const char *language = KZ_DEFAULT_LANGUAGE);
+	static std::string GetCheckpointText(const HUDPanelState &state, const char *language = KZ_DEFAULT_LANGUAGE);
+	static std::string GetTimerText(const HUDPanelState &state, const char *language = KZ_DEFAULT_LANGUAGE);
 };
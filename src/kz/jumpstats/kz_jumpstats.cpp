@@ -8,6 +8,7 @@
 #include "../option/kz_option.h"
 #include "../language/kz_language.h"
 #include "kz/trigger/kz_trigger.h"
+#include "kz/db/kz_db.h"
 
 #include "tier0/memdbgon.h"
 
@@ -182,95 +183,95 @@ void Strafe::UpdateCollisionVelocityChange(f32 delta)
 	}
 }
 
-void Strafe::End()
+void StrafeTickData::Build(AACall *aaCalls, i32 count)
 {
-	FOR_EACH_VEC(this->aaCalls, i)
-	{
-		this->duration += this->aaCalls[i].duration;
-		// Calculate BA/DA/OL
-		if (this->aaCalls[i].wishspeed == 0)
-		{
-			u64 buttonBits = IN_FORWARD | IN_BACK | IN_MOVELEFT | IN_MOVERIGHT;
-			if (CInButtonState::IsButtonPressed(this->aaCalls[i].buttons, buttonBits))
-			{
-				this->overlap += this->aaCalls[i].duration;
-			}
-			else
-			{
-				this->deadAir += this->aaCalls[i].duration;
-			}
-		}
-		else if ((this->aaCalls[i].velocityPost - this->aaCalls[i].velocityPre).Length2D() <= JS_EPSILON)
-		{
-			// This gain could just be from quantized float stuff.
-			this->badAngles += this->aaCalls[i].duration;
-		}
-		// Calculate sync.
-		else if (this->aaCalls[i].velocityPost.Length2D() - this->aaCalls[i].velocityPre.Length2D() > JS_EPSILON)
-		{
-			this->syncDuration += this->aaCalls[i].duration;
-		}
+	this->duration.SetCount(count);
+	this->speedPre.SetCount(count);
+	this->speedPost.SetCount(count);
+	this->idealGain.SetCount(count);
+	this->externalSpeedDiff.SetCount(count);
+	this->yawDifference.SetCount(count);
+	this->kind.SetCount(count);
+
+	for (i32 i = 0; i < count; i++)
+	{
+		AACall &call = aaCalls[i];
+		this->duration[i] = call.duration;
+		this->speedPre[i] = call.velocityPre.Length2D();
+		this->speedPost[i] = call.velocityPost.Length2D();
+		this->idealGain[i] = call.CalcIdealGain();
+		this->externalSpeedDiff[i] = call.externalSpeedDiff;
+		this->yawDifference[i] = fabs(utils::GetAngleDifference(call.currentYaw, call.prevYaw, 180.0f));
+
+		u64 buttonBits = IN_FORWARD | IN_BACK | IN_MOVELEFT | IN_MOVERIGHT;
+		this->kind[i] = StrafeTickData::Classify(call.wishspeed, CInButtonState::IsButtonPressed(call.buttons, buttonBits),
+												 (call.velocityPost - call.velocityPre).Length2D(), this->speedPre[i], this->speedPost[i]);
+	}
+}
 
-		// Gain/loss.
-		this->maxGain += this->aaCalls[i].CalcIdealGain();
-		f32 speedDiff = this->aaCalls[i].velocityPost.Length2D() - this->aaCalls[i].velocityPre.Length2D();
-		if (speedDiff > 0)
-		{
-			this->airGain += speedDiff;
-		}
-		else
-		{
-			this->airLoss += speedDiff;
-		}
-		f32 externalSpeedDiff = this->aaCalls[i].externalSpeedDiff;
-		if (externalSpeedDiff > 0)
-		{
-			this->externalGain += externalSpeedDiff;
-		}
-		else
-		{
-			this->externalLoss += externalSpeedDiff;
-		}
-		this->width += fabs(utils::GetAngleDifference(this->aaCalls[i].currentYaw, this->aaCalls[i].prevYaw, 180.0f));
+void Strafe::AddAACall(const AACall &call)
+{
+	if (this->aaCallCount == 0)
+	{
+		this->firstAACall = this->jump->aaCalls.Count();
 	}
-	this->CalcAngleRatioStats();
+
+	this->jump->aaCalls.AddToTail(call);
+	this->aaCallCount++;
+}
+
+AACall *Strafe::GetAACalls()
+{
+	return this->jump->aaCalls.Base() + this->firstAACall;
+}
+
+void Strafe::End()
+{
+	// Only used on the main thread, keeping it around saves reallocating the arrays for every strafe.
+	static_persist StrafeTickData ticks;
+	ticks.Build(this->GetAACalls(), this->aaCallCount);
+
+	ticks.Accumulate(*this);
+	this->CalcAngleRatioStats(ticks);
 }
 
-bool Strafe::CalcAngleRatioStats()
+bool Strafe::CalcAngleRatioStats(StrafeTickData &ticks)
 {
 	this->arStats.available = false;
 	f32 totalDuration = 0.0f;
 	f32 totalRatios = 0.0f;
-	CUtlVector<f32> ratios;
+	CUtlVector<f32> &ratios = ticks.ratios;
+	ratios.RemoveAll();
 
 	QAngle angles, velAngles;
-	FOR_EACH_VEC(this->aaCalls, i)
+	AACall *aaCalls = this->GetAACalls();
+	for (i32 i = 0; i < this->aaCallCount; i++)
 	{
-		if (this->aaCalls[i].velocityPre.Length2D() == 0)
+		if (ticks.speedPre[i] == 0)
 		{
 			// Any angle should be a good angle here.
 			// ratio += 0;
 			continue;
 		}
-		VectorAngles(this->aaCalls[i].velocityPre, velAngles);
+		VectorAngles(aaCalls[i].velocityPre, velAngles);
 
 		// If no attempt to gain speed was made, use the angle of the last call as a reference,
 		// and add yaw relative to last tick's yaw.
 		// If the velocity is 0 as well, then every angle is a perfect angle.
-		if (this->aaCalls[i].wishspeed != 0)
+		if (aaCalls[i].wishspeed != 0)
 		{
-			VectorAngles(this->aaCalls[i].wishdir, angles);
+			VectorAngles(aaCalls[i].wishdir, angles);
 		}
 		else
 		{
-			angles.y = this->aaCalls[i].prevYaw + utils::GetAngleDifference(this->aaCalls[i].currentYaw, this->aaCalls[i].prevYaw, 180.0f);
+			angles.y = aaCalls[i].prevYaw + utils::GetAngleDifference(aaCalls[i].currentYaw, aaCalls[i].prevYaw, 180.0f);
 		}
 
 		angles -= velAngles;
 		// Get the minimum, ideal, and max yaw for gain.
-		f32 minYaw = utils::NormalizeDeg(this->aaCalls[i].CalcMinYaw());
-		f32 idealYaw = utils::NormalizeDeg(this->aaCalls[i].CalcIdealYaw());
-		f32 maxYaw = utils::NormalizeDeg(this->aaCalls[i].CalcMaxYaw());
+		f32 minYaw = utils::NormalizeDeg(aaCalls[i].CalcMinYaw());
+		f32 idealYaw = utils::NormalizeDeg(aaCalls[i].CalcIdealYaw());
+		f32 maxYaw = utils::NormalizeDeg(aaCalls[i].CalcMaxYaw());
 
 		angles.y = utils::NormalizeDeg(angles.y);
 
@@ -285,7 +286,7 @@ bool Strafe::CalcAngleRatioStats()
 		// It is possible for the player to gain speed here, by pressing the opposite keys
 		// while still turning in the same direction, which results in actual gain...
 		// Usually this happens at the end of a strafe.
-		if (angles.y < 0 && this->aaCalls[i].velocityPost.Length2D() > this->aaCalls[i].velocityPre.Length2D())
+		if (angles.y < 0 && ticks.speedPost[i] > ticks.speedPre[i])
 		{
 			angles.y = -angles.y;
 		}
@@ -298,26 +299,26 @@ bool Strafe::CalcAngleRatioStats()
 		//	utils::GetAngleDifference(angles.y, minYaw, 180.0),
 		//	utils::GetAngleDifference(idealYaw, minYaw, 180.0),
 		//	utils::GetAngleDifference(maxYaw, minYaw, 180.0),
-		//	this->aaCalls[i].velocityPre.Length2D(), this->aaCalls[i].velocityPost.Length2D(),
-		//	this->aaCalls[i].velocityPre.x, this->aaCalls[i].velocityPre.y,
-		//	this->aaCalls[i].wishspeed,
-		//	this->aaCalls[i].wishdir.x,
-		//	this->aaCalls[i].wishdir.y,
-		//	this->aaCalls[i].wishdir.z,
-		//	this->aaCalls[i].accel,
-		//	this->aaCalls[i].duration * ENGINE_FIXED_TICK_RATE);
+		//	aaCalls[i].velocityPre.Length2D(), aaCalls[i].velocityPost.Length2D(),
+		//	aaCalls[i].velocityPre.x, aaCalls[i].velocityPre.y,
+		//	aaCalls[i].wishspeed,
+		//	aaCalls[i].wishdir.x,
+		//	aaCalls[i].wishdir.y,
+		//	aaCalls[i].wishdir.z,
+		//	aaCalls[i].accel,
+		//	aaCalls[i].duration * ENGINE_FIXED_TICK_RATE);
 		if (angles.y > maxYaw + 20.0f || angles.y < minYaw - 20.0f)
 		{
 		}
-		f32 gainRatio = (this->aaCalls[i].velocityPost.Length2D() - this->aaCalls[i].velocityPre.Length2D()) / this->aaCalls[i].CalcIdealGain();
-		f32 fraction = this->aaCalls[i].duration * ENGINE_FIXED_TICK_RATE;
+		f32 gainRatio = (ticks.speedPost[i] - ticks.speedPre[i]) / ticks.idealGain[i];
+		f32 fraction = ticks.duration[i] * ENGINE_FIXED_TICK_RATE;
 		if (angles.y < minYaw)
 		{
 			totalRatios += -1 * fraction;
 			totalDuration += fraction;
 			ratios.AddToTail(-1 * fraction);
-			// utils::PrintConsoleAll("No Gain: GR = %f (%f / %f)", gainRatio, this->aaCalls[i].velocityPost.Length2D()
-			// - this->aaCalls[i].velocityPre.Length2D(), this->aaCalls[i].CalcIdealGain());
+			// utils::PrintConsoleAll("No Gain: GR = %f (%f / %f)", gainRatio, aaCalls[i].velocityPost.Length2D()
+			// - aaCalls[i].velocityPre.Length2D(), aaCalls[i].CalcIdealGain());
 			continue;
 		}
 		else if (angles.y < idealYaw)
@@ -326,8 +327,8 @@ bool Strafe::CalcAngleRatioStats()
 			totalDuration += fraction;
 			ratios.AddToTail((gainRatio - 1) * fraction);
 			// utils::PrintConsoleAll("Slow Gain: GR = %f (%f / %f)", gainRatio,
-			// this->aaCalls[i].velocityPost.Length2D() - this->aaCalls[i].velocityPre.Length2D(),
-			// this->aaCalls[i].CalcIdealGain());
+			// aaCalls[i].velocityPost.Length2D() - aaCalls[i].velocityPre.Length2D(),
+			// aaCalls[i].CalcIdealGain());
 		}
 		else if (angles.y < maxYaw)
 		{
@@ -335,8 +336,8 @@ bool Strafe::CalcAngleRatioStats()
 			totalDuration += fraction;
 			ratios.AddToTail((1 - gainRatio) * fraction);
 			// utils::PrintConsoleAll("Fast Gain: GR = %f (%f / %f)", gainRatio,
-			// this->aaCalls[i].velocityPost.Length2D() - this->aaCalls[i].velocityPre.Length2D(),
-			// this->aaCalls[i].CalcIdealGain());
+			// aaCalls[i].velocityPost.Length2D() - aaCalls[i].velocityPre.Length2D(),
+			// aaCalls[i].CalcIdealGain());
 		}
 		else
 		{
@@ -344,8 +345,8 @@ bool Strafe::CalcAngleRatioStats()
 			totalDuration += fraction;
 			ratios.AddToTail(1.0f);
 			// utils::PrintConsoleAll("TooFast Gain: GR = %f (%f / %f)", gainRatio,
-			// this->aaCalls[i].velocityPost.Length2D() - this->aaCalls[i].velocityPre.Length2D(),
-			// this->aaCalls[i].CalcIdealGain());
+			// aaCalls[i].velocityPost.Length2D() - aaCalls[i].velocityPre.Length2D(),
+			// aaCalls[i].CalcIdealGain());
 		}
 	}
 
@@ -354,11 +355,9 @@ bool Strafe::CalcAngleRatioStats()
 	{
 		return false;
 	}
-	ratios.Sort(this->SortFloat);
 	this->arStats.available = true;
 	this->arStats.average = totalRatios / totalDuration;
-	this->arStats.median = ratios[ratios.Count() / 2];
-	this->arStats.max = ratios[ratios.Count() - 1];
+	StrafeTickData::RatioMedianAndMax(ratios, this->arStats.median, this->arStats.max);
 	return true;
 }
 
@@ -397,11 +396,27 @@ void Jump::Init()
 	}
 }
 
+void Jump::Reset(KZPlayer *player)
+{
+	CCopyableUtlVector<Strafe> strafes;
+	CCopyableUtlVector<AACall> aaCalls;
+	strafes.Swap(this->strafes);
+	aaCalls.Swap(this->aaCalls);
+
+	*this = Jump(player);
+
+	// Hand the old buffers back, emptied but with their capacity intact.
+	this->strafes.Swap(strafes);
+	this->aaCalls.Swap(aaCalls);
+	this->strafes.RemoveAll();
+	this->aaCalls.RemoveAll();
+}
+
 void Jump::UpdateAACallPost(Vector wishdir, f32 wishspeed, f32 accel)
 {
 	// Use the latest parameters, just in case they changed.
 	Strafe *strafe = this->GetCurrentStrafe();
-	AACall *call = &strafe->aaCalls.Tail();
+	AACall *call = &this->aaCalls.Tail();
 	QAngle currentAngle;
 	this->player->GetAngles(&currentAngle);
 	call->maxspeed = this->player->currentMoveData->m_flMaxSpeed;
@@ -458,20 +473,20 @@ void Jump::End()
 
 	f32 gain = 0.0f;
 	f32 maxGain = 0.0f;
-	FOR_EACH_VEC(this->strafes, i)
+	FOR_EACH_VEC(this->aaCalls, i)
 	{
-		FOR_EACH_VEC(this->strafes[i].aaCalls, j)
+		if (this->aaCalls[i].ducking)
 		{
-			if (this->strafes[i].aaCalls[j].ducking)
-			{
-				this->duckDuration += this->strafes[i].aaCalls[j].duration;
-				this->duckEndDuration += this->strafes[i].aaCalls[j].duration;
-			}
-			else
-			{
-				this->duckEndDuration = 0.0f;
-			}
+			this->duckDuration += this->aaCalls[i].duration;
+			this->duckEndDuration += this->aaCalls[i].duration;
 		}
+		else
+		{
+			this->duckEndDuration = 0.0f;
+		}
+	}
+	FOR_EACH_VEC(this->strafes, i)
+	{
 		this->width += this->strafes[i].GetWidth();
 		this->overlap += this->strafes[i].GetOverlapDuration();
 		this->deadAir += this->strafes[i].GetDeadAirDuration();
@@ -486,6 +501,7 @@ void Jump::End()
 	this->deadAir /= jumpDuration;
 	this->badAngles /= jumpDuration;
 	this->sync /= jumpDuration;
+	this->airtime = jumpDuration;
 	this->ended = true;
 	this->gainEff = gain / maxGain;
 	// If there's no air time at all then that was definitely not a jump.
@@ -597,7 +613,7 @@ f32 Jump::GetDeviation()
 
 JumpType KZJumpstatsService::DetermineJumpType()
 {
-	if (this->jumps.Count() <= 0 || this->player->JustTeleported() || this->player->triggerService->ShouldDisableJumpstats())
+	if (!this->hasJump || this->player->JustTeleported() || this->player->triggerService->ShouldDisableJumpstats())
 	{
 		return JumpType_Invalid;
 	}
@@ -633,7 +649,7 @@ JumpType KZJumpstatsService::DetermineJumpType()
 	}
 	if (this->player->duckBugged)
 	{
-		if (this->jumps.Tail().GetOffset() < JS_EPSILON && this->jumps.Tail().GetJumpType() == JumpType_LongJump)
+		if (this->currentJump.GetOffset() < JS_EPSILON && this->currentJump.GetJumpType() == JumpType_LongJump)
 		{
 			return JumpType_Jumpbug;
 		}
@@ -645,13 +661,13 @@ JumpType KZJumpstatsService::DetermineJumpType()
 	if (this->HitBhop() && !this->HitDuckbugRecently())
 	{
 		// Check for no offset
-		if (this->jumps.Tail().DidHitHead() || !this->jumps.Tail().IsValid())
+		if (this->currentJump.DidHitHead() || !this->currentJump.IsValid())
 		{
 			return JumpType_Invalid;
 		}
-		if (fabs(this->jumps.Tail().GetOffset()) < JS_EPSILON)
+		if (fabs(this->currentJump.GetOffset()) < JS_EPSILON)
 		{
-			switch (this->jumps.Tail().GetJumpType())
+			switch (this->currentJump.GetJumpType())
 			{
 				case JumpType_LongJump:
 					return JumpType_Bhop;
@@ -664,7 +680,7 @@ JumpType KZJumpstatsService::DetermineJumpType()
 			}
 		}
 		// Check for weird jump
-		if (this->jumps.Tail().GetJumpType() == JumpType_Fall && this->ValidWeirdJumpDropDistance())
+		if (this->currentJump.GetJumpType() == JumpType_Fall && this->ValidWeirdJumpDropDistance())
 		{
 			return JumpType_WeirdJump;
 		}
@@ -680,11 +696,11 @@ JumpType KZJumpstatsService::DetermineJumpType()
 
 f32 KZJumpstatsService::GetLastJumpRelease()
 {
-	if (this->jumps.Count() == 0)
+	if (!this->hasJump)
 	{
 		return 0.0f;
 	}
-	return this->jumps.Tail().GetRelease();
+	return this->currentJump.GetRelease();
 }
 
 void KZJumpstatsService::Reset()
@@ -692,7 +708,7 @@ void KZJumpstatsService::Reset()
 	this->broadcastMinTier = static_cast<DistanceTier>(KZOptionService::GetOptionInt("defaultJSBroadcastMinTier", DistanceTier_Godlike));
 	this->soundMinTier = static_cast<DistanceTier>(KZOptionService::GetOptionInt("defaultJSSoundMinTier", DistanceTier_Godlike));
 	this->showJumpstats = KZOptionService::GetOptionInt("defaultShowJS", true);
-	this->jumps.Purge();
+	this->hasJump = false;
 	this->jsAlways = {};
 	this->lastJumpButtonTime = {};
 	this->lastNoclipTime = {};
@@ -708,7 +724,7 @@ void KZJumpstatsService::OnProcessMovement()
 {
 	// Always ensure that the player has at least an ongoing jump.
 	// This is mostly to prevent crash, it's not a valid jump.
-	if (this->jumps.Count() == 0)
+	if (!this->hasJump)
 	{
 		this->AddJump();
 		this->InvalidateJumpstats("First jump");
@@ -753,7 +769,7 @@ bool KZJumpstatsService::HitDuckbugRecently()
 
 bool KZJumpstatsService::ValidWeirdJumpDropDistance()
 {
-	return this->jumps.Tail().GetOffset() > -1 * JS_MAX_WEIRDJUMP_FALL_OFFSET;
+	return this->currentJump.GetOffset() > -1 * JS_MAX_WEIRDJUMP_FALL_OFFSET;
 }
 
 bool KZJumpstatsService::GroundSpeedCappedRecently()
@@ -775,8 +791,8 @@ void KZJumpstatsService::OnAirMove()
 	call.prevYaw = this->player->oldAngles.y;
 	call.curtime = g_pKZUtils->GetGlobals()->curtime;
 	call.tickcount = g_pKZUtils->GetGlobals()->tickcount;
-	Strafe *strafe = this->jumps.Tail().GetCurrentStrafe();
-	strafe->aaCalls.AddToTail(call);
+	Strafe *strafe = this->currentJump.GetCurrentStrafe();
+	strafe->AddAACall(call);
 }
 
 void KZJumpstatsService::OnAirMovePost()
@@ -823,19 +839,20 @@ void KZJumpstatsService::OnAirMovePost()
 	}
 	auto accel = reinterpret_cast<CVValue_t *>(&(KZ::mode::modeCvars[MODECVAR_SV_AIRACCELERATE]->values))->m_flValue;
 
-	this->jumps.Tail().UpdateAACallPost(wishdir, wishspeed, accel);
+	this->currentJump.UpdateAACallPost(wishdir, wishspeed, accel);
 }
 
 void KZJumpstatsService::AddJump()
 {
-	this->jumps.AddToTail({this->player});
+	this->currentJump.Reset(this->player);
+	this->hasJump = true;
 }
 
 void KZJumpstatsService::UpdateJump()
 {
-	if (this->jumps.Count() > 0)
+	if (this->hasJump)
 	{
-		this->jumps.Tail().Update();
+		this->currentJump.Update();
 	}
 	this->DetectInvalidCollisions();
 	this->DetectInvalidGains();
@@ -844,9 +861,9 @@ void KZJumpstatsService::UpdateJump()
 
 void KZJumpstatsService::EndJump()
 {
-	if (this->jumps.Count() > 0)
+	if (this->hasJump)
 	{
-		Jump *jump = &this->jumps.Tail();
+		Jump *jump = &this->currentJump;
 
 		// Prevent stats being calculated twice.
 		if (jump->AlreadyEnded())
@@ -864,6 +881,10 @@ void KZJumpstatsService::EndJump()
 			{
 				KZJumpstatsService::PrintJumpToChat(this->player, jump);
 			}
+			if (jump->GetOffset() > -JS_EPSILON && jump->IsValid())
+			{
+				this->player->databaseService->SaveJumpstat(jump);
+			}
 			DistanceTier tier = jump->GetJumpPlayer()->modeService->GetDistanceTier(jump->GetJumpType(), jump->GetDistance());
 			if (tier >= DistanceTier_Wrecker && !jump->GetJumpPlayer()->jumpstatsService->jsAlways)
 			{
@@ -908,9 +929,9 @@ void KZJumpstatsService::EndJump()
 
 void KZJumpstatsService::InvalidateJumpstats(const char *reason)
 {
-	if (this->jumps.Count() > 0 && !this->jumps.Tail().AlreadyEnded())
+	if (this->hasJump && !this->currentJump.AlreadyEnded())
 	{
-		this->jumps.Tail().Invalidate(reason);
+		this->currentJump.Invalidate(reason);
 	}
 }
 
@@ -980,7 +1001,7 @@ void KZJumpstatsService::DetectNoclip()
 
 void KZJumpstatsService::DetectEdgebug()
 {
-	if (this->jumps.Count() == 0 || !this->jumps.Tail().IsValid())
+	if (!this->hasJump || !this->currentJump.IsValid())
 	{
 		return;
 	}
@@ -995,22 +1016,22 @@ void KZJumpstatsService::DetectEdgebug()
 
 void KZJumpstatsService::DetectInvalidCollisions()
 {
-	if (this->jumps.Count() == 0 || !this->jumps.Tail().IsValid())
+	if (!this->hasJump || !this->currentJump.IsValid())
 	{
 		return;
 	}
 	if (this->player->IsCollidingWithWorld())
 	{
-		this->jumps.Tail().touchDuration += g_pKZUtils->GetGlobals()->frametime;
+		this->currentJump.touchDuration += g_pKZUtils->GetGlobals()->frametime;
 		// Headhit invadidates following bhops but not the current jump,
 		// while other collisions do after a certain duration.
-		if (this->jumps.Tail().touchDuration > JS_TOUCH_GRACE_PERIOD)
+		if (this->currentJump.touchDuration > JS_TOUCH_GRACE_PERIOD)
 		{
 			this->InvalidateJumpstats("Invalid collisions");
 		}
 		if (this->player->moveDataPre.m_vecVelocity.z > 0.0f)
 		{
-			this->jumps.Tail().MarkHitHead();
+			this->currentJump.MarkHitHead();
 		}
 	}
 }
@@ -1059,7 +1080,7 @@ void KZJumpstatsService::DetectExternalModifications()
 
 void KZJumpstatsService::DetectWater()
 {
-	if (this->jumps.Count() == 0 || !this->jumps.Tail().IsValid())
+	if (!this->hasJump || !this->currentJump.IsValid())
 	{
 		return;
 	}
@@ -1076,12 +1097,12 @@ void KZJumpstatsService::OnTryPlayerMove()
 
 void KZJumpstatsService::OnTryPlayerMovePost()
 {
-	if (this->jumps.Count() == 0 || this->jumps.Tail().strafes.Count() == 0)
+	if (!this->hasJump || this->currentJump.strafes.Count() == 0)
 	{
 		return;
 	}
 	f32 velocity = this->player->currentMoveData->m_vecVelocity.Length2D() - this->tpmVelocity.Length2D();
-	this->jumps.Tail().strafes.Tail().UpdateCollisionVelocityChange(velocity);
+	this->currentJump.strafes.Tail().UpdateCollisionVelocityChange(velocity);
 	this->DetectEdgebug();
 
 	FOR_EACH_VEC(this->player->currentMoveData->m_TouchList, i)
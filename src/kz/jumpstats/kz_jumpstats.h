@@ -5,6 +5,7 @@
 #include "sdk/datatypes.h"
 
 #include "../kz.h"
+#include "kz_strafeticks.h"
 
 class KZPlayer;
 
@@ -90,10 +91,16 @@ public:
 	Strafe(Jump *jump) : jump(jump) {}
 
 	Jump *jump;
-	CCopyableUtlVector<AACall> aaCalls;
 	TurnState turnstate;
 
 private:
+	// Adds the per-call values straight into the fields below.
+	friend struct StrafeTickData;
+
+	// The AA calls of a strafe are a consecutive range of the jump's AA calls.
+	i32 firstAACall {};
+	i32 aaCallCount {};
+
 	f32 duration {};
 
 	f32 badAngles {};
@@ -120,6 +127,14 @@ private:
 public:
 	void End();
 
+	void AddAACall(const AACall &call);
+	AACall *GetAACalls();
+
+	i32 GetAACallCount()
+	{
+		return this->aaCallCount;
+	}
+
 	f32 GetStrafeDuration()
 	{
 		return this->duration;
@@ -178,16 +193,6 @@ public:
 		return this->strafeMaxSpeed;
 	}
 
-	// Calculate the ratio for each strafe.
-	// The ratio is 0 if the angle is perfect, closer to -100 if it's too slow
-	// Closer to 100 if it passes the optimal value.
-	// Note: if the player jumps in place, no velocity and no attempt to move at all, any angle will be "perfect".
-	// Returns false if there is no available stats.
-	static int SortFloat(const f32 *a, const f32 *b)
-	{
-		return *a > *b;
-	}
-
 	struct AngleRatioStats
 	{
 		bool available;
@@ -198,7 +203,12 @@ public:
 
 	AngleRatioStats arStats;
 
-	bool CalcAngleRatioStats();
+	// Calculate the ratio for each strafe.
+	// The ratio is 0 if the angle is perfect, closer to -100 if it's too slow
+	// Closer to 100 if it passes the optimal value.
+	// Note: if the player jumps in place, no velocity and no attempt to move at all, any angle will be "perfect".
+	// Returns false if there is no available stats.
+	bool CalcAngleRatioStats(StrafeTickData &ticks);
 
 	void UpdateStrafeMaxSpeed(f32 speed)
 	{
@@ -209,7 +219,7 @@ public:
 class Jump
 {
 private:
-	KZPlayer *player;
+	KZPlayer *player {};
 
 	Vector takeoffOrigin;
 	Vector adjustedTakeoffOrigin;
@@ -242,15 +252,14 @@ private:
 
 public:
 	CCopyableUtlVector<Strafe> strafes;
+	// AA calls of every strafe, in order.
+	CCopyableUtlVector<AACall> aaCalls;
 	f32 touchDuration {};
 	char invalidateReason[256] {};
 	bool trackingRelease = true;
 
 public:
-	Jump()
-	{
-		Init();
-	}
+	Jump() {}
 
 	Jump(KZPlayer *player) : player(player)
 	{
@@ -258,6 +267,8 @@ public:
 	}
 
 	void Init();
+	// Starts a new jump, reusing the strafe and AA call storage of the previous one.
+	void Reset(KZPlayer *player);
 	void UpdateAACallPost(Vector wishdir, f32 wishspeed, f32 accel);
 	void Update();
 	void End();
@@ -356,6 +367,11 @@ public:
 
 	f32 GetAirPath();
 
+	f32 GetAirtime()
+	{
+		return this->airtime;
+	}
+
 	f32 GetDuckTime(bool endOnly = true)
 	{
 		return endOnly ? this->duckEndDuration : this->duckDuration;
@@ -376,7 +392,6 @@ class KZJumpstatsService : public KZBaseService
 public:
 	KZJumpstatsService(KZPlayer *player) : KZBaseService(player)
 	{
-		this->jumps = CUtlVector<Jump>(1, 0);
 		this->tpmVelocity = Vector(0, 0, 0);
 	}
 
@@ -389,7 +404,9 @@ private:
 	bool jsAlways {};
 	bool showJumpstats {}; // Need change to type
 
-	CUtlVector<Jump> jumps;
+	// Only the ongoing jump is kept, and it is reused for every new jump.
+	Jump currentJump;
+	bool hasJump {};
 	f32 lastJumpButtonTime {};
 	f32 lastNoclipTime {};
 	f32 lastDuckbugTime {};
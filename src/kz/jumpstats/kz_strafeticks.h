@@ -0,0 +1,112 @@
+#pragma once
+
+#include <algorithm>
+
+#include "common.h"
+#include "utlvector.h"
+
+// Doesn't need the rest of the SDK, so scripts/test-strafe-stats.sh can check the reductions on their own.
+
+// Same as in kz_jumpstats.h.
+#ifndef JS_EPSILON
+#define JS_EPSILON 0.03125f
+#endif
+
+class AACall;
+
+enum StrafeTickKind : u8
+{
+	StrafeTick_None,
+	StrafeTick_Overlap,
+	StrafeTick_DeadAir,
+	StrafeTick_BadAngle,
+	StrafeTick_Sync,
+};
+
+// Values derived from the AA calls of a strafe, computed once per call and stored as separate arrays
+// so the strafe stats can be reduced in linear passes instead of walking the full AACall structs.
+struct StrafeTickData
+{
+	CUtlVector<f32> duration;
+	CUtlVector<f32> speedPre;
+	CUtlVector<f32> speedPost;
+	CUtlVector<f32> idealGain;
+	CUtlVector<f32> externalSpeedDiff;
+	CUtlVector<f32> yawDifference;
+	CUtlVector<StrafeTickKind> kind;
+	CUtlVector<f32> ratios;
+
+	i32 Count() const
+	{
+		return this->duration.Count();
+	}
+
+	void Build(AACall *aaCalls, i32 count);
+
+	// velocityChange is the 2D length of velocityPost - velocityPre.
+	static StrafeTickKind Classify(f32 wishspeed, bool movementPressed, f32 velocityChange, f32 speedPre, f32 speedPost)
+	{
+		// Calculate BA/DA/OL
+		if (wishspeed == 0)
+		{
+			return movementPressed ? StrafeTick_Overlap : StrafeTick_DeadAir;
+		}
+		if (velocityChange <= JS_EPSILON)
+		{
+			// This gain could just be from quantized float stuff.
+			return StrafeTick_BadAngle;
+		}
+		// Calculate sync.
+		if (speedPost - speedPre > JS_EPSILON)
+		{
+			return StrafeTick_Sync;
+		}
+		return StrafeTick_None;
+	}
+
+	// Adds the durations, gains and width of every call to the matching fields of stats.
+	// Every sum is accumulated in call order, so the results match summing over the calls one by one.
+	template<typename T>
+	void Accumulate(T &stats) const
+	{
+		i32 count = this->Count();
+		const f32 *duration = this->duration.Base();
+		const f32 *speedPre = this->speedPre.Base();
+		const f32 *speedPost = this->speedPost.Base();
+		const f32 *idealGain = this->idealGain.Base();
+		const f32 *externalSpeedDiff = this->externalSpeedDiff.Base();
+		const f32 *yawDifference = this->yawDifference.Base();
+		const StrafeTickKind *kind = this->kind.Base();
+
+		// One loop, so the independent sums can overlap instead of each pass waiting on a single one.
+		for (i32 i = 0; i < count; i++)
+		{
+			stats.duration += duration[i];
+			stats.overlap += kind[i] == StrafeTick_Overlap ? duration[i] : 0.0f;
+			stats.deadAir += kind[i] == StrafeTick_DeadAir ? duration[i] : 0.0f;
+			stats.badAngles += kind[i] == StrafeTick_BadAngle ? duration[i] : 0.0f;
+			stats.syncDuration += kind[i] == StrafeTick_Sync ? duration[i] : 0.0f;
+
+			// Gain/loss.
+			f32 speedDiff = speedPost[i] - speedPre[i];
+			stats.maxGain += idealGain[i];
+			stats.airGain += MAX(speedDiff, 0.0f);
+			stats.airLoss += MIN(speedDiff, 0.0f);
+			stats.externalGain += MAX(externalSpeedDiff[i], 0.0f);
+			stats.externalLoss += MIN(externalSpeedDiff[i], 0.0f);
+
+			stats.width += yawDifference[i];
+		}
+	}
+
+	// Reorders ratios. Only the middle element and the maximum are needed, no need to sort everything.
+	static void RatioMedianAndMax(CUtlVector<f32> &ratios, f32 &median, f32 &max)
+	{
+		f32 *first = ratios.Base();
+		f32 *last = first + ratios.Count();
+		f32 *middle = first + ratios.Count() / 2;
+		std::nth_element(first, middle, last);
+		median = *middle;
+		max = *std::max_element(first, last);
+	}
+};
@@ -11,6 +11,7 @@
 #include "noclip/kz_noclip.h"
 #include "option/kz_option.h"
 #include "quiet/kz_quiet.h"
+#include "replays/kz_replays.h"
 #include "spec/kz_spec.h"
 #include "goto/kz_goto.h"
 #include "style/kz_style.h"
@@ -51,6 +52,7 @@ void KZPlayer::Init()
 	delete this->telemetryService;
 	delete this->triggerService;
 	delete this->globalService;
+	delete this->replayService;
 
 	this->anticheatService = new KZAnticheatService(this);
 	this->checkpointService = new KZCheckpointService(this);
@@ -68,6 +70,7 @@ void KZPlayer::Init()
 	this->telemetryService = new KZTelemetryService(this);
 	this->triggerService = new KZTriggerService(this);
 	this->globalService = new KZGlobalService(this);
+	this->replayService = new KZReplayService(this);
 
 	KZ::mode::InitModeService(this);
 }
@@ -89,6 +92,7 @@ void KZPlayer::Reset()
 	this->timerService->Reset();
 	this->specService->Reset();
 	this->triggerService->Reset();
+	this->replayService->Reset();
 
 	g_pKZModeManager->SwitchToMode(this, KZOptionService::GetOptionStr("defaultMode", KZ_DEFAULT_MODE), true, true);
 	g_pKZStyleManager->ClearStyles(this, true);
@@ -235,6 +239,7 @@ void KZPlayer::OnProcessMovementPost()
 		this->styleServices[i]->OnProcessMovementPost();
 	}
 	this->jumpstatsService->OnProcessMovementPost();
+	this->replayService->OnProcessMovementPost();
 	MovementPlayer::OnProcessMovementPost();
 }
 
@@ -818,6 +823,7 @@ void KZPlayer::UpdateTriggerTouchList()
 void KZPlayer::OnChangeTeamPost(i32 team)
 {
 	this->timerService->OnPlayerJoinTeam(team);
+	this->quietService->UpdateHidingMask(this->IsAlive());
 }
 
 CUtlString KZPlayer::ComputeCvarValueFromModeStyles(const char *name)
@@ -82,18 +82,12 @@ void KZPlayer::PrintConsole(bool addPrefix, bool includeSpectators, const char *
 void KZPlayer::PrintChat(bool addPrefix, bool includeSpectators, const char *format, ...)
 {
 	FORMAT_STRING(buffer, addPrefix);
-	char coloredBuffer[512];
-	if (!utils::CFormat(coloredBuffer, sizeof(coloredBuffer), buffer))
-	{
-		Warning("utils::CPrintChat did not have enough space to print: %s\n", buffer);
-		return;
-	}
 	CRecipientFilter *filter = CreateRecipientFilter(this, includeSpectators);
 	if (!filter)
 	{
 		return;
 	}
-	utils::ClientPrintFilter(filter, HUD_PRINTTALK, coloredBuffer, "", "", "", "");
+	utils::CPrintChatFilter(filter, buffer);
 	delete filter;
 }
 
@@ -146,26 +140,6 @@ void KZPlayer::PrintHTMLCentre(bool addPrefix, bool includeSpectators, const cha
 		return;
 	}
 
-	CBasePlayerController *controller = this->GetController();
-	if (!controller)
-	{
-		return;
-	}
-
-	IGameEvent *event = interfaces::pGameEventManager->CreateEvent("show_survival_respawn_status");
-	if (!event)
-	{
-		return;
-	}
-	event->SetString("loc_token", buffer.Get());
-	event->SetInt("duration", 1);
-	event->SetInt("userid", -1);
-
-	for (int i = 0; i < filter->GetRecipientCount(); i++)
-	{
-		IGameEventListener2 *listener = g_pKZUtils->GetLegacyGameEventListener(filter->GetRecipientIndex(i));
-		listener->FireGameEvent(event);
-	}
-	interfaces::pGameEventManager->FreeEvent(event);
+	utils::PrintHTMLCentreFilter(filter, buffer.Get());
 	delete filter;
 }
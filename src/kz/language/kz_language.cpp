@@ -8,12 +8,138 @@
 #include "kz/option/kz_option.h"
 
 #include <vendor/ClientCvarValue/public/iclientcvarvalue.h>
+#include <unordered_map>
 
 extern IClientCvarValue *g_pClientCvarValue;
 
 static_global KeyValues *translationKV;
 static_global KeyValues *languagesKV;
 
+struct CaseInsensitiveHash
+{
+	size_t operator()(const char *str) const
+	{
+		// FNV-1a
+		u32 hash = 2166136261u;
+		for (const char *c = str; *c; c++)
+		{
+			hash ^= (u8)tolower((u8)*c);
+			hash *= 16777619u;
+		}
+		return hash;
+	}
+};
+
+struct CaseInsensitiveEqual
+{
+	bool operator()(const char *a, const char *b) const
+	{
+		return !V_stricmp(a, b);
+	}
+};
+
+// Keys point into translationKV, which outlives the maps.
+typedef std::unordered_map<const char *, i32, CaseInsensitiveHash, CaseInsensitiveEqual> TranslationIndex;
+
+struct CompiledPhrase
+{
+	bool hasParams;
+	// Indexed by language ID, empty if the phrase isn't translated to that language.
+	std::vector<std::string> formats;
+};
+
+static_global TranslationIndex phraseIDs;
+static_global TranslationIndex languageIDs;
+static_global std::vector<CompiledPhrase> compiledPhrases;
+static_global i32 defaultLanguageID = -1;
+// Bumped every time the translations are compiled, invalidating the IDs cached in KZPhrase handles.
+static_global u32 translationGeneration = 0;
+
+static_function void ReplaceStringInPlace(std::string &subject, std::string_view search, std::string_view replace)
+{
+	size_t pos = 0;
+	while ((pos = subject.find(search, pos)) != std::string::npos)
+	{
+		subject.replace(pos, search.length(), replace);
+		pos += replace.length();
+	}
+}
+
+static_function std::string CompileFormat(const char *input, const char *format)
+{
+	std::string inputStr = std::string(input);
+	const char *tokenStart = format;
+	int argNumber = 0;
+	while (true)
+	{
+		const char *tokenEnd = strstr(tokenStart, ":");
+		if (!tokenEnd)
+		{
+			break;
+		}
+		const char *replaceStart = tokenEnd + 1;
+		const char *replaceEnd = strstr(replaceStart, ",");
+		if (!replaceEnd)
+		{
+			replaceEnd = format + strlen(format);
+			ReplaceStringInPlace(inputStr, '{' + std::string(tokenStart, tokenEnd - tokenStart) + '}',
+								 '%' + std::to_string(++argNumber) + '$' + std::string(replaceStart, replaceEnd - replaceStart));
+			break;
+		}
+		else
+		{
+			ReplaceStringInPlace(inputStr, '{' + std::string(tokenStart, tokenEnd - tokenStart) + '}',
+								 '%' + std::to_string(++argNumber) + '$' + std::string(replaceStart, replaceEnd - replaceStart));
+			tokenStart = replaceEnd + 1;
+		}
+	}
+	return inputStr;
+}
+
+static_function void CompileTranslations()
+{
+	phraseIDs.clear();
+	languageIDs.clear();
+	compiledPhrases.clear();
+	translationGeneration++;
+
+	FOR_EACH_SUBKEY(translationKV, phraseKV)
+	{
+		// The first definition of a phrase wins, like KeyValues::FindKey.
+		if (!phraseIDs.emplace(phraseKV->GetName(), (i32)compiledPhrases.size()).second)
+		{
+			continue;
+		}
+
+		CompiledPhrase &phrase = compiledPhrases.emplace_back();
+		const char *paramFormat = phraseKV->GetString("#format");
+		phrase.hasParams = paramFormat[0] != '\0';
+
+		FOR_EACH_VALUE(phraseKV, valueKV)
+		{
+			const char *language = valueKV->GetName();
+			const char *message = valueKV->GetString();
+			if (!V_stricmp(language, "#format") || message[0] == '\0')
+			{
+				continue;
+			}
+
+			i32 languageID = languageIDs.emplace(language, (i32)languageIDs.size()).first->second;
+			if ((i32)phrase.formats.size() <= languageID)
+			{
+				phrase.formats.resize(languageID + 1);
+			}
+			if (phrase.formats[languageID].empty())
+			{
+				phrase.formats[languageID] = phrase.hasParams ? CompileFormat(message, paramFormat) : std::string(message);
+			}
+		}
+	}
+
+	auto defaultLanguage = languageIDs.find(KZ_DEFAULT_LANGUAGE);
+	defaultLanguageID = defaultLanguage != languageIDs.end() ? defaultLanguage->second : -1;
+}
+
 void KZLanguageService::Init()
 {
 	if (translationKV)
@@ -31,6 +157,7 @@ void KZLanguageService::Init()
 
 	KZLanguageService::LoadTranslations();
 	KZLanguageService::LoadLanguages();
+	CompileTranslations();
 }
 
 void KZLanguageService::LoadLanguages()
@@ -84,25 +211,50 @@ const char *KZLanguageService::GetLanguage()
 	return KZOptionService::GetOptionStr("defaultLanguage", KZ_DEFAULT_LANGUAGE);
 }
 
-const char *KZLanguageService::GetTranslatedFormat(const char *language, const char *phrase)
+i32 KZLanguageService::FindPhrase(const char *phrase)
 {
-	if (!translationKV->FindKey(phrase))
+	auto it = phraseIDs.find(phrase);
+	if (it == phraseIDs.end())
 	{
 		// META_CONPRINTF("Warning: Phrase '%s' not found, returning orignal message!\n", phrase);
-		return phrase;
+		return -1;
 	}
-	const char *outFormat = translationKV->FindKey(phrase)->GetString(language);
-	if (outFormat[0] == '\0')
+	return it->second;
+}
+
+i32 KZLanguageService::FindPhrase(KZPhrase &phrase)
+{
+	if (phrase.generation != translationGeneration)
+	{
+		phrase.id = FindPhrase(phrase.name);
+		phrase.generation = translationGeneration;
+	}
+	return phrase.id;
+}
+
+const char *KZLanguageService::GetCompiledFormat(const char *language, i32 phraseId, bool &hasParams)
+{
+	hasParams = false;
+	if (phraseId < 0 || phraseId >= (i32)compiledPhrases.size())
+	{
+		return nullptr;
+	}
+
+	const CompiledPhrase &phrase = compiledPhrases[phraseId];
+	hasParams = phrase.hasParams;
+
+	auto it = languageIDs.find(language);
+	i32 languageID = it != languageIDs.end() ? it->second : -1;
+	if (languageID < 0 || languageID >= (i32)phrase.formats.size() || phrase.formats[languageID].empty())
 	{
-		if (!V_stricmp(language, "#format"))
-		{
-			// It is fine to have no format.
-			return NULL;
-		}
 		// META_CONPRINTF("Warning: Phrase '%s' not found for language %s!\n", phrase, language);
-		return translationKV->FindKey(phrase)->GetString(KZ_DEFAULT_LANGUAGE);
+		languageID = defaultLanguageID;
+	}
+	if (languageID < 0 || languageID >= (i32)phrase.formats.size())
+	{
+		return "";
 	}
-	return outFormat;
+	return phrase.formats[languageID].c_str();
 }
 
 static_function SCMD_CALLBACK(Command_KzSetLanguage)
@@ -4,6 +4,17 @@
 #include "../kz.h"
 #include "../spec/kz_spec.h"
 
+// A phrase name along with its cached index into the compiled phrase table.
+// Declare these once per call site (e.g. static_persist) so hot paths only resolve the name once.
+struct KZPhrase
+{
+	KZPhrase(const char *name) : name(name) {}
+
+	const char *name;
+	i32 id = -1;
+	u32 generation = 0;
+};
+
 class KZLanguageService : public KZBaseService
 {
 	using KZBaseService::KZBaseService;
@@ -29,63 +40,43 @@ public:
 
 	const char *GetLanguage();
 
-	static const char *GetTranslatedFormat(const char *language, const char *phrase);
+	// Translations are compiled once at load time: every {param} of a phrase is replaced by the positional
+	// tinyformat specifier from its #format line, so formatting a message is a single tfm::format call.
+	static i32 FindPhrase(const char *phrase);
+	static i32 FindPhrase(KZPhrase &phrase);
+	// Returns nullptr if the phrase doesn't exist. hasParams is false if the phrase has no #format and must be printed as is.
+	static const char *GetCompiledFormat(const char *language, i32 phraseId, bool &hasParams);
 
 private:
-	static inline void ReplaceStringInPlace(std::string &subject, std::string_view search, std::string_view replace)
+	template<typename... Args>
+	static std::string GetFormattedMessage(const char *language, i32 phraseId, const char *phraseName, Args &&...args)
 	{
-		size_t pos = 0;
-		while ((pos = subject.find(search, pos)) != std::string::npos)
+		bool hasParams;
+		const char *format = GetCompiledFormat(language, phraseId, hasParams);
+		if (!format)
 		{
-			subject.replace(pos, search.length(), replace);
-			pos += replace.length();
+			// Unknown phrase, use its name as the message.
+			return tfm::format(phraseName, std::forward<Args>(args)...);
 		}
-	}
-
-	template<typename... Args>
-	static std::string GetFormattedMessage(const char *input, const char *format, Args &&...args)
-	{
-		std::string inputStr = std::string(input);
-		const char *tokenStart = format;
-		int argNumber = 0;
-		while (true)
+		if (!hasParams)
 		{
-			const char *tokenEnd = strstr(tokenStart, ":");
-			if (!tokenEnd)
-			{
-				break;
-			}
-			const char *replaceStart = tokenEnd + 1;
-			const char *replaceEnd = strstr(replaceStart, ",");
-			if (!replaceEnd)
-			{
-				replaceEnd = format + strlen(format);
-				ReplaceStringInPlace(inputStr, '{' + std::string(tokenStart, tokenEnd - tokenStart) + '}',
-									 '%' + std::to_string(++argNumber) + '$' + std::string(replaceStart, replaceEnd - replaceStart));
-				break;
-			}
-			else
-			{
-				ReplaceStringInPlace(inputStr, '{' + std::string(tokenStart, tokenEnd - tokenStart) + '}',
-									 '%' + std::to_string(++argNumber) + '$' + std::string(replaceStart, replaceEnd - replaceStart));
-				tokenStart = replaceEnd + 1;
-			}
+			// Just return the raw unformatted message if format can't be found.
+			return std::string(format);
 		}
-		return tfm::format(inputStr.c_str(), std::forward<Args>(args)...);
+		return tfm::format(format, std::forward<Args>(args)...);
 	}
 
 public:
 	template<typename... Args>
 	static std::string PrepareMessageWithLang(const char *language, const char *message, Args &&...args)
 	{
-		const char *paramFormat = GetTranslatedFormat("#format", message);
-		const char *msgFormat = GetTranslatedFormat(language, message);
-		if (!paramFormat)
-		{
-			// Just return the raw unformatted message if format can't be found.
-			return std::string(msgFormat);
-		}
-		return GetFormattedMessage(msgFormat, paramFormat, args...);
+		return GetFormattedMessage(language, FindPhrase(message), message, args...);
+	}
+
+	template<typename... Args>
+	static std::string PrepareMessageWithLang(const char *language, KZPhrase &message, Args &&...args)
+	{
+		return GetFormattedMessage(language, FindPhrase(message), message.name, args...);
 	}
 
 	template<typename... Args>
@@ -7,6 +7,7 @@
 #include "kz/trigger/kz_trigger.h"
 #include "movement/movement.h"
 #include "kz_mappingapi.h"
+#include "kz_triggerlookup.h"
 #include "entity2/entitykeyvalues.h"
 #include "sdk/entity/cbasetrigger.h"
 #include "utils/ctimer.h"
@@ -20,6 +21,12 @@
 #define KEY_TRIGGER_TYPE         "timer_trigger_type"
 #define KEY_IS_COURSE_DESCRIPTOR "timer_course_descriptor"
 
+#define MAPI_MAX_TRIGGERS 2048
+// Must be a power of two and bigger than MAPI_MAX_TRIGGERS, so that probing always hits an empty slot.
+#define MAPI_TRIGGER_LOOKUP_SIZE 4096
+// Must be a power of two and bigger than KZ_MAX_COURSE_COUNT, so that probing always hits an empty slot.
+#define MAPI_COURSE_INDEX_SIZE 256
+
 using namespace KZ::course;
 
 class CourseLessFunc
@@ -44,7 +51,8 @@ static_global struct
 	bool apiVersionLoaded;
 	bool fatalFailure;
 
-	CUtlVectorFixed<KzTrigger, 2048> triggers;
+	CUtlVectorFixed<KzTrigger, MAPI_MAX_TRIGGERS> triggers;
+	KZTriggerLookup triggerLookup;
 	bool roundIsStarting;
 	i32 errorFlags;
 	i32 errorCount;
@@ -66,6 +74,27 @@ static_function MappingInterface g_mappingInterface;
 MappingInterface *g_pMappingApi = &g_mappingInterface;
 static_global CUtlSortVector<KZCourseDescriptor *, CourseLessFunc> g_sortedCourses(KZ_MAX_COURSE_COUNT, KZ_MAX_COURSE_COUNT);
 
+enum
+{
+	MAPI_COURSE_INDEX_GUID,
+	MAPI_COURSE_INDEX_LOCAL_ID,
+	MAPI_COURSE_INDEX_GLOBAL_ID,
+	MAPI_COURSE_INDEX_NAME,
+	MAPI_COURSE_INDEX_FOLDED_NAME,
+	MAPI_COURSE_INDEX_COUNT
+};
+
+// Open addressing tables over g_sortedCourses, storing (index into g_sortedCourses + 1), 0 means empty.
+// When several courses share a key, the first one in sorted order wins, same as a linear search would.
+static_global struct
+{
+	u8 slots[MAPI_COURSE_INDEX_COUNT][MAPI_COURSE_INDEX_SIZE];
+	u32 nameHashes[KZ_MAX_COURSE_COUNT];
+	u32 foldedNameHashes[KZ_MAX_COURSE_COUNT];
+	// Lowercase copies of the course names, interned here so that case insensitive lookups don't need to fold anything.
+	char foldedNames[KZ_MAX_COURSE_COUNT][KZ_MAX_COURSE_NAME_LENGTH];
+} g_courseIndex;
+
 // TODO: add error check to make sure a course has at least 1 start zone and 1 end zone
 
 static_function void Mapi_Error(const char *format, ...)
@@ -107,6 +136,124 @@ static_function f64 Mapi_PrintErrors()
 	return 60.0;
 }
 
+// FNV-1a. Case insensitive lookups hash the lowercased name.
+static_function u32 Mapi_HashCourseName(const char *name)
+{
+	u32 hash = 2166136261u;
+	for (const char *c = name; *c; c++)
+	{
+		hash ^= (u8)*c;
+		hash *= 16777619u;
+	}
+	return hash;
+}
+
+static_function u32 Mapi_GetCourseIndexKey(i32 type, i32 sortedIndex)
+{
+	const KZCourseDescriptor *course = g_sortedCourses[sortedIndex];
+	switch (type)
+	{
+		case MAPI_COURSE_INDEX_GUID:
+			return course->guid;
+		case MAPI_COURSE_INDEX_LOCAL_ID:
+			return course->localDatabaseID;
+		case MAPI_COURSE_INDEX_GLOBAL_ID:
+			return course->globalDatabaseID;
+		case MAPI_COURSE_INDEX_NAME:
+			return g_courseIndex.nameHashes[sortedIndex];
+	}
+	return g_courseIndex.foldedNameHashes[sortedIndex];
+}
+
+static_function u32 Mapi_CourseIndexSlot(u32 key)
+{
+	// GUIDs and database IDs are small and consecutive, mix them so they don't all land in the bottom slots.
+	return ((key * 2654435769u) >> 16) & (MAPI_COURSE_INDEX_SIZE - 1);
+}
+
+// Returns the index into g_sortedCourses, or -1. The name is only compared for the name tables, already lowercased for the folded one.
+static_function i32 Mapi_FindInCourseIndex(i32 type, u32 key, const char *name = nullptr)
+{
+	const u8 *slots = g_courseIndex.slots[type];
+	for (u32 slot = Mapi_CourseIndexSlot(key); slots[slot]; slot = (slot + 1) & (MAPI_COURSE_INDEX_SIZE - 1))
+	{
+		i32 index = slots[slot] - 1;
+		if (Mapi_GetCourseIndexKey(type, index) != key)
+		{
+			continue;
+		}
+		if (type == MAPI_COURSE_INDEX_NAME && !KZ_STREQ(g_sortedCourses[index]->name, name))
+		{
+			continue;
+		}
+		if (type == MAPI_COURSE_INDEX_FOLDED_NAME && !KZ_STREQ(g_courseIndex.foldedNames[index], name))
+		{
+			continue;
+		}
+		return index;
+	}
+	return -1;
+}
+
+static_function KZCourseDescriptor *Mapi_FindCourseByKey(i32 type, u32 key, const char *name = nullptr)
+{
+	i32 index = Mapi_FindInCourseIndex(type, key, name);
+	return index == -1 ? nullptr : g_sortedCourses[index];
+}
+
+static_function void Mapi_AddToCourseIndex(i32 type, i32 sortedIndex)
+{
+	u32 key = Mapi_GetCourseIndexKey(type, sortedIndex);
+	const char *name = type == MAPI_COURSE_INDEX_FOLDED_NAME ? g_courseIndex.foldedNames[sortedIndex] : g_sortedCourses[sortedIndex]->name;
+	if (Mapi_FindInCourseIndex(type, key, name) != -1)
+	{
+		return;
+	}
+	u8 *slots = g_courseIndex.slots[type];
+	u32 slot = Mapi_CourseIndexSlot(key);
+	while (slots[slot])
+	{
+		slot = (slot + 1) & (MAPI_COURSE_INDEX_SIZE - 1);
+	}
+	slots[slot] = (u8)(sortedIndex + 1);
+}
+
+static_function void Mapi_RebuildCourseIndex(i32 type)
+{
+	V_memset(g_courseIndex.slots[type], 0, sizeof(g_courseIndex.slots[type]));
+	FOR_EACH_VEC(g_sortedCourses, i)
+	{
+		Mapi_AddToCourseIndex(type, i);
+	}
+}
+
+// Must be called whenever g_sortedCourses changes, the tables refer to courses by their position in it.
+static_function void Mapi_RebuildCourseIndexes()
+{
+	FOR_EACH_VEC(g_sortedCourses, i)
+	{
+		const char *name = g_sortedCourses[i]->name;
+		V_snprintf(g_courseIndex.foldedNames[i], sizeof(g_courseIndex.foldedNames[i]), "%s", name);
+		V_strlower(g_courseIndex.foldedNames[i]);
+		g_courseIndex.nameHashes[i] = Mapi_HashCourseName(name);
+		g_courseIndex.foldedNameHashes[i] = Mapi_HashCourseName(g_courseIndex.foldedNames[i]);
+	}
+	for (i32 type = 0; type < MAPI_COURSE_INDEX_COUNT; type++)
+	{
+		Mapi_RebuildCourseIndex(type);
+	}
+}
+
+static_function void Mapi_RebuildSortedCourses()
+{
+	g_sortedCourses.RemoveAll();
+	FOR_EACH_VEC(g_mappingApi.courseDescriptors, i)
+	{
+		g_sortedCourses.Insert(&g_mappingApi.courseDescriptors[i]);
+	}
+	Mapi_RebuildCourseIndexes();
+}
+
 static_function bool Mapi_CreateCourse(i32 courseNumber = 1, const char *courseName = KZ_NO_MAPAPI_COURSE_NAME, i32 hammerId = -1,
 									   const char *targetName = KZ_NO_MAPAPI_COURSE_DESCRIPTOR, bool disableCheckpoints = false)
 {
@@ -137,9 +284,29 @@ static_function bool Mapi_CreateCourse(i32 courseNumber = 1, const char *courseN
 	i32 index = g_mappingApi.courseDescriptors.AddToTail(
 		{hammerId, targetName, disableCheckpoints, (u32)g_mappingApi.courseDescriptors.Count() + 1, courseNumber, courseName});
 	g_sortedCourses.Insert(&g_mappingApi.courseDescriptors[index]);
+	// Sorted positions after the new course shifted.
+	Mapi_RebuildCourseIndexes();
 	return true;
 }
 
+static_function void Mapi_ClearTriggers()
+{
+	g_mappingApi.triggers.RemoveAll();
+	g_mappingApi.triggerLookup.Clear();
+}
+
+static_function void Mapi_AddTrigger(const KzTrigger &trigger)
+{
+	if (g_mappingApi.triggers.Count() >= MAPI_MAX_TRIGGERS)
+	{
+		g_mappingApi.errorFlags |= MAPI_ERR_TOO_MANY_TRIGGERS;
+		return;
+	}
+
+	i32 index = g_mappingApi.triggers.AddToTail(trigger);
+	g_mappingApi.triggerLookup.Insert(trigger.entity.GetEntryIndex(), index);
+}
+
 // Example keyvalues:
 /*
 	timer_anti_bhop_time: 0.2
@@ -331,7 +498,7 @@ static_function void Mapi_OnTriggerMultipleSpawn(const EntitySpawnInfo_t *info)
 		break;
 	}
 
-	g_mappingApi.triggers.AddToTail(trigger);
+	Mapi_AddTrigger(trigger);
 }
 
 static_function void Mapi_OnInfoTargetSpawn(const CEntityKeyValues *ekv)
@@ -390,15 +557,10 @@ static_function KzTrigger *Mapi_FindKzTrigger(CBaseTrigger *trigger)
 		return nullptr;
 	}
 
-	FOR_EACH_VEC(g_mappingApi.triggers, i)
-	{
-		if (triggerHandle == g_mappingApi.triggers[i].entity)
-		{
-			return &g_mappingApi.triggers[i];
-		}
-	}
-
-	return nullptr;
+	// The handle comparison also checks the serial number, so a reused entity index never matches a stale trigger.
+	i32 index = g_mappingApi.triggerLookup.Find(triggerHandle.GetEntryIndex(),
+												[&](i32 i) { return triggerHandle == g_mappingApi.triggers[i].entity; });
+	return index != -1 ? &g_mappingApi.triggers[index] : nullptr;
 }
 
 static_function KZCourseDescriptor *Mapi_FindCourse(const char *targetname)
@@ -594,14 +756,15 @@ void KZ::mapapi::OnSpawn(int count, const EntitySpawnInfo_t *info)
 
 	if (g_mappingApi.fatalFailure)
 	{
-		g_mappingApi.triggers.RemoveAll();
+		Mapi_ClearTriggers();
 		g_mappingApi.courseDescriptors.RemoveAll();
+		Mapi_RebuildSortedCourses();
 	}
 }
 
 void KZ::mapapi::OnRoundPreStart()
 {
-	g_mappingApi.triggers.RemoveAll();
+	Mapi_ClearTriggers();
 	g_mappingApi.roundIsStarting = true;
 }
 
@@ -687,14 +850,16 @@ void KZ::mapapi::OnRoundStart()
 
 		if (invalid)
 		{
+			// Moves the last course into this slot, g_sortedCourses is rebuilt below.
 			g_mappingApi.courseDescriptors.FastRemove(courseInd);
 			courseInd--;
-			break;
+			continue;
 		}
 		courseDescriptor->splitCount = splitCount;
 		courseDescriptor->checkpointCount = cpCount;
 		courseDescriptor->stageCount = stageCount;
 	}
+	Mapi_RebuildSortedCourses();
 }
 
 void KZ::mapapi::CheckEndTimerTrigger(CBaseTrigger *trigger)
@@ -773,6 +938,7 @@ bool MappingInterface::GetJumpstatArea(Vector &pos, QAngle &angles)
 void KZ::course::ClearCourses()
 {
 	g_sortedCourses.RemoveAll();
+	Mapi_RebuildCourseIndexes();
 	KZTimerService::ClearRecordCache();
 }
 
@@ -795,51 +961,35 @@ const KZCourseDescriptor *KZ::course::GetCourseByCourseID(i32 id)
 
 const KZCourseDescriptor *KZ::course::GetCourseByLocalCourseID(u32 id)
 {
-	FOR_EACH_VEC(g_sortedCourses, i)
-	{
-		if (g_sortedCourses[i]->localDatabaseID == id)
-		{
-			return g_sortedCourses[i];
-		}
-	}
-	return nullptr;
+	return Mapi_FindCourseByKey(MAPI_COURSE_INDEX_LOCAL_ID, id);
 }
 
 const KZCourseDescriptor *KZ::course::GetCourseByGlobalCourseID(u32 id)
 {
-	FOR_EACH_VEC(g_sortedCourses, i)
-	{
-		if (g_sortedCourses[i]->globalDatabaseID == id)
-		{
-			return g_sortedCourses[i];
-		}
-	}
-	return nullptr;
+	return Mapi_FindCourseByKey(MAPI_COURSE_INDEX_GLOBAL_ID, id);
 }
 
 const KZCourseDescriptor *KZ::course::GetCourse(const char *courseName, bool caseSensitive)
 {
-	FOR_EACH_VEC(g_sortedCourses, i)
+	if (caseSensitive)
 	{
-		const char *name = g_sortedCourses[i]->name;
-		if (caseSensitive ? KZ_STREQ(name, courseName) : KZ_STREQI(name, courseName))
-		{
-			return g_sortedCourses[i];
-		}
+		return Mapi_FindCourseByKey(MAPI_COURSE_INDEX_NAME, Mapi_HashCourseName(courseName), courseName);
 	}
-	return nullptr;
+
+	// Course names are shorter than this, so a query that doesn't fit can't match any of them.
+	char folded[KZ_MAX_COURSE_NAME_LENGTH];
+	if (V_strlen(courseName) >= (i32)sizeof(folded))
+	{
+		return nullptr;
+	}
+	V_strncpy(folded, courseName, sizeof(folded));
+	V_strlower(folded);
+	return Mapi_FindCourseByKey(MAPI_COURSE_INDEX_FOLDED_NAME, Mapi_HashCourseName(folded), folded);
 }
 
 const KZCourseDescriptor *KZ::course::GetCourse(u32 guid)
 {
-	FOR_EACH_VEC(g_sortedCourses, i)
-	{
-		if (g_sortedCourses[i]->guid == guid)
-		{
-			return g_sortedCourses[i];
-		}
-	}
-	return nullptr;
+	return Mapi_FindCourseByKey(MAPI_COURSE_INDEX_GUID, guid);
 }
 
 const KZCourseDescriptor *KZ::course::GetFirstCourse()
@@ -861,28 +1011,27 @@ void KZ::course::SetupLocalCourses()
 
 bool KZ::course::UpdateCourseLocalID(const char *courseName, u32 databaseID)
 {
-	FOR_EACH_VEC(g_sortedCourses, i)
+	KZCourseDescriptor *course = Mapi_FindCourseByKey(MAPI_COURSE_INDEX_NAME, Mapi_HashCourseName(courseName), courseName);
+	if (!course)
 	{
-		if (g_sortedCourses[i]->GetName() == courseName)
-		{
-			g_sortedCourses[i]->localDatabaseID = databaseID;
-			return true;
-		}
+		return false;
 	}
-	return false;
+	course->localDatabaseID = databaseID;
+	// The old ID might still be in the table, and another course might have had the new one first.
+	Mapi_RebuildCourseIndex(MAPI_COURSE_INDEX_LOCAL_ID);
+	return true;
 }
 
 bool KZ::course::UpdateCourseGlobalID(const char *courseName, u32 globalID)
 {
-	FOR_EACH_VEC(g_sortedCourses, i)
+	KZCourseDescriptor *course = Mapi_FindCourseByKey(MAPI_COURSE_INDEX_NAME, Mapi_HashCourseName(courseName), courseName);
+	if (!course)
 	{
-		if (g_sortedCourses[i]->GetName() == courseName)
-		{
-			g_sortedCourses[i]->globalDatabaseID = globalID;
-			return true;
-		}
+		return false;
 	}
-	return false;
+	course->globalDatabaseID = globalID;
+	Mapi_RebuildCourseIndex(MAPI_COURSE_INDEX_GLOBAL_ID);
+	return true;
 }
 
 SCMD_CALLBACK(Command_KzCourse)
@@ -0,0 +1,54 @@
+#pragma once
+
+#include "common.h"
+
+// Doesn't need the rest of the SDK, so scripts/bench-trigger-lookup.sh can build it on its own.
+
+#define MAPI_MAX_TRIGGERS 2048
+// Must be a power of two and bigger than MAPI_MAX_TRIGGERS, so that probing always hits an empty slot.
+#define MAPI_TRIGGER_LOOKUP_SIZE 4096
+
+// Open addressing table keyed by entity index, storing (index into the trigger list + 1), 0 means empty.
+struct KZTriggerLookup
+{
+	u16 slots[MAPI_TRIGGER_LOOKUP_SIZE];
+
+	static u32 Slot(u32 entryIndex)
+	{
+		// Trigger entity indices are mostly consecutive, so the index itself spreads well enough.
+		return entryIndex & (MAPI_TRIGGER_LOOKUP_SIZE - 1);
+	}
+
+	void Clear()
+	{
+		V_memset(this->slots, 0, sizeof(this->slots));
+	}
+
+	// triggerIndex must be below MAPI_MAX_TRIGGERS.
+	void Insert(u32 entryIndex, i32 triggerIndex)
+	{
+		u32 slot = Slot(entryIndex);
+		while (this->slots[slot])
+		{
+			slot = (slot + 1) & (MAPI_TRIGGER_LOOKUP_SIZE - 1);
+		}
+		this->slots[slot] = triggerIndex + 1;
+	}
+
+	// Returns the first trigger index stored for this entity index that isMatch accepts, or -1.
+	// Several triggers can share an entity index, so the caller still compares the full handle.
+	template<typename T>
+	i32 Find(u32 entryIndex, T isMatch) const
+	{
+		u32 slot = Slot(entryIndex);
+		for (u16 entry = this->slots[slot]; entry; entry = this->slots[slot])
+		{
+			if (isMatch(entry - 1))
+			{
+				return entry - 1;
+			}
+			slot = (slot + 1) & (MAPI_TRIGGER_LOOKUP_SIZE - 1);
+		}
+		return -1;
+	}
+};
@@ -19,6 +19,7 @@
 #include "kz/timer/kz_timer.h"
 #include "kz/tip/kz_tip.h"
 #include "kz/global/kz_global.h"
+#include "kz/db/kz_db.h"
 
 #include "sdk/gamerules.h"
 
@@ -366,6 +367,7 @@ void KZ::misc::RegisterCommands()
 	KZHUDService::RegisterCommands();
 	KZLanguageService::RegisterCommands();
 	KZGlobalService::RegisterCommands();
+	KZDatabaseService::RegisterCommands();
 	KZ::mode::RegisterCommands();
 	KZ::style::RegisterCommands();
 	KZ::course::RegisterCommands();
@@ -15,6 +15,8 @@
 #include "utils/simplecmds.h"
 #include "utils/plat.h"
 
+#include "vprof.h"
+
 static_function SCMD_CALLBACK(Command_KzModeShort);
 static_function SCMD_CALLBACK(Command_KzMode);
 
@@ -23,6 +25,49 @@ KZModeManager *g_pKZModeManager = &modeManager;
 
 CUtlVector<KZModeManager::ModePluginInfo> modeInfos;
 
+// Mode cvar values of a player's mode, parsed once when the mode service is created.
+struct ModeCvarProfile
+{
+	// The string values this was parsed from, shared by every player using the same mode.
+	const char **source;
+	CVValue_t values[MODECVAR_COUNT];
+};
+
+static_global ModeCvarProfile modeCvarProfiles[MAXPLAYERS + 1];
+
+// The profile currently written to the mode cvars, and the tick it was written on.
+static_global struct
+{
+	const char **source;
+	i32 tickcount;
+} appliedModeCvarProfile;
+
+static_function void CompileModeCvarProfile(KZPlayer *player)
+{
+	ModeCvarProfile &profile = modeCvarProfiles[player->index];
+	profile.source = player->modeService->GetModeConVarValues();
+
+	for (u32 i = 0; i < MODECVAR_COUNT; i++)
+	{
+		if (KZ::mode::modeCvars[i]->m_eVarType == EConVarType_Float32)
+		{
+			profile.values[i].m_flValue = atof(profile.source[i]);
+		}
+		else if (V_stricmp(profile.source[i], "true") == 0)
+		{
+			profile.values[i].m_i32Value = 1;
+		}
+		else if (V_stricmp(profile.source[i], "false") == 0)
+		{
+			profile.values[i].m_i32Value = 0;
+		}
+		else
+		{
+			profile.values[i].m_i32Value = atoi(profile.source[i]);
+		}
+	}
+}
+
 static_global class KZDatabaseServiceEventListener_Modes : public KZDatabaseServiceEventListener
 {
 public:
@@ -116,6 +161,7 @@ void KZ::mode::InitModeService(KZPlayer *player)
 {
 	delete player->modeService;
 	player->modeService = new KZVanillaModeService(player);
+	CompileModeCvarProfile(player);
 }
 
 void KZ::mode::DisableReplicatedModeCvars()
@@ -138,33 +184,34 @@ void KZ::mode::EnableReplicatedModeCvars()
 
 void KZ::mode::ApplyModeSettings(KZPlayer *player)
 {
+	VPROF_BUDGET(__func__, "CS2KZ");
+	player->enableWaterFix = player->modeService->EnableWaterFix();
+
+	const ModeCvarProfile &profile = modeCvarProfiles[player->index];
+	i32 tickcount = g_pKZUtils->GetGlobals()->tickcount;
+
+	// The previous player this tick used the same mode, the cvars already hold the right values.
+	// Other ticks are always rewritten in case something else changed the cvars in between.
+	if (appliedModeCvarProfile.source == profile.source && appliedModeCvarProfile.tickcount == tickcount)
+	{
+		return;
+	}
+
 	for (u32 i = 0; i < MODECVAR_COUNT; i++)
 	{
 		auto value = reinterpret_cast<CVValue_t *>(&(modeCvars[i]->values));
 		if (modeCvars[i]->m_eVarType == EConVarType_Float32)
 		{
-			f32 newValue = atof(player->modeService->GetModeConVarValues()[i]);
-			value->m_flValue = newValue;
+			value->m_flValue = profile.values[i].m_flValue;
 		}
 		else
 		{
-			i32 newValue;
-			if (V_stricmp(player->modeService->GetModeConVarValues()[i], "true") == 0)
-			{
-				newValue = 1;
-			}
-			else if (V_stricmp(player->modeService->GetModeConVarValues()[i], "false") == 0)
-			{
-				newValue = 0;
-			}
-			else
-			{
-				newValue = atoi(player->modeService->GetModeConVarValues()[i]);
-			}
-			value->m_i32Value = newValue;
+			value->m_i32Value = profile.values[i].m_i32Value;
 		}
 	}
-	player->enableWaterFix = player->modeService->EnableWaterFix();
+
+	appliedModeCvarProfile.source = profile.source;
+	appliedModeCvarProfile.tickcount = tickcount;
 }
 
 bool KZModeManager::RegisterMode(PluginId id, const char *shortModeName, const char *longModeName, ModeServiceFactory factory)
@@ -303,6 +350,7 @@ bool KZModeManager::SwitchToMode(KZPlayer *player, const char *modeName, bool si
 	player->modeService->Cleanup();
 	delete player->modeService;
 	player->modeService = factory(player);
+	CompileModeCvarProfile(player);
 	player->timerService->TimerStop();
 	player->modeService->Init();
 
@@ -338,6 +386,7 @@ void KZModeManager::Cleanup()
 		pluginManager->Unload(modeInfos[i].id, true, error, sizeof(error));
 	}
 	// Restore cvars to normal values.
+	appliedModeCvarProfile.source = nullptr;
 	for (u32 i = 0; i < MODECVAR_COUNT; i++)
 	{
 		auto value = reinterpret_cast<CVValue_t *>(&(KZ::mode::modeCvars[i]->values));
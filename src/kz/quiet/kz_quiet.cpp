@@ -6,9 +6,12 @@
 #include "sdk/services.h"
 
 #include "kz_quiet.h"
+#include "kz_quiet_matrix.h"
 #include "kz/option/kz_option.h"
 #include "utils/utils.h"
 
+#include "vprof.h"
+
 static_global class KZOptionServiceEventListener_Quiet : public KZOptionServiceEventListener
 {
 	virtual void OnPlayerPreferencesLoaded(KZPlayer *player)
@@ -17,15 +20,57 @@ static_global class KZOptionServiceEventListener_Quiet : public KZOptionServiceE
 	}
 } optionEventListener;
 
+// Offset of the target player slot in CCheckTransmitInfo, resolved once in KZQuietService::Init.
+static_global i32 quietPlayerSlotOffset = -1;
+
+// Player slots that currently hide other players, kept up to date by KZQuietService::UpdateHidingMask.
+static_global u64 hidingPlayers;
+
+// Who hides whom, rebuilt on the first CheckTransmit of every tick so that every target is a couple of bit operations.
+static_global KZHideMatrix hideMatrix;
+
+static_function void UpdateHideMatrix()
+{
+	i32 tick = g_pKZUtils->GetGlobals()->tickcount;
+	if (hideMatrix.tick == tick)
+	{
+		return;
+	}
+	hideMatrix.Reset(tick);
+
+	EntityInstanceByClassIter_t iter(NULL, "player");
+	// clang-format off
+	for (CCSPlayerPawn *pawn = static_cast<CCSPlayerPawn *>(iter.First());
+		 pawn != NULL;
+		 pawn = pawn->m_pEntity->m_pNextByClass ? static_cast<CCSPlayerPawn *>(pawn->m_pEntity->m_pNextByClass->m_pInstance) : nullptr)
+	// clang-format on
+	{
+		if (!pawn->m_hController().IsValid())
+		{
+			hideMatrix.AddOrphan(pawn->entindex());
+			continue;
+		}
+		KZPlayer *player = g_pKZPlayerManager->ToPlayer(pawn);
+		if (!player)
+		{
+			continue;
+		}
+		hideMatrix.AddPawn(player->GetPlayerSlot().Get(), pawn->entindex());
+	}
+	hideMatrix.Build(hidingPlayers);
+}
+
 void KZ::quiet::OnCheckTransmit(CCheckTransmitInfo **pInfo, int infoCount)
 {
+	VPROF_BUDGET(__func__, "CS2KZ");
+	UpdateHideMatrix();
 	for (int i = 0; i < infoCount; i++)
 	{
 		// Cast it to our own TransmitInfo struct because CCheckTransmitInfo isn't correct.
 		TransmitInfo *pTransmitInfo = reinterpret_cast<TransmitInfo *>(pInfo[i]);
 
 		// Find out who this info will be sent to.
-		uintptr_t targetAddr = reinterpret_cast<uintptr_t>(pTransmitInfo) + g_pGameConfig->GetOffset("QuietPlayerSlot");
+		uintptr_t targetAddr = reinterpret_cast<uintptr_t>(pTransmitInfo) + quietPlayerSlotOffset;
 		CPlayerSlot targetSlot = CPlayerSlot(*reinterpret_cast<int *>(targetAddr));
 		KZPlayer *targetPlayer = g_pKZPlayerManager->ToPlayer(targetSlot);
 		// Make sure the target isn't CSTV.
@@ -35,122 +80,96 @@ void KZ::quiet::OnCheckTransmit(CCheckTransmitInfo **pInfo, int infoCount)
 			continue;
 		}
 		targetPlayer->quietService->UpdateHideState();
-		CCSPlayerPawn *targetPlayerPawn = targetPlayer->GetPlayerPawn();
 
-		EntityInstanceByClassIter_t iter(NULL, "player");
-		// clang-format off
-		for (CCSPlayerPawn *pawn = static_cast<CCSPlayerPawn *>(iter.First());
-			 pawn != NULL;
-			 pawn = pawn->m_pEntity->m_pNextByClass ? static_cast<CCSPlayerPawn *>(pawn->m_pEntity->m_pNextByClass->m_pInstance) : nullptr)
-		// clang-format on
+		// Hide weapon stuff.
+		CCSPlayerPawn *targetPlayerPawn = targetPlayer->GetPlayerPawn();
+		if (targetPlayerPawn && targetPlayerPawn->m_pViewModelServices)
 		{
-			if (targetPlayerPawn == pawn)
+			for (u32 j = 0; j < 3; j++)
 			{
-				for (u32 j = 0; j < 3; j++)
+				if (!targetPlayerPawn->m_pViewModelServices->m_hViewModel[j].IsValid())
 				{
-					if (!pawn->m_pViewModelServices->m_hViewModel[j].IsValid())
-					{
-						continue;
-					}
-					// Hide weapon stuff.
-					if (targetPlayer->quietService->ShouldHideWeapon(j))
-					{
-						pTransmitInfo->m_pTransmitEdict->Clear(pawn->m_pViewModelServices->m_hViewModel[j].GetEntryIndex());
-					}
+					continue;
+				}
+				if (targetPlayer->quietService->ShouldHideWeapon(j))
+				{
+					pTransmitInfo->m_pTransmitEdict->Clear(targetPlayerPawn->m_pViewModelServices->m_hViewModel[j].GetEntryIndex());
 				}
-				continue;
-			}
-			// Bit is not even set, don't bother.
-			if (!pTransmitInfo->m_pTransmitEdict->IsBitSet(pawn->entindex()))
-			{
-				continue;
-			}
-			// Do not transmit a pawn without any controller to prevent crashes.
-			if (!pawn->m_hController().IsValid())
-			{
-				pTransmitInfo->m_pTransmitEdict->Clear(pawn->entindex());
-				continue;
-			}
-			// Respawn must be enabled or !hide will cause client crash.
-#if 0
-			// Never send dead players to prevent crashes.
-			if (pawn->m_lifeState() != LIFE_ALIVE)
-			{
-				pTransmitInfo->m_pTransmitEdict->Clear(pawn->entindex());
-				continue;
-			}
-#endif
-			// Finally check if player is using !hide.
-			if (!targetPlayer->quietService->ShouldHide())
-			{
-				continue;
-			}
-			u32 index = g_pKZPlayerManager->ToPlayer(pawn)->index;
-			if (targetPlayer->quietService->ShouldHideIndex(index))
-			{
-				pTransmitInfo->m_pTransmitEdict->Clear(pawn->entindex());
 			}
 		}
+
+		hideMatrix.Apply(targetSlot.Get(), *pTransmitInfo->m_pTransmitEdict);
 	}
 }
 
-void KZ::quiet::OnPostEvent(INetworkMessageInternal *pEvent, const CNetMessage *pData, const uint64 *clients)
+// Per message handlers, they return the entity index the message comes from or -1 if there's nothing more to filter.
+typedef i32 (*QuietMessageHandler)(const CNetMessage *pData, uint64 *clients);
+
+#define KZ_QUIET_MESSAGE_TABLE_SIZE 1024
+
+static_global QuietMessageHandler messageHandlers[KZ_QUIET_MESSAGE_TABLE_SIZE];
+
+// Hide bullet decals, and sound.
+static_function i32 HandleFireBullets(const CNetMessage *pData, uint64 *clients)
+{
+	return const_cast<CNetMessage *>(pData)->ToPB<CMsgTEFireBullets>()->player() & 0x3FFF;
+}
+
+// Hide reload sounds.
+static_function i32 HandleWeaponSound(const CNetMessage *pData, uint64 *clients)
+{
+	return const_cast<CNetMessage *>(pData)->ToPB<CCSUsrMsg_WeaponSound>()->entidx();
+}
+
+// Hide other sounds from player (eg. armor equipping)
+static_function i32 HandleStartSoundEvent(const CNetMessage *pData, uint64 *clients)
 {
-	NetMessageInfo_t *info = pEvent->GetNetMessageInfo();
-	u32 entIndex, playerIndex;
+	return const_cast<CNetMessage *>(pData)->ToPB<CMsgSosStartSoundEvent>()->source_entity_index();
+}
 
-	switch (info->m_MessageId)
+// Used by kz_misc to block valve's player say messages.
+static_function i32 HandleSayText(const CNetMessage *pData, uint64 *clients)
+{
+	if (KZOptionService::GetOptionInt("overridePlayerChat", true))
 	{
-		// Hide bullet decals, and sound.
-		case GE_FireBulletsId:
-		{
-			auto msg = const_cast<CNetMessage *>(pData)->ToPB<CMsgTEFireBullets>();
-			entIndex = msg->player() & 0x3FFF;
-			break;
-		}
-		// Hide reload sounds.
-		case CS_UM_WeaponSound:
-		{
-			auto msg = const_cast<CNetMessage *>(pData)->ToPB<CCSUsrMsg_WeaponSound>();
-			entIndex = msg->entidx();
-			break;
-		}
-		// Hide other sounds from player (eg. armor equipping)
-		case GE_SosStartSoundEvent:
-		{
-			auto msg = const_cast<CNetMessage *>(pData)->ToPB<CMsgSosStartSoundEvent>();
-			entIndex = msg->source_entity_index();
-			break;
-		}
-		// Used by kz_misc to block valve's player say messages.
-		case CS_UM_SayText:
-		case UM_SayText:
-		{
-			if (!KZOptionService::GetOptionInt("overridePlayerChat", true))
-			{
-				return;
-			}
-			*(uint64 *)clients = 0;
-			return;
-		}
-		case CS_UM_SayText2:
-		case UM_SayText2:
-		{
-			if (!KZOptionService::GetOptionInt("overridePlayerChat", true))
-			{
-				return;
-			}
-			auto msg = const_cast<CNetMessage *>(pData)->ToPB<CUserMessageSayText2>();
-			if (!msg->mutable_param1()->empty() || !msg->mutable_param2()->empty())
-			{
-				*(uint64 *)clients = 0;
-			}
-			return;
-		}
-		default:
-		{
-			return;
-		}
+		*clients = 0;
+	}
+	return -1;
+}
+
+static_function i32 HandleSayText2(const CNetMessage *pData, uint64 *clients)
+{
+	if (!KZOptionService::GetOptionInt("overridePlayerChat", true))
+	{
+		return -1;
+	}
+	auto msg = const_cast<CNetMessage *>(pData)->ToPB<CUserMessageSayText2>();
+	if (!msg->mutable_param1()->empty() || !msg->mutable_param2()->empty())
+	{
+		*clients = 0;
+	}
+	return -1;
+}
+
+static_function void RegisterMessageHandler(u32 messageID, QuietMessageHandler handler)
+{
+	assert(messageID < KZ_QUIET_MESSAGE_TABLE_SIZE);
+	messageHandlers[messageID] = handler;
+}
+
+void KZ::quiet::OnPostEvent(INetworkMessageInternal *pEvent, const CNetMessage *pData, const uint64 *clients)
+{
+	VPROF_BUDGET(__func__, "CS2KZ");
+	u32 messageID = pEvent->GetNetMessageInfo()->m_MessageId;
+	if (messageID >= KZ_QUIET_MESSAGE_TABLE_SIZE || !messageHandlers[messageID])
+	{
+		return;
+	}
+	i32 entIndex = messageHandlers[messageID](pData, const_cast<uint64 *>(clients));
+	// Nobody hides anything, no need to look the entity up.
+	if (entIndex < 0 || !hidingPlayers)
+	{
+		return;
 	}
 	CBaseEntity *ent = static_cast<CBaseEntity *>(GameEntitySystem()->GetEntityInstance(CEntityIndex(entIndex)));
 	if (!ent)
@@ -158,36 +177,35 @@ void KZ::quiet::OnPostEvent(INetworkMessageInternal *pEvent, const CNetMessage *
 		return;
 	}
 
-	// Convert this entindex into the index in the player controller.
+	// Everyone that hides other players except the player that the event comes from.
 	if (ent->IsPawn())
 	{
 		CBasePlayerPawn *pawn = static_cast<CBasePlayerPawn *>(ent);
-		playerIndex = g_pKZPlayerManager->ToPlayer(utils::GetController(pawn))->index;
-		for (int i = 0; i < MAXPLAYERS; i++)
+		KZPlayer *player = g_pKZPlayerManager->ToPlayer(utils::GetController(pawn));
+		if (player)
 		{
-			if (g_pKZPlayerManager->ToPlayer(i)->quietService->ShouldHide()
-				&& g_pKZPlayerManager->ToPlayer(i)->quietService->ShouldHideIndex(playerIndex))
-			{
-				*(uint64 *)clients &= ~i;
-			}
+			*(uint64 *)clients &= ~(hidingPlayers & ~(1ull << player->GetPlayerSlot().Get()));
 		}
 	}
 	// Special case for the armor sound upon spawning/respawning.
 	else if (V_strcmp(ent->GetClassname(), "item_assaultsuit") == 0 || V_strstr(ent->GetClassname(), "weapon_"))
 	{
-		for (int i = 0; i < MAXPLAYERS; i++)
-		{
-			if (g_pKZPlayerManager->ToPlayer(i)->quietService->ShouldHide())
-			{
-				*(uint64 *)clients &= ~i;
-			}
-		}
+		*(uint64 *)clients &= ~hidingPlayers;
 	}
 }
 
 void KZQuietService::Init()
 {
 	KZOptionService::RegisterEventListener(&optionEventListener);
+	quietPlayerSlotOffset = g_pGameConfig->GetOffset("QuietPlayerSlot");
+
+	RegisterMessageHandler(GE_FireBulletsId, HandleFireBullets);
+	RegisterMessageHandler(CS_UM_WeaponSound, HandleWeaponSound);
+	RegisterMessageHandler(GE_SosStartSoundEvent, HandleStartSoundEvent);
+	RegisterMessageHandler(CS_UM_SayText, HandleSayText);
+	RegisterMessageHandler(UM_SayText, HandleSayText);
+	RegisterMessageHandler(CS_UM_SayText2, HandleSayText2);
+	RegisterMessageHandler(UM_SayText2, HandleSayText2);
 }
 
 void KZQuietService::Reset()
@@ -195,6 +213,21 @@ void KZQuietService::Reset()
 	this->hideOtherPlayers = this->player->optionService->GetPreferenceBool("hideOtherPlayers", false);
 	this->hideWeapon = this->player->optionService->GetPreferenceBool("hideWeapon", false);
 	this->ResetHideWeapon();
+	this->UpdateHidingMask(this->player->IsAlive());
+}
+
+void KZQuietService::UpdateHidingMask(bool alive)
+{
+	u64 bit = 1ull << this->player->GetPlayerSlot().Get();
+	// If the player is not alive, don't hide other players.
+	if (this->hideOtherPlayers && alive)
+	{
+		hidingPlayers |= bit;
+	}
+	else
+	{
+		hidingPlayers &= ~bit;
+	}
 }
 
 void KZQuietService::SendFullUpdate()
@@ -252,12 +285,14 @@ void KZQuietService::OnPlayerPreferencesLoaded()
 		this->SendFullUpdate();
 	}
 	this->hideOtherPlayers = newShouldHide;
+	this->UpdateHidingMask(this->player->IsAlive());
 }
 
 void KZQuietService::ToggleHide()
 {
 	this->hideOtherPlayers = !this->hideOtherPlayers;
 	this->player->optionService->SetPreferenceBool("hideOtherPlayers", this->hideOtherPlayers);
+	this->UpdateHidingMask(this->player->IsAlive());
 	if (!this->hideOtherPlayers)
 	{
 		this->SendFullUpdate();
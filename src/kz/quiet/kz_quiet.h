@@ -29,6 +29,8 @@ public:
 	void SendFullUpdate();
 	bool ShouldHide();
 	bool ShouldHideIndex(u32 targetIndex);
+	// Call whenever the hide preference or the life state changes, sound and bullet filtering reads the mask directly.
+	void UpdateHidingMask(bool alive);
 
 	void ResetHideWeapon()
 	{
@@ -0,0 +1,63 @@
+#pragma once
+
+#include "common.h"
+#include "utlvector.h"
+
+// Doesn't need the rest of the SDK, so scripts/bench-quiet.sh can build and apply it on its own.
+
+// Which pawns every player slot hides this tick, built once per tick and read by every CheckTransmit info.
+struct KZHideMatrix
+{
+	i32 tick = -1;
+	// Bit j of row i is set if player slot i doesn't get to see player slot j's pawn.
+	u64 hide[MAXPLAYERS];
+	u32 pawnEntIndex[MAXPLAYERS];
+	// Pawns without a controller crash clients, they are never transmitted to anyone.
+	CUtlVector<u32> orphanPawns;
+	u64 pawns;
+
+	void Reset(i32 tick)
+	{
+		this->tick = tick;
+		this->orphanPawns.RemoveAll();
+		this->pawns = 0;
+	}
+
+	void AddPawn(u32 slot, u32 entIndex)
+	{
+		this->pawns |= 1ull << slot;
+		this->pawnEntIndex[slot] = entIndex;
+	}
+
+	void AddOrphan(u32 entIndex)
+	{
+		this->orphanPawns.AddToTail(entIndex);
+	}
+
+	void Build(u64 hidingPlayers)
+	{
+		for (u32 i = 0; i < MAXPLAYERS; i++)
+		{
+			// Don't self-hide.
+			this->hide[i] = (hidingPlayers & (1ull << i)) ? this->pawns & ~(1ull << i) : 0;
+		}
+	}
+
+	// Clears the pawns the target slot shouldn't receive from its transmit bits.
+	template<typename T>
+	void Apply(u32 targetSlot, T &transmitEdict) const
+	{
+		FOR_EACH_VEC(this->orphanPawns, j)
+		{
+			transmitEdict.Clear(this->orphanPawns[j]);
+		}
+		u64 hidden = this->hide[targetSlot];
+		for (u32 j = 0; hidden; j++, hidden >>= 1)
+		{
+			if (hidden & 1)
+			{
+				transmitEdict.Clear(this->pawnEntIndex[j]);
+			}
+		}
+	}
+};
@@ -1 +1,207 @@
+#include <condition_variable>
+#include <cstdio>
+#include <ctime>
+#include <deque>
+#include <filesystem>
+#include <mutex>
+#include <thread>
+
 #include "kz_replays.h"
+#include "kz/mode/kz_mode.h"
+#include "kz/timer/kz_timer.h"
+#include "kz/mappingapi/kz_mappingapi.h"
+#include "utils/utils.h"
+
+#include "vprof.h"
+
+static_global class KZTimerServiceEventListener_Replays : public KZTimerServiceEventListener
+{
+	virtual void OnTimerStartPost(KZPlayer *player, u32 courseGUID) override
+	{
+		player->replayService->OnTimerStart();
+	}
+
+	virtual void OnTimerEndPost(KZPlayer *player, u32 courseGUID, f32 time, u32 teleportsUsed) override
+	{
+		player->replayService->OnTimerEnd(courseGUID, time, teleportsUsed);
+	}
+
+	virtual void OnTimerStopped(KZPlayer *player, u32 courseGUID) override
+	{
+		player->replayService->OnTimerStop();
+	}
+
+	virtual void OnTimerInvalidated(KZPlayer *player) override
+	{
+		player->replayService->OnTimerStop();
+	}
+} timerEventListener;
+
+struct ReplayWrite
+{
+	std::string path;
+	std::vector<u8> header;
+	std::vector<ReplayChunk> chunks;
+};
+
+// Finished runs are written to disk by a single worker, which is joined on unload so no write outlives the plugin.
+static_global struct
+{
+	std::thread thread;
+	std::mutex mutex;
+	std::condition_variable wake;
+	std::deque<ReplayWrite> queue;
+	bool stopping;
+} g_replayWriter;
+
+static_function void WriteReplay(const ReplayWrite &replay)
+{
+	std::error_code error;
+	std::filesystem::create_directories(std::filesystem::path(replay.path).parent_path(), error);
+	FILE *file = fopen(replay.path.c_str(), "wb");
+	if (!file)
+	{
+		META_CONPRINTF("[KZ::Replays] Failed to open %s for writing.\n", replay.path.c_str());
+		return;
+	}
+	bool ok = fwrite(replay.header.data(), 1, replay.header.size(), file) == replay.header.size();
+	std::vector<u8> chunkHeader;
+	for (const ReplayChunk &chunk : replay.chunks)
+	{
+		chunkHeader.clear();
+		KZ::replays::WriteChunkHeader(chunk, chunkHeader);
+		ok = ok && fwrite(chunkHeader.data(), 1, chunkHeader.size(), file) == chunkHeader.size();
+		ok = ok && fwrite(chunk.data.data(), 1, chunk.data.size(), file) == chunk.data.size();
+	}
+	fclose(file);
+	if (!ok)
+	{
+		META_CONPRINTF("[KZ::Replays] Failed to write %s.\n", replay.path.c_str());
+		std::filesystem::remove(replay.path, error);
+	}
+}
+
+static_function void ReplayWriterThread()
+{
+	std::unique_lock lock(g_replayWriter.mutex);
+	while (true)
+	{
+		g_replayWriter.wake.wait(lock, []() { return g_replayWriter.stopping || !g_replayWriter.queue.empty(); });
+		// Replays still queued when stopping are written before the thread exits.
+		if (g_replayWriter.queue.empty())
+		{
+			return;
+		}
+		ReplayWrite replay = std::move(g_replayWriter.queue.front());
+		g_replayWriter.queue.pop_front();
+		lock.unlock();
+		WriteReplay(replay);
+		lock.lock();
+	}
+}
+
+void KZReplayService::Init()
+{
+	KZTimerService::RegisterEventListener(&timerEventListener);
+	if (!g_replayWriter.thread.joinable())
+	{
+		g_replayWriter.stopping = false;
+		g_replayWriter.thread = std::thread(ReplayWriterThread);
+	}
+}
+
+void KZReplayService::Cleanup()
+{
+	if (!g_replayWriter.thread.joinable())
+	{
+		return;
+	}
+	{
+		std::lock_guard lock(g_replayWriter.mutex);
+		g_replayWriter.stopping = true;
+	}
+	g_replayWriter.wake.notify_one();
+	g_replayWriter.thread.join();
+}
+
+void KZReplayService::Reset()
+{
+	this->buffer.Clear();
+	this->runStartTick = -1;
+}
+
+void KZReplayService::OnProcessMovementPost()
+{
+	VPROF_BUDGET(__func__, "CS2KZ");
+	if (!this->player->IsAlive())
+	{
+		return;
+	}
+	ReplayTick tick;
+	tick.tick = g_pKZUtils->GetGlobals()->tickcount;
+	this->player->GetOrigin(&tick.origin);
+	this->player->GetAngles(&tick.angles);
+	this->player->GetVelocity(&tick.velocity);
+	tick.buttons = this->player->GetMoveServices()->m_nButtons()->m_pButtonStates[0];
+	tick.flags = this->player->GetPlayerPawn()->m_fFlags();
+	this->buffer.Append(tick);
+}
+
+void KZReplayService::OnTimerStart()
+{
+	this->runStartTick = g_pKZUtils->GetGlobals()->tickcount;
+}
+
+void KZReplayService::OnTimerStop()
+{
+	this->runStartTick = -1;
+}
+
+void KZReplayService::OnTimerEnd(u32 courseGUID, f32 time, u32 teleportsUsed)
+{
+	if (this->runStartTick < 0)
+	{
+		return;
+	}
+	const KZCourseDescriptor *course = KZ::course::GetCourse(courseGUID);
+	bool ok;
+	CUtlString mapName = g_pKZUtils->GetCurrentMapName(&ok);
+	if (!course || !ok)
+	{
+		return;
+	}
+
+	ReplayHeader header;
+	header.steamID64 = this->player->GetSteamId64();
+	V_snprintf(header.map, sizeof(header.map), "%s", mapName.Get());
+	V_snprintf(header.course, sizeof(header.course), "%s", course->name);
+	V_snprintf(header.mode, sizeof(header.mode), "%s", this->player->modeService->GetModeShortName());
+	header.time = time;
+	header.teleports = teleportsUsed;
+	header.tickInterval = ENGINE_FIXED_TICK_INTERVAL;
+	header.startTick = this->runStartTick;
+
+	std::vector<ReplayChunk> chunks;
+	this->buffer.CopyChunks(this->runStartTick, chunks);
+	header.chunkCount = (u32)chunks.size();
+	this->runStartTick = -1;
+	if (chunks.empty())
+	{
+		return;
+	}
+
+	ReplayWrite replay;
+	KZ::replays::WriteHeader(header, replay.header);
+
+	char path[512];
+	V_snprintf(path, sizeof(path), "%s/addons/cs2kz/replays/%s/%llu_%i_%s_%lli.replay", g_SMAPI->GetBaseDir(), mapName.Get(), header.steamID64,
+			   course->id, header.mode, (i64)std::time(nullptr));
+	replay.path = path;
+	// The chunks are copies, the recording goes on while the file is being written.
+	replay.chunks = std::move(chunks);
+	{
+		std::lock_guard lock(g_replayWriter.mutex);
+		g_replayWriter.queue.push_back(std::move(replay));
+	}
+	g_replayWriter.wake.notify_one();
+}
@@ -1,7 +1,25 @@
 #pragma once
 #include "../kz.h"
+#include "replay_format.h"
 
 class KZReplayService : public KZBaseService
 {
 	using KZBaseService::KZBaseService;
+
+private:
+	ReplayBuffer buffer;
+	// Tick the current run started on, -1 if there is no run.
+	i32 runStartTick = -1;
+
+public:
+	static void Init();
+	// Waits for the replays that are still being written.
+	static void Cleanup();
+
+	virtual void Reset() override;
+	void OnProcessMovementPost();
+
+	void OnTimerStart();
+	void OnTimerStop();
+	void OnTimerEnd(u32 courseGUID, f32 time, u32 teleportsUsed);
 };
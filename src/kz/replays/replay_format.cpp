@@ -0,0 +1,382 @@
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+
+#include "replay_format.h"
+
+#define ANGLE_RANGE ((i32)(360 * KZ_REPLAY_ANGLE_SCALE))
+
+static_function void WriteVarint(std::vector<u8> &out, u64 value)
+{
+	while (value >= 0x80)
+	{
+		out.push_back((u8)(value | 0x80));
+		value >>= 7;
+	}
+	out.push_back((u8)value);
+}
+
+static_function void WriteZigzag(std::vector<u8> &out, i32 value)
+{
+	WriteVarint(out, ((u32)value << 1) ^ (u32)(value >> 31));
+}
+
+static_function bool ReadVarint(const u8 *&cursor, const u8 *end, u64 &value)
+{
+	value = 0;
+	for (u32 shift = 0; shift < 64; shift += 7)
+	{
+		if (cursor >= end)
+		{
+			return false;
+		}
+		u8 byte = *cursor++;
+		value |= (u64)(byte & 0x7F) << shift;
+		if (!(byte & 0x80))
+		{
+			return true;
+		}
+	}
+	return false;
+}
+
+static_function bool ReadZigzag(const u8 *&cursor, const u8 *end, i32 &value)
+{
+	u64 raw;
+	if (!ReadVarint(cursor, end, raw))
+	{
+		return false;
+	}
+	value = (i32)((u32)raw >> 1) ^ -(i32)(raw & 1);
+	return true;
+}
+
+static_function i32 Quantize(f32 value, f32 scale)
+{
+	return (i32)roundf(value * scale);
+}
+
+static_function i32 WrapAngleDelta(i32 delta)
+{
+	delta %= ANGLE_RANGE;
+	if (delta >= ANGLE_RANGE / 2)
+	{
+		delta -= ANGLE_RANGE;
+	}
+	else if (delta < -ANGLE_RANGE / 2)
+	{
+		delta += ANGLE_RANGE;
+	}
+	return delta;
+}
+
+void KZ::replays::EncodeTick(ReplayCodecState &state, const ReplayTick &tick, std::vector<u8> &out)
+{
+	u32 tickGap = (u32)tick.tick - (u32)state.tick - 1;
+
+	i32 originResidual[3], velocityDelta[3], angleDelta[2];
+	bool originChanged = false, velocityChanged = false, anglesChanged = false;
+	for (u32 i = 0; i < 3; i++)
+	{
+		i32 origin = Quantize(tick.origin[i], KZ_REPLAY_ORIGIN_SCALE);
+		originResidual[i] = origin - (state.origin[i] + state.originDelta[i]);
+		state.originDelta[i] = origin - state.origin[i];
+		state.origin[i] = origin;
+		originChanged |= originResidual[i] != 0;
+
+		i32 velocity = Quantize(tick.velocity[i], KZ_REPLAY_VELOCITY_SCALE);
+		velocityDelta[i] = velocity - state.velocity[i];
+		state.velocity[i] = velocity;
+		velocityChanged |= velocityDelta[i] != 0;
+	}
+	for (u32 i = 0; i < 2; i++)
+	{
+		// Keep the wrapped value so the state matches what the decoder reconstructs.
+		angleDelta[i] = WrapAngleDelta(Quantize(tick.angles[i], KZ_REPLAY_ANGLE_SCALE) - state.angles[i]);
+		state.angles[i] += angleDelta[i];
+		anglesChanged |= angleDelta[i] != 0;
+	}
+	u64 buttonChanges = tick.buttons ^ state.buttons;
+	u32 flagChanges = tick.flags ^ state.flags;
+	state.tick = tick.tick;
+	state.buttons = tick.buttons;
+	state.flags = tick.flags;
+
+	u8 mask = (tickGap ? REPLAYFIELD_TICK : 0) | (originChanged ? REPLAYFIELD_ORIGIN : 0) | (anglesChanged ? REPLAYFIELD_ANGLES : 0)
+			  | (velocityChanged ? REPLAYFIELD_VELOCITY : 0) | (buttonChanges ? REPLAYFIELD_BUTTONS : 0) | (flagChanges ? REPLAYFIELD_FLAGS : 0);
+	out.push_back(mask);
+	if (mask & REPLAYFIELD_TICK)
+	{
+		WriteVarint(out, tickGap);
+	}
+	if (mask & REPLAYFIELD_ORIGIN)
+	{
+		WriteZigzag(out, originResidual[0]);
+		WriteZigzag(out, originResidual[1]);
+		WriteZigzag(out, originResidual[2]);
+	}
+	if (mask & REPLAYFIELD_ANGLES)
+	{
+		WriteZigzag(out, angleDelta[0]);
+		WriteZigzag(out, angleDelta[1]);
+	}
+	if (mask & REPLAYFIELD_VELOCITY)
+	{
+		WriteZigzag(out, velocityDelta[0]);
+		WriteZigzag(out, velocityDelta[1]);
+		WriteZigzag(out, velocityDelta[2]);
+	}
+	if (mask & REPLAYFIELD_BUTTONS)
+	{
+		WriteVarint(out, buttonChanges);
+	}
+	if (mask & REPLAYFIELD_FLAGS)
+	{
+		WriteVarint(out, flagChanges);
+	}
+}
+
+bool KZ::replays::DecodeTick(ReplayCodecState &state, const u8 *&cursor, const u8 *end, ReplayTick &tick)
+{
+	if (cursor >= end)
+	{
+		return false;
+	}
+	u8 mask = *cursor++;
+
+	u64 tickGap = 0;
+	i32 originResidual[3] {}, angleDelta[2] {}, velocityDelta[3] {};
+	u64 buttonChanges = 0, flagChanges = 0;
+	if ((mask & REPLAYFIELD_TICK) && !ReadVarint(cursor, end, tickGap))
+	{
+		return false;
+	}
+	if ((mask & REPLAYFIELD_ORIGIN)
+		&& !(ReadZigzag(cursor, end, originResidual[0]) && ReadZigzag(cursor, end, originResidual[1]) && ReadZigzag(cursor, end, originResidual[2])))
+	{
+		return false;
+	}
+	if ((mask & REPLAYFIELD_ANGLES) && !(ReadZigzag(cursor, end, angleDelta[0]) && ReadZigzag(cursor, end, angleDelta[1])))
+	{
+		return false;
+	}
+	if ((mask & REPLAYFIELD_VELOCITY)
+		&& !(ReadZigzag(cursor, end, velocityDelta[0]) && ReadZigzag(cursor, end, velocityDelta[1]) && ReadZigzag(cursor, end, velocityDelta[2])))
+	{
+		return false;
+	}
+	if ((mask & REPLAYFIELD_BUTTONS) && !ReadVarint(cursor, end, buttonChanges))
+	{
+		return false;
+	}
+	if ((mask & REPLAYFIELD_FLAGS) && !ReadVarint(cursor, end, flagChanges))
+	{
+		return false;
+	}
+
+	state.tick = (i32)((u32)state.tick + (u32)tickGap + 1);
+	for (u32 i = 0; i < 3; i++)
+	{
+		state.originDelta[i] += originResidual[i];
+		state.origin[i] += state.originDelta[i];
+		state.velocity[i] += velocityDelta[i];
+		tick.origin[i] = state.origin[i] / KZ_REPLAY_ORIGIN_SCALE;
+		tick.velocity[i] = state.velocity[i] / KZ_REPLAY_VELOCITY_SCALE;
+	}
+	for (u32 i = 0; i < 2; i++)
+	{
+		state.angles[i] += angleDelta[i];
+		tick.angles[i] = WrapAngleDelta(state.angles[i]) / KZ_REPLAY_ANGLE_SCALE;
+	}
+	tick.angles[2] = 0.0f;
+	state.buttons ^= buttonChanges;
+	state.flags ^= (u32)flagChanges;
+	tick.tick = state.tick;
+	tick.buttons = state.buttons;
+	tick.flags = state.flags;
+	return true;
+}
+
+template<typename T>
+static_function void WriteValue(std::vector<u8> &out, const T &value)
+{
+	const u8 *bytes = reinterpret_cast<const u8 *>(&value);
+	out.insert(out.end(), bytes, bytes + sizeof(T));
+}
+
+template<typename T>
+static_function bool ReadValue(const u8 *&cursor, const u8 *end, T &value)
+{
+	if ((size_t)(end - cursor) < sizeof(T))
+	{
+		return false;
+	}
+	memcpy(&value, cursor, sizeof(T));
+	cursor += sizeof(T);
+	return true;
+}
+
+void KZ::replays::WriteHeader(const ReplayHeader &header, std::vector<u8> &out)
+{
+	// Written field by field so that the layout doesn't depend on struct padding.
+	WriteValue(out, header.magic);
+	WriteValue(out, header.version);
+	WriteValue(out, header.steamID64);
+	WriteValue(out, header.map);
+	WriteValue(out, header.course);
+	WriteValue(out, header.mode);
+	WriteValue(out, header.time);
+	WriteValue(out, header.teleports);
+	WriteValue(out, header.tickInterval);
+	WriteValue(out, header.startTick);
+	WriteValue(out, header.chunkCount);
+}
+
+void KZ::replays::WriteChunkHeader(const ReplayChunk &chunk, std::vector<u8> &out)
+{
+	WriteValue(out, chunk.firstTick);
+	WriteValue(out, chunk.tickCount);
+	WriteValue(out, (u32)chunk.data.size());
+}
+
+bool KZ::replays::ReadHeader(const u8 *&cursor, const u8 *end, ReplayHeader &header)
+{
+	bool ok = ReadValue(cursor, end, header.magic) && ReadValue(cursor, end, header.version) && ReadValue(cursor, end, header.steamID64)
+			  && ReadValue(cursor, end, header.map) && ReadValue(cursor, end, header.course) && ReadValue(cursor, end, header.mode)
+			  && ReadValue(cursor, end, header.time) && ReadValue(cursor, end, header.teleports) && ReadValue(cursor, end, header.tickInterval)
+			  && ReadValue(cursor, end, header.startTick) && ReadValue(cursor, end, header.chunkCount);
+	if (!ok || header.magic != KZ_REPLAY_MAGIC || header.version != KZ_REPLAY_VERSION)
+	{
+		return false;
+	}
+	header.map[sizeof(header.map) - 1] = '\0';
+	header.course[sizeof(header.course) - 1] = '\0';
+	header.mode[sizeof(header.mode) - 1] = '\0';
+	return true;
+}
+
+void ReplayBuffer::Clear()
+{
+	// Keep the chunks around, their storage gets reused by the next recording.
+	this->head = 0;
+	this->count = 0;
+}
+
+void ReplayBuffer::Append(const ReplayTick &tick)
+{
+	ReplayChunk *chunk = this->count ? &this->chunks[(this->head + this->count - 1) % KZ_REPLAY_MAX_CHUNKS] : nullptr;
+	if (!chunk || chunk->tickCount >= KZ_REPLAY_CHUNK_TICKS)
+	{
+		u32 index;
+		if (this->count == KZ_REPLAY_MAX_CHUNKS)
+		{
+			index = this->head;
+			this->head = (this->head + 1) % KZ_REPLAY_MAX_CHUNKS;
+		}
+		else
+		{
+			index = (this->head + this->count) % KZ_REPLAY_MAX_CHUNKS;
+			this->count++;
+		}
+		if (index >= this->chunks.size())
+		{
+			this->chunks.resize(index + 1);
+		}
+		chunk = &this->chunks[index];
+		chunk->firstTick = tick.tick;
+		chunk->tickCount = 0;
+		chunk->data.clear();
+		this->state.Reset(tick.tick);
+	}
+	KZ::replays::EncodeTick(this->state, tick, chunk->data);
+	chunk->tickCount++;
+}
+
+void ReplayBuffer::CopyChunks(i32 fromTick, std::vector<ReplayChunk> &out) const
+{
+	for (u32 i = 0; i < this->count; i++)
+	{
+		const ReplayChunk &chunk = this->chunks[(this->head + i) % KZ_REPLAY_MAX_CHUNKS];
+		bool last = i + 1 == this->count;
+		if (last || this->chunks[(this->head + i + 1) % KZ_REPLAY_MAX_CHUNKS].firstTick > fromTick)
+		{
+			out.push_back(chunk);
+		}
+	}
+}
+
+size_t ReplayBuffer::GetMemoryUsage() const
+{
+	size_t size = this->chunks.capacity() * sizeof(ReplayChunk);
+	for (const ReplayChunk &chunk : this->chunks)
+	{
+		size += chunk.data.capacity();
+	}
+	return size;
+}
+
+bool ReplayReader::Open(const char *path)
+{
+	FILE *file = fopen(path, "rb");
+	if (!file)
+	{
+		return false;
+	}
+	std::vector<u8> contents;
+	u8 buffer[16384];
+	size_t read;
+	while ((read = fread(buffer, 1, sizeof(buffer), file)) > 0)
+	{
+		contents.insert(contents.end(), buffer, buffer + read);
+	}
+	fclose(file);
+	return this->Load(std::move(contents));
+}
+
+bool ReplayReader::Load(std::vector<u8> data)
+{
+	this->data = std::move(data);
+	this->cursor = this->data.data();
+	this->ticksLeft = 0;
+	this->corrupt = !KZ::replays::ReadHeader(this->cursor, this->data.data() + this->data.size(), this->header);
+	this->chunkEnd = this->cursor;
+	this->chunksLeft = this->corrupt ? 0 : this->header.chunkCount;
+	return !this->corrupt;
+}
+
+bool ReplayReader::ReadTick(ReplayTick &tick)
+{
+	if (this->corrupt)
+	{
+		return false;
+	}
+	const u8 *end = this->data.data() + this->data.size();
+	while (this->ticksLeft == 0)
+	{
+		if (this->chunksLeft == 0)
+		{
+			return false;
+		}
+		// Skip whatever is left of the previous chunk, its records are self-contained.
+		this->cursor = this->chunkEnd;
+		i32 firstTick;
+		u32 tickCount, byteCount;
+		if (!ReadValue(this->cursor, end, firstTick) || !ReadValue(this->cursor, end, tickCount) || !ReadValue(this->cursor, end, byteCount)
+			|| (size_t)(end - this->cursor) < byteCount)
+		{
+			this->corrupt = true;
+			return false;
+		}
+		this->chunkEnd = this->cursor + byteCount;
+		this->ticksLeft = tickCount;
+		this->chunksLeft--;
+		this->state.Reset(firstTick);
+	}
+	if (!KZ::replays::DecodeTick(this->state, this->cursor, this->chunkEnd, tick))
+	{
+		this->corrupt = true;
+		return false;
+	}
+	this->ticksLeft--;
+	return true;
+}
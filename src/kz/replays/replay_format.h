@@ -0,0 +1,173 @@
+#pragma once
+#include <vector>
+
+#include "common.h"
+#include "mathlib/vector.h"
+
+/*
+	Replay file format (version 1), all integers are little-endian.
+
+	Header
+		u32      magic "KZRP"
+		u32      version
+		u64      steamID64
+		char[64] map name, zero padded
+		char[64] course name, zero padded
+		char[16] mode short name, zero padded
+		f32      run time in seconds
+		u32      teleports used
+		f32      tick interval in seconds
+		i32      tick the timer started on, earlier ticks of the first chunk are lead-in
+		u32      chunk count
+
+	Chunk (repeated chunk count times)
+		i32      first tick
+		u32      tick count
+		u32      byte count
+		u8[]     tick records
+
+	Every chunk starts with a zeroed codec state (see ReplayCodecState) so it can be decoded on its own.
+
+	Tick record
+		u8       change mask, a field missing from the mask is unchanged from its prediction
+		0x01     varint:    ticks skipped since the previous record
+		0x02     3 zigzags: origin minus its linear prediction (previous origin + previous origin delta), 1/32 units
+		0x04     2 zigzags: pitch and yaw delta, 1/64 degrees, wrapped to [-180, 180)
+		0x08     3 zigzags: velocity delta, 1/16 units/s
+		0x10     varint:    buttons XOR previous buttons
+		0x20     varint:    flags XOR previous flags
+
+	Varints are unsigned LEB128, zigzags are zigzag encoded signed varints.
+	A player strafing around costs around 10 bytes per tick, a player standing still costs 1.
+*/
+
+#define KZ_REPLAY_MAGIC   0x50525A4B
+#define KZ_REPLAY_VERSION 1
+
+#define KZ_REPLAY_CHUNK_TICKS 128
+// 30 minutes of 64 tick, runs longer than that lose their beginning.
+#define KZ_REPLAY_MAX_CHUNKS 900
+
+#define KZ_REPLAY_ORIGIN_SCALE   32.0f
+#define KZ_REPLAY_ANGLE_SCALE    64.0f
+#define KZ_REPLAY_VELOCITY_SCALE 16.0f
+
+enum ReplayTickField : u8
+{
+	REPLAYFIELD_TICK = 1 << 0,
+	REPLAYFIELD_ORIGIN = 1 << 1,
+	REPLAYFIELD_ANGLES = 1 << 2,
+	REPLAYFIELD_VELOCITY = 1 << 3,
+	REPLAYFIELD_BUTTONS = 1 << 4,
+	REPLAYFIELD_FLAGS = 1 << 5,
+};
+
+struct ReplayTick
+{
+	i32 tick;
+	Vector origin;
+	QAngle angles;
+	Vector velocity;
+	u64 buttons;
+	u32 flags;
+};
+
+// Quantized values of the previous record. The encoder and the decoder both work off the quantized values so they never drift apart.
+struct ReplayCodecState
+{
+	i32 tick;
+	i32 origin[3];
+	i32 originDelta[3];
+	i32 angles[2];
+	i32 velocity[3];
+	u64 buttons;
+	u32 flags;
+
+	void Reset(i32 firstTick)
+	{
+		*this = {};
+		this->tick = firstTick - 1;
+	}
+};
+
+struct ReplayChunk
+{
+	i32 firstTick;
+	u32 tickCount;
+	std::vector<u8> data;
+};
+
+struct ReplayHeader
+{
+	u32 magic = KZ_REPLAY_MAGIC;
+	u32 version = KZ_REPLAY_VERSION;
+	u64 steamID64 {};
+	char map[64] {};
+	char course[64] {};
+	char mode[16] {};
+	f32 time {};
+	u32 teleports {};
+	f32 tickInterval {};
+	i32 startTick {};
+	u32 chunkCount {};
+};
+
+namespace KZ::replays
+{
+	void EncodeTick(ReplayCodecState &state, const ReplayTick &tick, std::vector<u8> &out);
+	// Advances the cursor past the record, returns false if the record runs past the end.
+	bool DecodeTick(ReplayCodecState &state, const u8 *&cursor, const u8 *end, ReplayTick &tick);
+
+	void WriteHeader(const ReplayHeader &header, std::vector<u8> &out);
+	bool ReadHeader(const u8 *&cursor, const u8 *end, ReplayHeader &header);
+
+	// Everything in front of the chunk's tick records.
+	void WriteChunkHeader(const ReplayChunk &chunk, std::vector<u8> &out);
+} // namespace KZ::replays
+
+// The last KZ_REPLAY_MAX_CHUNKS chunks of a player's movement, the oldest chunk is reused once all of them are taken.
+class ReplayBuffer
+{
+public:
+	void Clear();
+	void Append(const ReplayTick &tick);
+	// Copies every chunk that can contain ticks from fromTick onwards, oldest first.
+	void CopyChunks(i32 fromTick, std::vector<ReplayChunk> &out) const;
+	size_t GetMemoryUsage() const;
+
+private:
+	std::vector<ReplayChunk> chunks;
+	u32 head {};
+	u32 count {};
+	ReplayCodecState state {};
+};
+
+class ReplayReader
+{
+public:
+	bool Open(const char *path);
+	bool Load(std::vector<u8> data);
+
+	const ReplayHeader &GetHeader() const
+	{
+		return this->header;
+	}
+
+	// Decodes the next tick, returns false at the end of the replay or if the data is corrupt.
+	bool ReadTick(ReplayTick &tick);
+
+	bool IsCorrupt() const
+	{
+		return this->corrupt;
+	}
+
+private:
+	std::vector<u8> data;
+	ReplayHeader header;
+	const u8 *cursor {};
+	const u8 *chunkEnd {};
+	u32 chunksLeft {};
+	u32 ticksLeft {};
+	bool corrupt {};
+	ReplayCodecState state {};
+};
@@ -5,6 +5,7 @@
 #include "kz/language/kz_language.h"
 #include "kz/mode/kz_mode.h"
 #include "kz/style/kz_style.h"
+#include "queries/base_request.h"
 
 #include "vendor/sql_mm/src/public/sql_mm.h"
 
@@ -122,10 +123,19 @@ RecordAnnounce::RecordAnnounce(KZPlayer *player)
 
 void RecordAnnounce::SubmitGlobal()
 {
-	auto callback = [uid = this->uid](KZ::API::events::NewRecordAck &ack)
+	auto callback = [uid = this->uid, mapName = this->map.name, courseName = this->course.name, modeName = this->mode.name](
+						KZ::API::events::NewRecordAck &ack)
 	{
 		META_CONPRINTF("[KZ::Global] Record submitted under ID %d\n", ack.recordId);
 
+		// Cached global leaderboards of this course are out of date now, even if the announcement itself is gone.
+		const KZCourseDescriptor *course = KZ::course::GetCourse(courseName.c_str());
+		KZ::API::Mode apiMode;
+		if (course && KZ::API::DecodeModeString(modeName, apiMode))
+		{
+			BaseRequest::InvalidateGlobalResults(mapName.c_str(), course, apiMode);
+		}
+
 		RecordAnnounce *rec = RecordAnnounce::Get(uid);
 		if (!rec)
 		{
@@ -215,7 +225,7 @@ void RecordAnnounce::SubmitLocal()
 		}
 		rec->localResponse.received = true;
 
-		ISQLResult *result = queries[1]->GetResultSet();
+		ISQLResult *result = queries[2]->GetResultSet();
 		rec->localResponse.overall.firstTime = result->GetRowCount() == 1;
 		if (!rec->localResponse.overall.firstTime)
 		{
@@ -234,16 +244,16 @@ void RecordAnnounce::SubmitLocal()
 			}
 		}
 		// Get NUB Rank
-		result = queries[2]->GetResultSet();
+		result = queries[3]->GetResultSet();
 		result->FetchRow();
 		rec->localResponse.overall.rank = result->GetInt(0);
-		result = queries[3]->GetResultSet();
+		result = queries[4]->GetResultSet();
 		result->FetchRow();
 		rec->localResponse.overall.maxRank = result->GetInt(0);
 
 		if (rec->teleports == 0)
 		{
-			ISQLResult *result = queries[4]->GetResultSet();
+			ISQLResult *result = queries[5]->GetResultSet();
 			rec->localResponse.pro.firstTime = result->GetRowCount() == 1;
 			if (!rec->localResponse.pro.firstTime)
 			{
@@ -262,10 +272,10 @@ void RecordAnnounce::SubmitLocal()
 				}
 			}
 			// Get PRO rank
-			result = queries[5]->GetResultSet();
+			result = queries[6]->GetResultSet();
 			result->FetchRow();
 			rec->localResponse.pro.rank = result->GetInt(0);
-			result = queries[6]->GetResultSet();
+			result = queries[7]->GetResultSet();
 			result->FetchRow();
 			rec->localResponse.pro.maxRank = result->GetInt(0);
 		}
@@ -10,6 +10,7 @@
 #include "kz/trigger/kz_trigger.h"
 #include "kz/spec/kz_spec.h"
 #include "announce.h"
+#include "queries/base_request.h"
 
 #include "utils/utils.h"
 #include "utils/simplecmds.h"
@@ -63,6 +64,8 @@ static_global class KZDatabaseServiceEventListener_Timer : public KZDatabaseServ
 public:
 	virtual void OnMapSetup() override;
 	virtual void OnClientSetup(Player *player, u64 steamID64, bool isCheater) override;
+	virtual void OnTimeInserted(Player *player, u64 steamID64, u32 mapID, u32 course, u64 mode, u64 styles, u64 runtimeMS,
+								u32 teleportsUsed) override;
 } databaseEventListener;
 
 static_global class KZOptionServiceEventListener_Timer : public KZOptionServiceEventListener
@@ -73,8 +76,8 @@ static_global class KZOptionServiceEventListener_Timer : public KZOptionServiceE
 	}
 } optionEventListener;
 
-std::unordered_map<PBDataKey, PBData> KZTimerService::srCache;
-std::unordered_map<PBDataKey, PBData> KZTimerService::wrCache;
+PBDataCache KZTimerService::srCache;
+PBDataCache KZTimerService::wrCache;
 
 static_global CUtlVector<KZTimerServiceEventListener *> eventListeners;
 
@@ -909,35 +912,19 @@ const PBData *KZTimerService::GetCompareTargetForType(CompareType type, PBDataKe
 	{
 		case COMPARE_WR:
 		{
-			if (KZTimerService::wrCache.find(key) != KZTimerService::wrCache.end())
-			{
-				return &KZTimerService::wrCache[key];
-			}
-			break;
+			return KZTimerService::wrCache.Find(key);
 		}
 		case COMPARE_SR:
 		{
-			if (KZTimerService::srCache.find(key) != KZTimerService::srCache.end())
-			{
-				return &KZTimerService::srCache[key];
-			}
-			break;
+			return KZTimerService::srCache.Find(key);
 		}
 		case COMPARE_GPB:
 		{
-			if (KZTimerService::globalPBCache.find(key) != KZTimerService::globalPBCache.end())
-			{
-				return &this->globalPBCache[key];
-			}
-			break;
+			return this->globalPBCache.Find(key);
 		}
 		case COMPARE_SPB:
 		{
-			if (KZTimerService::localPBCache.find(key) != KZTimerService::localPBCache.end())
-			{
-				return &this->localPBCache[key];
-			}
-			break;
+			return this->localPBCache.Find(key);
 		}
 	}
 	return nullptr;
@@ -949,35 +936,19 @@ const PBData *KZTimerService::GetCompareTarget(PBDataKey key)
 	{
 		case COMPARE_WR:
 		{
-			if (KZTimerService::wrCache.find(key) != KZTimerService::wrCache.end())
-			{
-				return &KZTimerService::wrCache[key];
-			}
-			break;
+			return KZTimerService::wrCache.Find(key);
 		}
 		case COMPARE_SR:
 		{
-			if (KZTimerService::srCache.find(key) != KZTimerService::srCache.end())
-			{
-				return &KZTimerService::srCache[key];
-			}
-			break;
+			return KZTimerService::srCache.Find(key);
 		}
 		case COMPARE_GPB:
 		{
-			if (KZTimerService::globalPBCache.find(key) != KZTimerService::globalPBCache.end())
-			{
-				return &this->globalPBCache[key];
-			}
-			break;
+			return this->globalPBCache.Find(key);
 		}
 		case COMPARE_SPB:
 		{
-			if (KZTimerService::localPBCache.find(key) != KZTimerService::localPBCache.end())
-			{
-				return &this->localPBCache[key];
-			}
-			break;
+			return this->localPBCache.Find(key);
 		}
 	}
 	return nullptr;
@@ -985,8 +956,8 @@ const PBData *KZTimerService::GetCompareTarget(PBDataKey key)
 
 void KZTimerService::ClearRecordCache()
 {
-	KZTimerService::srCache.clear();
-	KZTimerService::wrCache.clear();
+	KZTimerService::srCache.Clear();
+	KZTimerService::wrCache.Clear();
 }
 
 void KZTimerService::UpdateLocalRecordCache()
@@ -1035,9 +1006,15 @@ void KZTimerService::UpdateLocalRecordCache()
 
 void KZTimerService::InsertRecordToCache(f64 time, const KZCourseDescriptor *course, PluginId modeID, bool overall, bool global, CUtlString metadata)
 {
-	PBData &pb = global ? KZTimerService::wrCache[ToPBDataKey(modeID, course->guid)] : KZTimerService::srCache[ToPBDataKey(modeID, course->guid)];
+	PBDataCache &cache = global ? KZTimerService::wrCache : KZTimerService::srCache;
+	PBData &pb = cache.FindOrInsert(ToPBDataKey(modeID, course->guid), course);
 
 	overall ? pb.overall.pbTime = time : pb.pro.pbTime = time;
+	KZTimerService::LoadZoneTimes(pb, course, overall, metadata);
+}
+
+void KZTimerService::LoadZoneTimes(PBData &pb, const KZCourseDescriptor *course, bool overall, const CUtlString &metadata)
+{
 	KeyValues3 kv(KV3_TYPEEX_TABLE, KV3_SUBTYPE_UNSPECIFIED);
 	CUtlString error = "";
 	if (metadata.IsEmpty())
@@ -1047,44 +1024,25 @@ void KZTimerService::InsertRecordToCache(f64 time, const KZCourseDescriptor *cou
 	LoadKV3FromJSON(&kv, &error, metadata.Get(), "");
 	if (!error.IsEmpty())
 	{
-		META_CONPRINTF("[KZ::Timer] Failed to insert PB to cache due to metadata error: %s\n", error.Get());
+		META_CONPRINTF("[KZ::Timer] Failed to insert time to cache due to metadata error: %s\n", error.Get());
 		return;
 	}
 
-	KeyValues3 *data = kv.FindMember("splitZoneTimes");
-	if (data && data->GetType() == KV3_TYPE_ARRAY)
+	static_persist const struct
 	{
-		for (i32 i = 0; i < course->splitCount; i++)
-		{
-			f64 time = -1.0f;
-			KeyValues3 *element = data->GetArrayElement(i);
-			if (element)
-			{
-				time = element->GetDouble(-1.0);
-			}
-			overall ? pb.overall.pbSplitZoneTimes[i] = time : pb.pro.pbSplitZoneTimes[i] = time;
-		}
-	}
+		const char *key;
+		PBZoneType type;
+	} zoneKeys[] = {{"splitZoneTimes", PBZONE_SPLIT}, {"cpZoneTimes", PBZONE_CHECKPOINT}, {"stageZoneTimes", PBZONE_STAGE}};
+	const i32 zoneCounts[] = {course->splitCount, course->checkpointCount, course->stageCount};
 
-	data = kv.FindMember("cpZoneTimes");
-	if (data && data->GetType() == KV3_TYPE_ARRAY)
+	for (u32 zone = 0; zone < PBZONE_COUNT; zone++)
 	{
-		for (i32 i = 0; i < course->checkpointCount; i++)
+		KeyValues3 *data = kv.FindMember(zoneKeys[zone].key);
+		if (!data || data->GetType() != KV3_TYPE_ARRAY)
 		{
-			f64 time = -1.0f;
-			KeyValues3 *element = data->GetArrayElement(i);
-			if (element)
-			{
-				time = element->GetDouble(-1.0);
-			}
-			overall ? pb.overall.pbCpZoneTimes[i] = time : pb.pro.pbCpZoneTimes[i] = time;
+			continue;
 		}
-	}
-
-	data = kv.FindMember("stageZoneTimes");
-	if (data && data->GetType() == KV3_TYPE_ARRAY)
-	{
-		for (i32 i = 0; i < course->stageCount; i++)
+		for (i32 i = 0; i < zoneCounts[zone]; i++)
 		{
 			f64 time = -1.0f;
 			KeyValues3 *element = data->GetArrayElement(i);
@@ -1092,92 +1050,30 @@ void KZTimerService::InsertRecordToCache(f64 time, const KZCourseDescriptor *cou
 			{
 				time = element->GetDouble(-1.0);
 			}
-			overall ? pb.overall.pbStageZoneTimes[i] = time : pb.pro.pbStageZoneTimes[i] = time;
+			pb.SetZoneTime(!overall, zoneKeys[zone].type, i, time);
 		}
 	}
 }
 
 void KZTimerService::ClearPBCache()
 {
-	this->localPBCache.clear();
+	this->localPBCache.Clear();
 }
 
 const PBData *KZTimerService::GetGlobalCachedPB(const KZCourseDescriptor *course, PluginId modeID)
 {
-	PBDataKey key = ToPBDataKey(modeID, course->guid);
-
-	if (this->globalPBCache.find(key) == this->globalPBCache.end())
-	{
-		return nullptr;
-	}
-
-	return &this->globalPBCache[key];
+	return this->globalPBCache.Find(ToPBDataKey(modeID, course->guid));
 }
 
 void KZTimerService::InsertPBToCache(f64 time, const KZCourseDescriptor *course, PluginId modeID, bool overall, bool global, CUtlString metadata,
 									 f64 points)
 {
-	PBData &pb = global ? this->globalPBCache[ToPBDataKey(modeID, course->guid)] : this->localPBCache[ToPBDataKey(modeID, course->guid)];
+	PBDataCache &cache = global ? this->globalPBCache : this->localPBCache;
+	PBData &pb = cache.FindOrInsert(ToPBDataKey(modeID, course->guid), course);
 
 	overall ? pb.overall.points = points : pb.pro.points = points;
 	overall ? pb.overall.pbTime = time : pb.pro.pbTime = time;
-	KeyValues3 kv(KV3_TYPEEX_TABLE, KV3_SUBTYPE_UNSPECIFIED);
-	CUtlString error = "";
-	if (metadata.IsEmpty())
-	{
-		return;
-	}
-	LoadKV3FromJSON(&kv, &error, metadata.Get(), "");
-	if (!error.IsEmpty())
-	{
-		META_CONPRINTF("[KZ::Timer] Failed to insert server record to cache due to metadata error: %s\n", error.Get());
-		return;
-	}
-
-	KeyValues3 *data = kv.FindMember("splitZoneTimes");
-	if (data && data->GetType() == KV3_TYPE_ARRAY)
-	{
-		for (i32 i = 0; i < course->splitCount; i++)
-		{
-			f64 time = -1.0f;
-			KeyValues3 *element = data->GetArrayElement(i);
-			if (element)
-			{
-				time = element->GetDouble(-1.0);
-			}
-			overall ? pb.overall.pbSplitZoneTimes[i] = time : pb.pro.pbSplitZoneTimes[i] = time;
-		}
-	}
-
-	data = kv.FindMember("cpZoneTimes");
-	if (data && data->GetType() == KV3_TYPE_ARRAY)
-	{
-		for (i32 i = 0; i < course->checkpointCount; i++)
-		{
-			f64 time = -1.0f;
-			KeyValues3 *element = data->GetArrayElement(i);
-			if (element)
-			{
-				time = element->GetDouble(-1.0);
-			}
-			overall ? pb.overall.pbCpZoneTimes[i] = time : pb.pro.pbCpZoneTimes[i] = time;
-		}
-	}
-
-	data = kv.FindMember("stageZoneTimes");
-	if (data && data->GetType() == KV3_TYPE_ARRAY)
-	{
-		for (i32 i = 0; i < course->stageCount; i++)
-		{
-			f64 time = -1.0f;
-			KeyValues3 *element = data->GetArrayElement(i);
-			if (element)
-			{
-				time = element->GetDouble(-1.0);
-			}
-			overall ? pb.overall.pbStageZoneTimes[i] = time : pb.pro.pbStageZoneTimes[i] = time;
-		}
-	}
+	KZTimerService::LoadZoneTimes(pb, course, overall, metadata);
 }
 
 void KZTimerService::CheckMissedTime()
@@ -1267,17 +1163,18 @@ void KZTimerService::ShowSplitText(u32 currentSplit)
 	const PBData *pb = this->GetCompareTarget(key);
 	if (pb)
 	{
-		if (pb->overall.pbSplitZoneTimes[currentSplit - 1] > 0)
+		f64 pbZoneTime = pb->GetZoneTime(false, PBZONE_SPLIT, currentSplit - 1);
+		f64 pbProZoneTime = pb->GetZoneTime(true, PBZONE_SPLIT, currentSplit - 1);
+		if (pbZoneTime > 0)
 		{
-			META_CONPRINTF("pb->overall.pbSplitZoneTimes[currentSplit - 1] = %lf\n", pb->overall.pbSplitZoneTimes[currentSplit - 1]);
-			f64 diff = this->splitZoneTimes[currentSplit - 1] - pb->overall.pbSplitZoneTimes[currentSplit - 1];
+			f64 diff = this->splitZoneTimes[currentSplit - 1] - pbZoneTime;
 			CUtlString diffText = KZTimerService::FormatDiffTime(diff);
 			diffText.Format("{grey}%s%s{grey}", diff < 0 ? "{green}" : "{lightred}", diffText.Get());
 			pbDiff = this->player->languageService->PrepareMessage(diffTextKeys[this->currentCompareType], diffText.Get());
 		}
-		if (this->player->checkpointService->GetTeleportCount() == 0 && pb->pro.pbTime > 0 && pb->pro.pbSplitZoneTimes[currentSplit - 1] > 0)
+		if (this->player->checkpointService->GetTeleportCount() == 0 && pb->pro.pbTime > 0 && pbProZoneTime > 0)
 		{
-			f64 diff = this->splitZoneTimes[currentSplit - 1] - pb->pro.pbSplitZoneTimes[currentSplit - 1];
+			f64 diff = this->splitZoneTimes[currentSplit - 1] - pbProZoneTime;
 			CUtlString diffText = KZTimerService::FormatDiffTime(diff);
 			diffText.Format("{grey}%s%s{grey}", diff < 0 ? "{green}" : "{lightred}", diffText.Get());
 			pbDiffPro = this->player->languageService->PrepareMessage(diffTextKeysPro[this->currentCompareType], diffText.Get());
@@ -1320,16 +1217,18 @@ void KZTimerService::ShowCheckpointText(u32 currentCheckpoint)
 	const PBData *pb = this->GetCompareTarget(key);
 	if (pb)
 	{
-		if (pb->overall.pbCpZoneTimes[currentCheckpoint - 1] > 0)
+		f64 pbZoneTime = pb->GetZoneTime(false, PBZONE_CHECKPOINT, currentCheckpoint - 1);
+		f64 pbProZoneTime = pb->GetZoneTime(true, PBZONE_CHECKPOINT, currentCheckpoint - 1);
+		if (pbZoneTime > 0)
 		{
-			f64 diff = this->cpZoneTimes[currentCheckpoint - 1] - pb->overall.pbCpZoneTimes[currentCheckpoint - 1];
+			f64 diff = this->cpZoneTimes[currentCheckpoint - 1] - pbZoneTime;
 			CUtlString diffText = KZTimerService::FormatDiffTime(diff);
 			diffText.Format("{grey}%s%s{grey}", diff < 0 ? "{green}" : "{lightred}", diffText.Get());
 			pbDiff = this->player->languageService->PrepareMessage(diffTextKeys[this->currentCompareType], diffText.Get());
 		}
-		if (this->player->checkpointService->GetTeleportCount() == 0 && pb->pro.pbTime > 0 && pb->pro.pbCpZoneTimes[currentCheckpoint - 1] > 0)
+		if (this->player->checkpointService->GetTeleportCount() == 0 && pb->pro.pbTime > 0 && pbProZoneTime > 0)
 		{
-			f64 diff = this->cpZoneTimes[currentCheckpoint - 1] - pb->pro.pbCpZoneTimes[currentCheckpoint - 1];
+			f64 diff = this->cpZoneTimes[currentCheckpoint - 1] - pbProZoneTime;
 			CUtlString diffText = KZTimerService::FormatDiffTime(diff);
 			diffText.Format("{grey}%s%s{grey}", diff < 0 ? "{green}" : "{lightred}", diffText.Get());
 			pbDiffPro = this->player->languageService->PrepareMessage(diffTextKeysPro[this->currentCompareType], diffText.Get());
@@ -1373,16 +1272,18 @@ void KZTimerService::ShowStageText()
 	const PBData *pb = this->GetCompareTarget(key);
 	if (pb)
 	{
-		if (pb->overall.pbStageZoneTimes[this->currentStage] > 0)
+		f64 pbZoneTime = pb->GetZoneTime(false, PBZONE_STAGE, this->currentStage);
+		f64 pbProZoneTime = pb->GetZoneTime(true, PBZONE_STAGE, this->currentStage);
+		if (pbZoneTime > 0)
 		{
-			f64 diff = this->stageZoneTimes[this->currentStage] - pb->overall.pbStageZoneTimes[this->currentStage];
+			f64 diff = this->stageZoneTimes[this->currentStage] - pbZoneTime;
 			CUtlString diffText = KZTimerService::FormatDiffTime(diff);
 			diffText.Format("{grey}%s%s{grey}", diff < 0 ? "{green}" : "{lightred}", diffText.Get());
 			pbDiff = this->player->languageService->PrepareMessage(diffTextKeys[this->currentCompareType], diffText.Get());
 		}
-		if (this->player->checkpointService->GetTeleportCount() == 0 && pb->pro.pbTime > 0 && pb->pro.pbStageZoneTimes[this->currentStage] > 0)
+		if (this->player->checkpointService->GetTeleportCount() == 0 && pb->pro.pbTime > 0 && pbProZoneTime > 0)
 		{
-			f64 diff = this->stageZoneTimes[this->currentStage] - pb->pro.pbStageZoneTimes[this->currentStage];
+			f64 diff = this->stageZoneTimes[this->currentStage] - pbProZoneTime;
 			CUtlString diffText = KZTimerService::FormatDiffTime(diff);
 			diffText.Format("{grey}%s%s{grey}", diff < 0 ? "{green}" : "{lightred}", diffText.Get());
 			pbDiffPro = this->player->languageService->PrepareMessage(diffTextKeysPro[this->currentCompareType], diffText.Get());
@@ -1497,6 +1398,8 @@ void KZTimerService::RegisterCommands()
 	KZTimerService::RegisterPBCommand();
 	KZTimerService::RegisterRecordCommands();
 	KZTimerService::RegisterCourseTopCommands();
+	KZTimerService::RegisterRequestCacheCommand();
+	KZTimerService::RegisterPBCacheCommand();
 }
 
 void KZTimerService::OnPlayerPreferencesLoaded()
@@ -1520,3 +1423,21 @@ void KZDatabaseServiceEventListener_Timer::OnClientSetup(Player *player, u64 ste
 	KZPlayer *kzPlayer = g_pKZPlayerManager->ToKZPlayer(player);
 	kzPlayer->timerService->UpdateLocalPBCache();
 }
+
+void KZDatabaseServiceEventListener_Timer::OnTimeInserted(Player *player, u64 steamID64, u32 mapID, u32 course, u64 mode, u64 styles,
+														  u64 runtimeMS, u32 teleportsUsed)
+{
+	// The map changed while the time was being saved, the courses below belong to the new map.
+	if (mapID != (u32)KZDatabaseService::GetMapID())
+	{
+		return;
+	}
+	const KZCourseDescriptor *courseDesc = KZ::course::GetCourseByLocalCourseID(course);
+	bool gotCurrentMap = false;
+	CUtlString currentMap = g_pKZUtils->GetCurrentMapName(&gotCurrentMap);
+	if (!courseDesc || !gotCurrentMap)
+	{
+		return;
+	}
+	BaseRequest::InvalidateLocalResults(currentMap.Get(), courseDesc, mode);
+}
@@ -3,6 +3,7 @@
 #include "../kz.h"
 #include "../checkpoint/kz_checkpoint.h"
 #include "kz/mappingapi/kz_mappingapi.h"
+#include "pb_cache.h"
 
 #define KZ_MAX_MODE_NAME_LENGTH 128
 
@@ -21,55 +22,6 @@
 
 #define KZ_PAUSE_COOLDOWN 1.0f
 
-struct PBData
-{
-	PBData()
-	{
-		Reset();
-	}
-
-	void Reset()
-	{
-		overall.pbTime = {};
-		overall.pbSplitZoneTimes.FillWithValue(-1.0);
-		overall.pbCpZoneTimes.FillWithValue(-1.0);
-		overall.pbStageZoneTimes.FillWithValue(-1.0);
-		pro.pbTime = {};
-		pro.pbSplitZoneTimes.FillWithValue(-1.0);
-		pro.pbCpZoneTimes.FillWithValue(-1.0);
-		pro.pbStageZoneTimes.FillWithValue(-1.0);
-	}
-
-	struct
-	{
-		f64 pbTime {};
-		f64 points {};
-		CUtlVectorFixed<f64, KZ_MAX_SPLIT_ZONES> pbSplitZoneTimes;
-		CUtlVectorFixed<f64, KZ_MAX_CHECKPOINT_ZONES> pbCpZoneTimes;
-		CUtlVectorFixed<f64, KZ_MAX_STAGE_ZONES> pbStageZoneTimes;
-	} overall, pro;
-};
-
-// Convert mode and course ID to one single value.
-typedef u64 PBDataKey;
-
-inline PBDataKey ToPBDataKey(u32 modeID, u32 courseID)
-{
-	return modeID | ((u64)courseID << 32);
-}
-
-inline void ConvertFromPBDataKey(PBDataKey key, uint32_t *modeID, uint32_t *courseID)
-{
-	if (modeID)
-	{
-		*modeID = (uint32_t)key;
-	}
-	if (courseID)
-	{
-		*courseID = (uint32_t)(key >> 32);
-	}
-}
-
 class KZTimerServiceEventListener
 {
 public:
@@ -131,13 +83,16 @@ private:
 	CUtlVectorFixed<f64, KZ_MAX_STAGE_ZONES> stageZoneTimes {};
 
 	// PB cache per mode and per course.
-	std::unordered_map<PBDataKey, PBData> localPBCache;
-	std::unordered_map<PBDataKey, PBData> globalPBCache;
+	PBDataCache localPBCache;
+	PBDataCache globalPBCache;
 
 	// SR cache should be loaded upon map start, every time !wr is queried and every time a run beats the server record.
-	static std::unordered_map<PBDataKey, PBData> srCache;
+	static PBDataCache srCache;
+
+	static PBDataCache wrCache;
 
-	static std::unordered_map<PBDataKey, PBData> wrCache;
+	// Fills in the zone times of a record from its metadata.
+	static void LoadZoneTimes(PBData &pb, const KZCourseDescriptor *course, bool overall, const CUtlString &metadata);
 
 public:
 	enum CompareType : u8
@@ -198,6 +153,9 @@ public:
 	static void RegisterPBCommand();
 	static void RegisterRecordCommands();
 	static void RegisterCourseTopCommands();
+	static void RegisterRequestCacheCommand();
+	static void RegisterPBCacheCommand();
+	static void PrintCacheMemoryUsage(KZPlayer *player);
 	static bool RegisterEventListener(KZTimerServiceEventListener *eventListener);
 	static bool UnregisterEventListener(KZTimerServiceEventListener *eventListener);
 
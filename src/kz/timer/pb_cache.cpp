@@ -0,0 +1,164 @@
+#include <algorithm>
+
+#include "pb_cache.h"
+#include "kz_timer.h"
+#include "kz/mappingapi/kz_mappingapi.h"
+#include "utils/simplecmds.h"
+
+#define KZ_PB_CACHE_MIN_CAPACITY 16
+
+void PBData::Init(const KZCourseDescriptor *course)
+{
+	this->zoneCounts[PBZONE_SPLIT] = (u8)std::clamp(course->splitCount, 0, KZ_MAX_SPLIT_ZONES);
+	this->zoneCounts[PBZONE_CHECKPOINT] = (u8)std::clamp(course->checkpointCount, 0, KZ_MAX_CHECKPOINT_ZONES);
+	this->zoneCounts[PBZONE_STAGE] = (u8)std::clamp(course->stageCount, 0, KZ_MAX_STAGE_ZONES);
+	this->zoneTimes.assign(2 * (this->zoneCounts[PBZONE_SPLIT] + this->zoneCounts[PBZONE_CHECKPOINT] + this->zoneCounts[PBZONE_STAGE]), -1.0);
+	this->zoneTimes.shrink_to_fit();
+}
+
+u32 PBDataCache::GetSlot(PBDataKey key) const
+{
+	// Mode IDs and course GUIDs are both small, mix them so neighbouring keys don't cluster.
+	u64 hash = key * 0x9E3779B97F4A7C15ull;
+	return (u32)(hash >> 32) & (u32)(this->keys.size() - 1);
+}
+
+PBData *PBDataCache::Find(PBDataKey key)
+{
+	if (this->count == 0)
+	{
+		return nullptr;
+	}
+	u32 mask = (u32)this->keys.size() - 1;
+	for (u32 slot = this->GetSlot(key);; slot = (slot + 1) & mask)
+	{
+		if (!this->used[slot])
+		{
+			return nullptr;
+		}
+		if (this->keys[slot] == key)
+		{
+			return &this->values[slot];
+		}
+	}
+}
+
+PBData &PBDataCache::FindOrInsert(PBDataKey key, const KZCourseDescriptor *course)
+{
+	// Keep the load factor at or below 3/4 so probe sequences stay short.
+	if ((this->count + 1) * 4 > this->keys.size() * 3)
+	{
+		this->Grow();
+	}
+	u32 mask = (u32)this->keys.size() - 1;
+	u32 slot = this->GetSlot(key);
+	for (; this->used[slot]; slot = (slot + 1) & mask)
+	{
+		if (this->keys[slot] == key)
+		{
+			return this->values[slot];
+		}
+	}
+	this->used[slot] = true;
+	this->keys[slot] = key;
+	this->values[slot] = {};
+	this->values[slot].Init(course);
+	this->count++;
+	return this->values[slot];
+}
+
+void PBDataCache::Grow()
+{
+	std::vector<PBDataKey> oldKeys = std::move(this->keys);
+	std::vector<bool> oldUsed = std::move(this->used);
+	std::vector<PBData> oldValues = std::move(this->values);
+
+	size_t capacity = oldKeys.empty() ? KZ_PB_CACHE_MIN_CAPACITY : oldKeys.size() * 2;
+	this->keys.assign(capacity, 0);
+	this->used.assign(capacity, false);
+	this->values.clear();
+	this->values.resize(capacity);
+
+	u32 mask = (u32)capacity - 1;
+	for (size_t i = 0; i < oldKeys.size(); i++)
+	{
+		if (!oldUsed[i])
+		{
+			continue;
+		}
+		u32 slot = this->GetSlot(oldKeys[i]);
+		while (this->used[slot])
+		{
+			slot = (slot + 1) & mask;
+		}
+		this->used[slot] = true;
+		this->keys[slot] = oldKeys[i];
+		this->values[slot] = std::move(oldValues[i]);
+	}
+}
+
+void PBDataCache::Clear()
+{
+	this->keys.clear();
+	this->used.clear();
+	this->values.clear();
+	this->keys.shrink_to_fit();
+	this->used.shrink_to_fit();
+	this->values.shrink_to_fit();
+	this->count = 0;
+}
+
+size_t PBDataCache::GetMemoryUsage() const
+{
+	size_t size = sizeof(PBDataCache) + this->keys.capacity() * sizeof(PBDataKey) + this->used.capacity() / 8
+				  + (this->values.capacity() - this->count) * sizeof(PBData);
+	for (size_t i = 0; i < this->values.size(); i++)
+	{
+		if (this->used[i])
+		{
+			size += this->values[i].GetMemoryUsage();
+		}
+	}
+	return size;
+}
+
+void KZTimerService::PrintCacheMemoryUsage(KZPlayer *player)
+{
+	player->PrintConsole(false, false, "[KZ::Timer] SR cache: %u entries, %.1f KiB", KZTimerService::srCache.Count(),
+						 KZTimerService::srCache.GetMemoryUsage() / 1024.0);
+	player->PrintConsole(false, false, "[KZ::Timer] WR cache: %u entries, %.1f KiB", KZTimerService::wrCache.Count(),
+						 KZTimerService::wrCache.GetMemoryUsage() / 1024.0);
+
+	u32 players = 0, entries = 0;
+	size_t size = 0;
+	for (i32 i = 0; i < MAXPLAYERS; i++)
+	{
+		KZPlayer *target = g_pKZPlayerManager->ToPlayer(CPlayerSlot(i));
+		if (!target || !target->timerService)
+		{
+			continue;
+		}
+		PBDataCache &localCache = target->timerService->localPBCache;
+		PBDataCache &globalCache = target->timerService->globalPBCache;
+		if (localCache.Count() == 0 && globalCache.Count() == 0)
+		{
+			continue;
+		}
+		players++;
+		entries += localCache.Count() + globalCache.Count();
+		size += localCache.GetMemoryUsage() + globalCache.GetMemoryUsage();
+	}
+	player->PrintConsole(false, false, "[KZ::Timer] PB caches: %u players, %u entries, %.1f KiB", players, entries, size / 1024.0);
+}
+
+static_function SCMD_CALLBACK(Command_KzPBCacheStats)
+{
+	KZPlayer *player = g_pKZPlayerManager->ToPlayer(controller);
+	KZTimerService::PrintCacheMemoryUsage(player);
+	return MRES_SUPERCEDE;
+}
+
+void KZTimerService::RegisterPBCacheCommand()
+{
+	scmd::RegisterCmd("kz_pbcache", Command_KzPBCacheStats, true);
+}
@@ -0,0 +1,118 @@
+#pragma once
+#include <vector>
+
+#include "common.h"
+
+struct KZCourseDescriptor;
+
+enum PBZoneType : u8
+{
+	PBZONE_SPLIT = 0,
+	PBZONE_CHECKPOINT,
+	PBZONE_STAGE,
+	PBZONE_COUNT
+};
+
+struct PBData
+{
+	struct
+	{
+		f64 pbTime {};
+		f64 points {};
+	} overall, pro;
+
+	// Sizes the zone times to the course and marks all of them as missing.
+	void Init(const KZCourseDescriptor *course);
+
+	// Zones past the course's zone count never have a time.
+	f64 GetZoneTime(bool pro, PBZoneType type, i32 index) const
+	{
+		if (index < 0 || index >= this->zoneCounts[type])
+		{
+			return -1.0;
+		}
+		return this->zoneTimes[this->GetZoneOffset(pro, type) + index];
+	}
+
+	void SetZoneTime(bool pro, PBZoneType type, i32 index, f64 time)
+	{
+		if (index >= 0 && index < this->zoneCounts[type])
+		{
+			this->zoneTimes[this->GetZoneOffset(pro, type) + index] = time;
+		}
+	}
+
+	size_t GetMemoryUsage() const
+	{
+		return sizeof(PBData) + this->zoneTimes.capacity() * sizeof(f64);
+	}
+
+private:
+	// Overall zone times followed by pro zone times, each as splits, checkpoints then stages. -1 marks a zone without a time.
+	std::vector<f64> zoneTimes;
+	u8 zoneCounts[PBZONE_COUNT] {};
+
+	u32 GetZoneOffset(bool pro, PBZoneType type) const
+	{
+		u32 offset = pro ? this->zoneCounts[PBZONE_SPLIT] + this->zoneCounts[PBZONE_CHECKPOINT] + this->zoneCounts[PBZONE_STAGE] : 0;
+		for (u32 i = 0; i < type; i++)
+		{
+			offset += this->zoneCounts[i];
+		}
+		return offset;
+	}
+};
+
+// Convert mode and course ID to one single value.
+typedef u64 PBDataKey;
+
+inline PBDataKey ToPBDataKey(u32 modeID, u32 courseID)
+{
+	return modeID | ((u64)courseID << 32);
+}
+
+inline void ConvertFromPBDataKey(PBDataKey key, uint32_t *modeID, uint32_t *courseID)
+{
+	if (modeID)
+	{
+		*modeID = (uint32_t)key;
+	}
+	if (courseID)
+	{
+		*courseID = (uint32_t)(key >> 32);
+	}
+}
+
+// Open addressing table with linear probing. Entries are never removed one by one, only cleared all at once,
+// so there are no tombstones and probing never touches the much larger entries.
+class PBDataCache
+{
+public:
+	// Returns nullptr if there is no entry for the key.
+	PBData *Find(PBDataKey key);
+
+	const PBData *Find(PBDataKey key) const
+	{
+		return const_cast<PBDataCache *>(this)->Find(key);
+	}
+
+	// Returns the entry for the key, inserting one sized for the course if needed. Pointers to entries are invalidated by insertions.
+	PBData &FindOrInsert(PBDataKey key, const KZCourseDescriptor *course);
+	void Clear();
+
+	u32 Count() const
+	{
+		return this->count;
+	}
+
+	size_t GetMemoryUsage() const;
+
+private:
+	std::vector<PBDataKey> keys;
+	std::vector<bool> used;
+	std::vector<PBData> values;
+	u32 count {};
+
+	u32 GetSlot(PBDataKey key) const;
+	void Grow();
+};
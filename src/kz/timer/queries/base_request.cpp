@@ -1,3 +1,5 @@
+#include <algorithm>
+
 #include "base_request.h"
 #include "kz/db/kz_db.h"
 #include "kz/global/kz_global.h"
@@ -5,6 +7,7 @@
 #include "kz/mode/kz_mode.h"
 #include "kz/style/kz_style.h"
 #include "utils/ctimer.h"
+#include "kz/mappingapi/kz_mappingapi.h"
 
 #include "vendor/sql_mm/src/public/sql_mm.h"
 
@@ -100,47 +103,310 @@ void BaseRequest::Init(u64 features, const CCommand *args, bool queryLocal, bool
 	}
 }
 
+u64 BaseRequest::AllocateSlot()
+{
+	u32 index;
+	if (!freeSlots.empty())
+	{
+		index = freeSlots.back();
+		freeSlots.pop_back();
+	}
+	else
+	{
+		index = slots.size();
+		slots.push_back({nullptr, 1});
+	}
+	return ((u64)slots[index].generation << 32) | index;
+}
+
 BaseRequest *BaseRequest::Find(u64 uid)
 {
-	auto it = std::find_if(instances.begin(), instances.end(), [uid](BaseRequest *instance) { return instance->uid == uid; });
-	return (it != instances.end()) ? *it : nullptr;
+	u32 index = (u32)uid;
+	if (index >= slots.size() || slots[index].generation != (u32)(uid >> 32))
+	{
+		return nullptr;
+	}
+	return slots[index].request.get();
 }
 
 void BaseRequest::Remove(u64 uid)
 {
-	auto it = std::find_if(instances.begin(), instances.end(), [uid](BaseRequest *instance) { return instance->uid == uid; });
-	if (it != instances.end())
+	BaseRequest *req = Find(uid);
+	if (!req)
+	{
+		return;
+	}
+
+	auto it = inFlight.find(req->coalesceKey);
+	if (it != inFlight.end() && it->second == uid)
+	{
+		inFlight.erase(it);
+	}
+	if (req->cached)
+	{
+		cachedRequests.erase(std::find(cachedRequests.begin(), cachedRequests.end(), uid));
+	}
+	// The waiters still expect an answer, give them whatever this request obtained.
+	if (!req->replied)
+	{
+		req->ReplyWaiters();
+	}
+
+	u32 index = (u32)uid;
+	std::unique_ptr<BaseRequest> request = std::move(slots[index].request);
+	slots[index].generation++;
+	freeSlots.push_back(index);
+}
+
+void BaseRequest::Start(u64 uid)
+{
+	BaseRequest *req = Find(uid);
+	if (!req)
 	{
-		delete *it;
-		instances.erase(it);
+		return;
 	}
+	deadlines.push_back({req->timestamp + req->timeout, uid});
+	std::push_heap(deadlines.begin(), deadlines.end(), std::greater<Deadline>());
+	Advance(uid);
 }
 
-void BaseRequest::CheckRequests()
+void BaseRequest::Advance(u64 uid)
+{
+	BaseRequest *req = Find(uid);
+	if (!req)
+	{
+		return;
+	}
+	// A query can complete while the request is still sending the others, pick it up once that is done.
+	if (req->cached)
+	{
+		return;
+	}
+	if (req->advancing)
+	{
+		req->advanceAgain = true;
+		return;
+	}
+
+	req->advancing = true;
+	do
+	{
+		req->advanceAgain = false;
+		if (!req->isValid || req->TryCoalesce())
+		{
+			break;
+		}
+		req->QueryLocal();
+		req->QueryGlobal();
+		req->CheckReply();
+	} while (req->advanceAgain);
+	req->advancing = false;
+
+	if (!req->isValid)
+	{
+		if (req->replied && req->IsCacheable())
+		{
+			CacheResult(uid);
+		}
+		else
+		{
+			Remove(uid);
+		}
+	}
+}
+
+bool BaseRequest::TryCoalesce()
 {
-	// clang-format off
-	instances.erase(std::remove_if(instances.begin(), instances.end(),
-		[](BaseRequest *instance)
+	if (!this->coalesceKey.empty() || this->requestingFirstCourse || this->requestingLocalPlayer || this->requestingGlobalPlayer)
+	{
+		return false;
+	}
+	// Only requests that haven't sent anything yet can wait for another one.
+	if (this->localStatus == ResponseStatus::PENDING || this->globalStatus == ResponseStatus::PENDING
+		|| (this->localStatus != ResponseStatus::ENABLED && this->globalStatus != ResponseStatus::ENABLED))
+	{
+		return false;
+	}
+
+	std::string key = tfm::format("%p|%llu|%i|%i", this->typeTag, this->features, (i32)this->localStatus, (i32)this->globalStatus);
+	if (this->HasFeature(RequestFeature::Map))
+	{
+		key += tfm::format("|%s", this->mapName.Get());
+	}
+	if (this->HasFeature(RequestFeature::Course))
+	{
+		key += tfm::format("|%s", this->courseName.Get());
+	}
+	if (this->HasFeature(RequestFeature::Mode))
+	{
+		key += tfm::format("|%s|%llu", this->modeName.Get(), this->localModeID);
+	}
+	if (this->HasFeature(RequestFeature::Style))
+	{
+		key += tfm::format("|%llu", this->localStyleIDs);
+		FOR_EACH_VEC(this->styleList, i)
 		{
-			instance->QueryLocal();
-			instance->QueryGlobal();
-			instance->CheckReply();
-			if (!instance->isValid)
-			{
-				delete instance;
-				return true;
-			}
-			else if (instance->timestamp + instance->timeout < g_pKZUtils->GetServerGlobals()->realtime)
+			key += tfm::format(",%s", this->styleList[i].Get());
+		}
+	}
+	if (this->HasFeature(RequestFeature::Player))
+	{
+		key += tfm::format("|%llu|%s", this->targetSteamID64, this->targetPlayerName.Get());
+	}
+	key += tfm::format("|%llu|%llu", this->limit, this->offset);
+
+	auto it = inFlight.find(key);
+	if (it != inFlight.end())
+	{
+		BaseRequest *leader = Find(it->second);
+		if (leader && leader->cached)
+		{
+			f64 now = g_pKZUtils->GetServerGlobals()->realtime;
+			if (!leader->globalRequested || now - leader->cachedAt < KZ_REQUEST_CACHE_GLOBAL_TTL)
 			{
-				// Force a reply with whatever data the instance has obtained.
-				instance->Reply();
-				delete instance;
+				cacheStats.hits++;
+				leader->ReplyTo(this->userID);
+				this->Invalidate();
 				return true;
 			}
-			return false;
-		}),
-		instances.end());
-	// clang-format on
+			Remove(leader->uid);
+		}
+		else if (leader && leader->isValid && !leader->replied)
+		{
+			cacheStats.coalesced++;
+			leader->waiters.push_back(this->userID);
+			this->Invalidate();
+			return true;
+		}
+	}
+	cacheStats.misses++;
+	this->coalesceKey = key;
+	this->localRequested = this->localStatus == ResponseStatus::ENABLED;
+	this->globalRequested = this->globalStatus == ResponseStatus::ENABLED;
+	inFlight[this->coalesceKey] = this->uid;
+	return false;
+}
+
+bool BaseRequest::IsCacheable()
+{
+	if (this->coalesceKey.empty() || this->stale)
+	{
+		return false;
+	}
+	// Partial answers (e.g. the API timed out) shouldn't be handed out to anyone else.
+	return (!this->localRequested || this->localStatus == ResponseStatus::RECEIVED)
+		   && (!this->globalRequested || this->globalStatus == ResponseStatus::RECEIVED);
+}
+
+void BaseRequest::CacheResult(u64 uid)
+{
+	BaseRequest *req = Find(uid);
+	if (!req)
+	{
+		return;
+	}
+	req->cached = true;
+	req->cachedAt = g_pKZUtils->GetServerGlobals()->realtime;
+	req->waiters.clear();
+	cachedRequests.push_back(uid);
+	if (cachedRequests.size() > KZ_REQUEST_CACHE_SIZE)
+	{
+		Remove(cachedRequests.front());
+	}
+}
+
+void BaseRequest::InvalidateResults(const char *mapName, const KZCourseDescriptor *course, bool local, u64 localModeID, KZ::API::Mode apiMode)
+{
+	std::vector<u64> matches;
+	for (auto &[key, uid] : inFlight)
+	{
+		BaseRequest *req = Find(uid);
+		if (!req || !(local ? req->localRequested : req->globalRequested))
+		{
+			continue;
+		}
+		if (req->HasFeature(RequestFeature::Map) && V_stricmp(req->mapName.Get(), mapName))
+		{
+			continue;
+		}
+		if (req->HasFeature(RequestFeature::Course) && course && V_stricmp(req->courseName.Get(), course->name)
+			&& atoi(req->courseName.Get()) != course->id)
+		{
+			continue;
+		}
+		if (req->HasFeature(RequestFeature::Mode) && (local ? req->localModeID != localModeID : req->apiMode != apiMode))
+		{
+			continue;
+		}
+		matches.push_back(uid);
+	}
+
+	for (u64 uid : matches)
+	{
+		BaseRequest *req = Find(uid);
+		cacheStats.invalidated++;
+		if (req->cached)
+		{
+			Remove(uid);
+			continue;
+		}
+		// Still in flight, let it answer its players but keep it out of the cache.
+		req->stale = true;
+		inFlight.erase(req->coalesceKey);
+	}
+}
+
+BaseRequest::CacheStats BaseRequest::GetCacheStats()
+{
+	CacheStats stats = cacheStats;
+	stats.size = cachedRequests.size();
+	return stats;
+}
+
+void BaseRequest::ReplyAll()
+{
+	this->replied = true;
+	this->Reply();
+	this->ReplyWaiters();
+}
+
+void BaseRequest::ReplyWaiters()
+{
+	for (CPlayerUserId waiter : this->waiters)
+	{
+		this->ReplyTo(waiter);
+	}
+}
+
+void BaseRequest::ReplyTo(CPlayerUserId userID)
+{
+	CPlayerUserId owner = this->userID;
+	this->userID = userID;
+	this->Reply();
+	this->userID = owner;
+}
+
+void BaseRequest::CheckRequests()
+{
+	f64 now = g_pKZUtils->GetServerGlobals()->realtime;
+	while (!deadlines.empty() && deadlines.front().time < now)
+	{
+		u64 uid = deadlines.front().uid;
+		std::pop_heap(deadlines.begin(), deadlines.end(), std::greater<Deadline>());
+		deadlines.pop_back();
+
+		BaseRequest *req = Find(uid);
+		if (!req || req->cached)
+		{
+			continue;
+		}
+		// Force a reply with whatever data the instance has obtained.
+		if (req->isValid && !req->replied)
+		{
+			req->ReplyAll();
+		}
+		Remove(uid);
+	}
 }
 
 /*
@@ -204,7 +470,7 @@ void BaseRequest::SetupCourse(CUtlString courseName)
 		u64 uid = this->uid;
 		auto onQuerySuccess = [uid](std::vector<ISQLQuery *> queries)
 		{
-			BaseRequest *req = BaseRequest::Find(uid);
+			auto req = BaseRequest::Resolve<BaseRequest>(uid);
 			if (req)
 			{
 				req->requestingFirstCourse = false;
@@ -223,7 +489,7 @@ void BaseRequest::SetupCourse(CUtlString courseName)
 
 		auto onQueryFailure = [uid](std::string, int)
 		{
-			BaseRequest *req = BaseRequest::Find(uid);
+			auto req = BaseRequest::Resolve<BaseRequest>(uid);
 			if (req)
 			{
 				req->requestingFirstCourse = false;
@@ -280,7 +546,7 @@ void BaseRequest::SetupPlayer(CUtlString playerName)
 		this->requestingLocalPlayer = true;
 		auto onQuerySuccess = [uid = this->uid](std::vector<ISQLQuery *> queries)
 		{
-			BaseRequest *req = BaseRequest::Find(uid);
+			auto req = BaseRequest::Resolve<BaseRequest>(uid);
 			if (req)
 			{
 				ISQLResult *result = queries[0]->GetResultSet();
@@ -303,7 +569,7 @@ void BaseRequest::SetupPlayer(CUtlString playerName)
 
 		auto onQueryFailure = [uid = this->uid](std::string, int)
 		{
-			BaseRequest *req = BaseRequest::Find(uid);
+			auto req = BaseRequest::Resolve<BaseRequest>(uid);
 			if (req)
 			{
 				if (req->globalStatus == ResponseStatus::ENABLED)
@@ -430,3 +696,22 @@ void BaseRequest::SetupStyles(CUtlString styleNames)
 		}
 	}
 };
+
+static_function SCMD_CALLBACK(Command_KzRequestCacheStats)
+{
+	KZPlayer *player = g_pKZPlayerManager->ToPlayer(controller);
+	BaseRequest::CacheStats stats = BaseRequest::GetCacheStats();
+	u64 total = stats.hits + stats.coalesced + stats.misses;
+
+	player->PrintConsole(false, false, "[KZ::Request] Hits: %llu, coalesced: %llu, misses: %llu (%.1f%% served without a query)", stats.hits,
+						 stats.coalesced, stats.misses, total ? (stats.hits + stats.coalesced) * 100.0 / total : 0.0);
+	player->PrintConsole(false, false, "[KZ::Request] Cached results: %llu/%i, invalidated: %llu", stats.size, KZ_REQUEST_CACHE_SIZE,
+						 stats.invalidated);
+
+	return MRES_SUPERCEDE;
+}
+
+void KZTimerService::RegisterRequestCacheCommand()
+{
+	scmd::RegisterCmd("kz_requestcache", Command_KzRequestCacheStats, true);
+}
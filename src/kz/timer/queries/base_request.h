@@ -2,6 +2,7 @@
 #include <memory>
 #include <vector>
 #include <functional>
+#include <unordered_map>
 
 #include "common.h"
 #include "utils/utils.h"
@@ -10,6 +11,13 @@
 #include "kz/global/api.h"
 #include "kz/language/kz_language.h"
 
+// Finished requests are kept around to answer identical requests until a new time invalidates them.
+#define KZ_REQUEST_CACHE_SIZE 256
+// Other servers can set global records without this server hearing about it.
+#define KZ_REQUEST_CACHE_GLOBAL_TTL 60.0
+
+struct KZCourseDescriptor;
+
 struct BaseRequest
 {
 protected:
@@ -20,29 +28,162 @@ public:
 	virtual void Init(u64 features, const CCommand *args, bool queryLocal, bool queryGlobal);
 
 protected:
-	static inline u64 idCount = 0;
-	static inline std::vector<BaseRequest *> instances;
 	static inline constexpr const char *paramKeys[] = {"c", "course", "mode", "map", "o", "offset", "l", "limit", "s", "style"};
 	f64 timeout = 5.0f;
 
+	// Requests live in a slot map. A uid packs the slot index with the generation of the slot,
+	// so the uid of a finished request resolves to nothing even after its slot is reused.
+	struct Slot
+	{
+		std::unique_ptr<BaseRequest> request;
+		u32 generation;
+	};
+
+	static inline std::vector<Slot> slots;
+	static inline std::vector<u32> freeSlots;
+
+	struct Deadline
+	{
+		f64 time;
+		u64 uid;
+
+		bool operator>(const Deadline &other) const
+		{
+			return time > other.time;
+		}
+	};
+
+	// Min-heap of request timeouts.
+	static inline std::vector<Deadline> deadlines;
+	// In-flight and cached requests by their parameters, identical requests are answered by these instead of querying again.
+	static inline std::unordered_map<std::string, u64> inFlight;
+	// Cached requests, oldest first.
+	static inline std::vector<u64> cachedRequests;
+
+public:
+	struct CacheStats
+	{
+		u64 hits;
+		u64 coalesced;
+		u64 misses;
+		u64 invalidated;
+		u64 size;
+	};
+
+protected:
+	static inline CacheStats cacheStats {};
+
+	const void *typeTag {};
+	std::string coalesceKey;
+	// Which sources were queried, a result is only cached if all of them answered.
+	bool localRequested {};
+	bool globalRequested {};
+	bool cached {};
+	f64 cachedAt {};
+	// Set when a new time arrives while the request is in flight, its answer might predate it.
+	bool stale {};
+	// Players that made the same request while this one was in flight, they get the same reply.
+	std::vector<CPlayerUserId> waiters;
+	bool advancing {};
+	bool advanceAgain {};
+	bool replied {};
+
+	static u64 AllocateSlot();
+
+	template<typename T>
+	static const void *GetTypeTag()
+	{
+		static_persist char tag;
+		return &tag;
+	}
+
+	// Returns true if the request was handed over to an identical in-flight or cached request.
+	bool TryCoalesce();
+	void ReplyAll();
+	void ReplyWaiters();
+	void ReplyTo(CPlayerUserId userID);
+
+	bool IsCacheable();
+	static void CacheResult(u64 uid);
+	static void InvalidateResults(const char *mapName, const KZCourseDescriptor *course, bool local, u64 localModeID, KZ::API::Mode apiMode);
+
 public:
-	template<typename T, typename... Args>
-	static T *Create(KZPlayer *player, u64 features, bool queryLocal, bool queryGlobal, const CCommand *args)
+	template<typename T>
+	static u64 Create(KZPlayer *player, u64 features, bool queryLocal, bool queryGlobal, const CCommand *args)
 	{
-		auto obj = new T(idCount++, player);
+		u64 uid = AllocateSlot();
+		auto obj = new T(uid, player);
+		slots[(u32)uid].request.reset(obj);
+		obj->typeTag = GetTypeTag<T>();
+		// Completions that arrive before Init is done are picked up by Start.
+		obj->advancing = true;
 		obj->Init(features, args, queryLocal, queryGlobal);
-		instances.push_back(obj);
-		return obj;
+		obj->advancing = false;
+		Start(uid);
+		return uid;
+	}
+
+	// Completions resolve their request through this handle, the request moves on to its next step once the handle goes out of scope.
+	template<typename T>
+	struct Handle
+	{
+		u64 uid;
+		T *request;
+
+		Handle(u64 uid) : uid(uid), request(static_cast<T *>(BaseRequest::Find(uid))) {}
+
+		Handle(const Handle &) = delete;
+
+		~Handle()
+		{
+			if (request)
+			{
+				BaseRequest::Advance(uid);
+			}
+		}
+
+		T *operator->()
+		{
+			return request;
+		}
+
+		explicit operator bool() const
+		{
+			return request != nullptr;
+		}
+	};
+
+	template<typename T>
+	static Handle<T> Resolve(u64 uid)
+	{
+		return Handle<T>(uid);
 	}
 
 	static BaseRequest *Find(u64 uid);
 	static void Remove(u64 uid);
+	static void Start(u64 uid);
+	// Send whatever queries the request is ready for, and reply once every query got its response.
+	static void Advance(u64 uid);
 	static void CheckRequests();
 
+	static CacheStats GetCacheStats();
+
+	// Forget cached answers that include the local times of a course.
+	static void InvalidateLocalResults(const char *mapName, const KZCourseDescriptor *course, u64 localModeID)
+	{
+		InvalidateResults(mapName, course, true, localModeID, {});
+	}
+
+	// Forget cached answers that include the global times of a course.
+	static void InvalidateGlobalResults(const char *mapName, const KZCourseDescriptor *course, KZ::API::Mode apiMode)
+	{
+		InvalidateResults(mapName, course, false, {}, apiMode);
+	}
+
 public:
 	const u64 uid;
-	// UserID for callback.
-	const CPlayerUserId userID;
+	// UserID for callback, temporarily swapped to each waiter while replying.
+	CPlayerUserId userID;
 	const f64 timestamp;
 
 	bool isValid = true;
@@ -105,7 +246,7 @@ public:
 		if ((localStatus == ResponseStatus::RECEIVED || localStatus == ResponseStatus::DISABLED)
 			&& (globalStatus == ResponseStatus::RECEIVED || globalStatus == ResponseStatus::DISABLED))
 		{
-			Reply();
+			ReplyAll();
 			Invalidate();
 		}
 	};
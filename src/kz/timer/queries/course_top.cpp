@@ -144,7 +144,7 @@ struct CourseTopRequest : public BaseRequest
 
 			auto onQuerySuccess = [uid](std::vector<ISQLQuery *> queries)
 			{
-				CourseTopRequest *req = (CourseTopRequest *)CourseTopRequest::Find(uid);
+				auto req = CourseTopRequest::Resolve<CourseTopRequest>(uid);
 				if (!req)
 				{
 					return;
@@ -173,7 +173,7 @@ struct CourseTopRequest : public BaseRequest
 
 			auto onQueryFailure = [uid](std::string, int)
 			{
-				CourseTopRequest *req = (CourseTopRequest *)CourseTopRequest::Find(uid);
+				auto req = CourseTopRequest::Resolve<CourseTopRequest>(uid);
 				if (req)
 				{
 					req->localStatus = ResponseStatus::DISABLED;
@@ -196,7 +196,7 @@ struct CourseTopRequest : public BaseRequest
 		{
 			auto callback = [uid = this->uid](KZ::API::events::CourseTop &ctops)
 			{
-				CourseTopRequest *req = (CourseTopRequest *)CourseTopRequest::Find(uid);
+				auto req = CourseTopRequest::Resolve<CourseTopRequest>(uid);
 				if (!req)
 				{
 					return;
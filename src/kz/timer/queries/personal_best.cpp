@@ -108,7 +108,7 @@ struct PBRequest : public BaseRequest
 		this->globalStatus = ResponseStatus::PENDING;
 		auto callback = [uid = this->uid](KZ::API::events::PersonalBest &pb)
 		{
-			PBRequest *req = (PBRequest *)PBRequest::Find(uid);
+			auto req = PBRequest::Resolve<PBRequest>(uid);
 			if (!req)
 			{
 				return;
@@ -329,7 +329,7 @@ struct PBRequest : public BaseRequest
 
 		auto onQuerySuccess = [uid](std::vector<ISQLQuery *> queries)
 		{
-			PBRequest *req = (PBRequest *)PBRequest::Find(uid);
+			auto req = PBRequest::Resolve<PBRequest>(uid);
 			if (req)
 			{
 				ISQLResult *result = queries[0]->GetResultSet();
@@ -372,7 +372,7 @@ struct PBRequest : public BaseRequest
 
 		auto onQueryFailure = [uid](std::string, int)
 		{
-			PBRequest *req = (PBRequest *)PBRequest::Find(uid);
+			auto req = PBRequest::Resolve<PBRequest>(uid);
 			if (req)
 			{
 				req->localStatus = ResponseStatus::DISABLED;
@@ -387,7 +387,7 @@ struct PBRequest : public BaseRequest
 		u64 uid = this->uid;
 		auto onQuerySuccess = [uid](std::vector<ISQLQuery *> queries)
 		{
-			PBRequest *req = (PBRequest *)PBRequest::Find(uid);
+			auto req = PBRequest::Resolve<PBRequest>(uid);
 			if (req)
 			{
 				ISQLResult *result = queries[0]->GetResultSet();
@@ -408,12 +408,13 @@ struct PBRequest : public BaseRequest
 						req->pbData.runTimePro = result->GetFloat(0);
 					}
 				}
+				req->localStatus = ResponseStatus::RECEIVED;
 			}
 		};
 
 		auto onQueryFailure = [uid](std::string, int)
 		{
-			PBRequest *req = (PBRequest *)PBRequest::Find(uid);
+			auto req = PBRequest::Resolve<PBRequest>(uid);
 			if (req)
 			{
 				req->localStatus = ResponseStatus::DISABLED;
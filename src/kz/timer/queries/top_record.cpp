@@ -46,7 +46,7 @@ struct TopRecordRequest : public BaseRequest
 		{
 			auto callback = [uid = this->uid](KZ::API::events::WorldRecords &wrs)
 			{
-				TopRecordRequest *req = (TopRecordRequest *)TopRecordRequest::Find(uid);
+				auto req = TopRecordRequest::Resolve<TopRecordRequest>(uid);
 				if (!req)
 				{
 					return;
@@ -105,7 +105,7 @@ struct TopRecordRequest : public BaseRequest
 
 			auto onQuerySuccess = [uid](std::vector<ISQLQuery *> queries)
 			{
-				TopRecordRequest *req = (TopRecordRequest *)TopRecordRequest::Find(uid);
+				auto req = TopRecordRequest::Resolve<TopRecordRequest>(uid);
 				if (!req)
 				{
 					return;
@@ -135,7 +135,7 @@ struct TopRecordRequest : public BaseRequest
 
 			auto onQueryFailure = [uid](std::string, int)
 			{
-				TopRecordRequest *req = (TopRecordRequest *)TopRecordRequest::Find(uid);
+				auto req = TopRecordRequest::Resolve<TopRecordRequest>(uid);
 				if (req)
 				{
 					req->localStatus = ResponseStatus::DISABLED;
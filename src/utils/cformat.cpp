@@ -0,0 +1,260 @@
+#include <cassert>
+#include <cstring>
+
+#include "cformat.h"
+
+/*
+ * Credit to Szwagi
+ */
+
+static_function char ConvertColorStringToByte(const char *str, size_t length)
+{
+	switch (length)
+	{
+		case 3:
+			if (!memcmp(str, "red", length))
+			{
+				return 7;
+			}
+			break;
+		case 4:
+			if (!memcmp(str, "blue", length))
+			{
+				return 11;
+			}
+			if (!memcmp(str, "lime", length))
+			{
+				return 6;
+			}
+			if (!memcmp(str, "grey", length))
+			{
+				return 8;
+			}
+			if (!memcmp(str, "gold", length))
+			{
+				return 16;
+			}
+			break;
+		case 5:
+			if (!memcmp(str, "green", length))
+			{
+				return 4;
+			}
+			if (!memcmp(str, "grey2", length))
+			{
+				return 13;
+			}
+			if (!memcmp(str, "olive", length))
+			{
+				return 5;
+			}
+			break;
+		case 6:
+			if (!memcmp(str, "purple", length))
+			{
+				return 3;
+			}
+			if (!memcmp(str, "orchid", length))
+			{
+				return 14;
+			}
+			if (!memcmp(str, "yellow", length))
+			{
+				return 9;
+			}
+			break;
+		case 7:
+			if (!memcmp(str, "default", length))
+			{
+				return 1;
+			}
+			if (!memcmp(str, "darkred", length))
+			{
+				return 2;
+			}
+			break;
+		case 8:
+			if (!memcmp(str, "darkblue", length))
+			{
+				return 12;
+			}
+			if (!memcmp(str, "lightred", length))
+			{
+				return 15;
+			}
+			if (!memcmp(str, "bluegrey", length))
+			{
+				return 10;
+			}
+			break;
+	}
+	return 0;
+}
+
+enum CFormatResult
+{
+	CFORMAT_NOT_US,
+	CFORMAT_OK,
+	CFORMAT_OUT_OF_SPACE,
+};
+
+struct CFormatContext
+{
+	const char *current;
+	char *result;
+	char *result_end;
+};
+
+static_function bool HasEnoughSpace(const CFormatContext *ctx, uintptr_t space)
+{
+	return (uintptr_t)(ctx->result_end - ctx->result) > space;
+}
+
+static_function CFormatResult EscapeChars(CFormatContext *ctx)
+{
+	if (*ctx->current == '{' && *(ctx->current + 1) == '{')
+	{
+		if (!HasEnoughSpace(ctx, 1))
+		{
+			return CFORMAT_OUT_OF_SPACE;
+		}
+
+		ctx->current += 2;
+		*ctx->result++ = '{';
+		return CFORMAT_OK;
+	}
+	return CFORMAT_NOT_US;
+}
+
+static_function CFormatResult ParseColors(CFormatContext *ctx)
+{
+	const char *current = ctx->current;
+	if (*current == '{')
+	{
+		current++;
+		const char *start = current;
+		while (*current && *current != '}')
+		{
+			current++;
+		}
+		if (*current == '}')
+		{
+			int length = current - start;
+			current++;
+			if (char byte = ConvertColorStringToByte(start, length); byte)
+			{
+				if (!HasEnoughSpace(ctx, 1))
+				{
+					return CFORMAT_OUT_OF_SPACE;
+				}
+
+				*ctx->result++ = byte;
+				ctx->current = current;
+				return CFORMAT_OK;
+			}
+		}
+	}
+	return CFORMAT_NOT_US;
+}
+
+static_function CFormatResult ReplaceNewlines(CFormatContext *ctx)
+{
+	if (*ctx->current == '\n')
+	{
+		if (!HasEnoughSpace(ctx, 3))
+		{
+			return CFORMAT_OUT_OF_SPACE;
+		}
+
+		ctx->current++;
+		*ctx->result++ = '\xe2';
+		*ctx->result++ = '\x80';
+		*ctx->result++ = '\xa9';
+		return CFORMAT_OK;
+	}
+	return CFORMAT_NOT_US;
+}
+
+static_function CFormatResult AddSpace(CFormatContext *ctx)
+{
+	if (!HasEnoughSpace(ctx, 1))
+	{
+		return CFORMAT_OUT_OF_SPACE;
+	}
+	*ctx->result++ = ' ';
+	return CFORMAT_OK;
+}
+
+bool utils::CFormat(char *buffer, u64 buffer_size, const char *text)
+{
+	assert(buffer_size != 0);
+
+	CFormatContext ctx;
+	ctx.current = text;
+	ctx.result = buffer;
+	ctx.result_end = buffer + buffer_size;
+
+	if (AddSpace(&ctx) != CFORMAT_OK)
+	{
+		return false;
+	}
+
+	while (*ctx.current)
+	{
+		auto escape_chars = EscapeChars(&ctx);
+		if (escape_chars == CFORMAT_OK)
+		{
+			continue;
+		}
+		if (escape_chars == CFORMAT_OUT_OF_SPACE)
+		{
+			return false;
+		}
+
+		auto parse_colors = ParseColors(&ctx);
+		if (parse_colors == CFORMAT_OK)
+		{
+			continue;
+		}
+		if (parse_colors == CFORMAT_OUT_OF_SPACE)
+		{
+			return false;
+		}
+
+		auto replace_newlines = ReplaceNewlines(&ctx);
+		if (replace_newlines == CFORMAT_OK)
+		{
+			continue;
+		}
+		if (replace_newlines == CFORMAT_OUT_OF_SPACE)
+		{
+			return false;
+		}
+
+		// Everything else
+		if (!HasEnoughSpace(&ctx, 1))
+		{
+			return false;
+		}
+		*ctx.result++ = *ctx.current++;
+	}
+
+	// Null terminate
+	if (!HasEnoughSpace(&ctx, 1))
+	{
+		return false;
+	}
+	*ctx.result++ = 0;
+
+	return true;
+}
+
+bool utils::CFormat(std::string &output, const char *text)
+{
+	// Each character expands to at most 3 bytes, plus the leading space and the null terminator.
+	// HasEnoughSpace() always wants one byte more than it writes, so the terminator needs one spare byte too.
+	output.resize(strlen(text) * 3 + 3);
+	bool result = CFormat(output.data(), output.size(), text);
+	output.resize(result ? strlen(output.c_str()) : 0);
+	return result;
+}
@@ -0,0 +1,12 @@
+#pragma once
+#include <string>
+
+#include "common.h"
+
+namespace utils
+{
+	// Replaces {color} tags and newlines with the bytes the chat expects, and adds the leading space.
+	bool CFormat(char *buffer, u64 buffer_size, const char *text);
+	// Format straight into a string that is grown to fit, such as a string field of a protobuf message.
+	bool CFormat(std::string &output, const char *text);
+} // namespace utils
@@ -1,41 +1,150 @@
-#include "ctimer.h"
+#include "ctimer_base.h"
+#include "utlvector.h"
+#include <algorithm>
+#include <unordered_map>
+#include <vector>
 
-CUtlVector<CTimerBase *> g_NonPersistentTimers;
-CUtlVector<CTimerBase *> g_PersistentTimers;
+// Timers are kept in one min-heap per clock keyed by their next execution time, so each frame only touches the timers that are due.
+// Cancelling a timer only forgets it, its heap entry is skipped once it reaches the top.
+struct TimerEntry
+{
+	f64 nextExecute;
+	CTimerBase *timer;
+	u64 sequence;
+
+	bool operator>(const TimerEntry &other) const
+	{
+		return nextExecute > other.nextExecute || (nextExecute == other.nextExecute && sequence > other.sequence);
+	}
+};
+
+struct TimerState
+{
+	u64 sequence;
+	bool persistent;
+};
+
+static_global struct
+{
+	std::vector<TimerEntry> heaps[2];
+	// Timers that were added since the last frame, they are scheduled once the clocks are available.
+	CUtlVector<CTimerBase *> pending;
+	std::unordered_map<CTimerBase *, TimerState> live;
+	u64 nextSequence;
+} g_timers;
+
+static_function std::vector<TimerEntry> &GetTimerHeap(CTimerBase *timer)
+{
+	return g_timers.heaps[timer->useRealTime ? 1 : 0];
+}
 
-static_function void ProcessTimerList(CUtlVector<CTimerBase *> &timers)
+static_function void PushTimer(CTimerBase *timer, u64 sequence, f64 nextExecute)
 {
-	for (int i = timers.Count() - 1; i >= 0; i--)
+	std::vector<TimerEntry> &heap = GetTimerHeap(timer);
+	heap.push_back({nextExecute, timer, sequence});
+	std::push_heap(heap.begin(), heap.end(), std::greater<TimerEntry>());
+}
+
+static_function bool IsTimerLive(const TimerEntry &entry)
+{
+	auto it = g_timers.live.find(entry.timer);
+	return it != g_timers.live.end() && it->second.sequence == entry.sequence;
+}
+
+static_function void ProcessTimerHeap(std::vector<TimerEntry> &heap, f64 currentTime)
+{
+	// Repeating timers go back on the heap once every due timer ran. An interval that is 0 or lost in the precision of
+	// currentTime would otherwise keep the timer due and never let this loop end.
+	static_persist std::vector<TimerEntry> rescheduled;
+	rescheduled.clear();
+
+	while (!heap.empty() && heap.front().nextExecute <= currentTime)
 	{
-		auto timer = timers[i];
-		f64 currentTime = timer->useRealTime ? g_pKZUtils->GetGlobals()->realtime : g_pKZUtils->GetGlobals()->curtime;
-		if (timer->lastExecute == -1)
+		TimerEntry entry = heap.front();
+		std::pop_heap(heap.begin(), heap.end(), std::greater<TimerEntry>());
+		heap.pop_back();
+
+		if (!IsTimerLive(entry))
 		{
-			timer->lastExecute = currentTime;
+			continue;
 		}
 
-		if (timer->lastExecute + timer->interval <= currentTime)
+		CTimerBase *timer = entry.timer;
+		bool repeat = timer->Execute();
+		// The timer may have been cancelled while it was executing.
+		if (!IsTimerLive(entry))
 		{
-			if (!timer->Execute())
-			{
-				delete timer;
-				timers.Remove(i);
-			}
-			else
-			{
-				timer->lastExecute = currentTime;
-			}
+			continue;
 		}
+		if (!repeat)
+		{
+			g_timers.live.erase(timer);
+			delete timer;
+			continue;
+		}
+		timer->lastExecute = currentTime;
+		rescheduled.push_back({currentTime + timer->interval, timer, entry.sequence});
 	}
+
+	for (const TimerEntry &entry : rescheduled)
+	{
+		PushTimer(entry.timer, entry.sequence, entry.nextExecute);
+	}
+}
+
+void ScheduleTimer(CTimerBase *timer, bool preserveMapChange)
+{
+	g_timers.live[timer] = {g_timers.nextSequence++, preserveMapChange};
+	g_timers.pending.AddToTail(timer);
 }
 
-void ProcessTimers()
+void CancelTimer(CTimerBase *timer)
 {
-	ProcessTimerList(g_PersistentTimers);
-	ProcessTimerList(g_NonPersistentTimers);
+	g_timers.live.erase(timer);
+	g_timers.pending.FindAndRemove(timer);
+}
+
+void ProcessTimers(f64 curtime, f64 realtime)
+{
+	f64 currentTimes[2] = {curtime, realtime};
+
+	FOR_EACH_VEC(g_timers.pending, i)
+	{
+		CTimerBase *timer = g_timers.pending[i];
+		auto it = g_timers.live.find(timer);
+		if (it == g_timers.live.end())
+		{
+			continue;
+		}
+		f64 currentTime = currentTimes[timer->useRealTime ? 1 : 0];
+		timer->lastExecute = currentTime;
+		PushTimer(timer, it->second.sequence, currentTime + timer->interval);
+	}
+	g_timers.pending.RemoveAll();
+
+	ProcessTimerHeap(g_timers.heaps[0], currentTimes[0]);
+	ProcessTimerHeap(g_timers.heaps[1], currentTimes[1]);
 }
 
 void RemoveNonPersistentTimers()
 {
-	g_NonPersistentTimers.PurgeAndDeleteElements();
+	for (auto it = g_timers.live.begin(); it != g_timers.live.end();)
+	{
+		if (it->second.persistent)
+		{
+			it++;
+			continue;
+		}
+		CTimerBase *timer = it->first;
+		g_timers.pending.FindAndRemove(timer);
+		it = g_timers.live.erase(it);
+		delete timer;
+	}
+
+	// Drop the entries of the removed timers so they don't pile up across maps.
+	for (std::vector<TimerEntry> &heap : g_timers.heaps)
+	{
+		heap.erase(std::remove_if(heap.begin(), heap.end(), [](const TimerEntry &entry) { return !IsTimerLive(entry); }), heap.end());
+		std::make_heap(heap.begin(), heap.end(), std::greater<TimerEntry>());
+	}
 }
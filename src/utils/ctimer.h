@@ -5,29 +5,12 @@
 #include "utils/utils.h"
 #include "../../hl2sdk-cs2/public/tier1/utlvector.h"
 #include "interfaces.h"
+#include "ctimer_base.h"
 
 /*
  * Credit to Szwagi
  */
 
-class CTimerBase
-{
-public:
-	CTimerBase(f64 initialInterval, bool useRealTime) : interval(initialInterval), useRealTime(useRealTime) {};
-
-	virtual bool Execute() = 0;
-
-	f64 interval {};
-	f64 lastExecute = -1;
-	bool useRealTime {};
-};
-
-void ProcessTimers();
-void RemoveNonPersistentTimers();
-
-extern CUtlVector<CTimerBase *> g_NonPersistentTimers;
-extern CUtlVector<CTimerBase *> g_PersistentTimers;
-
 template<typename... Args>
 class CTimer : public CTimerBase
 {
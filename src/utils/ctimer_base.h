@@ -0,0 +1,30 @@
+#pragma once
+#include "common.h"
+
+/*
+ * Credit to Szwagi
+ */
+
+// The scheduling half of ctimer.h, it doesn't need the SDK so scripts/bench-timers.sh can build it on its own.
+
+class CTimerBase
+{
+public:
+	CTimerBase(f64 initialInterval, bool useRealTime) : interval(initialInterval), useRealTime(useRealTime) {};
+
+	virtual bool Execute() = 0;
+
+	// Timers are deleted through this class once they stop.
+	virtual ~CTimerBase() = default;
+
+	f64 interval {};
+	f64 lastExecute = -1;
+	bool useRealTime {};
+};
+
+// Runs every timer that is due on either clock.
+void ProcessTimers(f64 curtime, f64 realtime);
+void RemoveNonPersistentTimers();
+// The timer pointer is its handle, cancelling does not delete the timer.
+void ScheduleTimer(CTimerBase *timer, bool preserveMapChange);
+void CancelTimer(CTimerBase *timer);
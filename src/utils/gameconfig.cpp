@@ -5,6 +5,7 @@
 #include <cstdint>
 #include "gameconfig.h"
 #include "addresses.h"
+#include "sigscan.h"
 
 CGameConfig::CGameConfig(const std::string &gameDir, const std::string &path)
 {
@@ -170,8 +171,96 @@ const char *CGameConfig::GetSymbol(const char *name)
 	return symbol + 1;
 }
 
+void CGameConfig::ResolveSignatures(const char *cachePath)
+{
+	struct PendingSignature
+	{
+		std::string name;
+		u64 hash;
+	};
+
+	f64 startTime = Plat_FloatTime();
+	sigscan::Cache cache;
+	cache.Load(cachePath);
+
+	u32 cached = 0;
+	std::unordered_map<CModule *, std::vector<sigscan::Pattern>> patterns;
+	std::unordered_map<CModule *, std::vector<PendingSignature>> pending;
+	for (auto &[name, signature] : m_umSignatures)
+	{
+		CModule **module = this->GetModule(name.c_str());
+		if (!module || !(*module) || signature.empty() || signature[0] == '@')
+		{
+			continue;
+		}
+		size_t length = 0;
+		byte *bytes = HexToByte(signature.c_str(), length);
+		if (!bytes)
+		{
+			continue;
+		}
+		sigscan::Pattern pattern(bytes, length);
+		delete[] bytes;
+
+		u64 hash = sigscan::HashString(signature.c_str());
+		u64 offset;
+		if (cache.Find((*module)->m_pszModule, (*module)->GetCacheKey(), hash, offset) && (*module)->MatchesAt(pattern, offset))
+		{
+			m_umAddresses[name] = (u8 *)(*module)->m_base + offset;
+			cached++;
+			continue;
+		}
+		patterns[*module].push_back(std::move(pattern));
+		pending[*module].push_back({name, hash});
+	}
+
+	u32 scanned = 0;
+	for (auto &[module, modulePatterns] : patterns)
+	{
+		std::vector<sigscan::Result> results;
+		module->FindSignatures(modulePatterns, results);
+		std::vector<PendingSignature> &signatures = pending[module];
+		for (size_t i = 0; i < results.size(); i++)
+		{
+			if (results[i].matches != 1)
+			{
+				m_umSignatureErrors[signatures[i].name] = results[i].matches ? SIG_FOUND_MULTIPLE : SIG_NOT_FOUND;
+				continue;
+			}
+			m_umAddresses[signatures[i].name] = results[i].address;
+			cache.Set(module->m_pszModule, module->GetCacheKey(), signatures[i].hash, (uintptr_t)results[i].address - (uintptr_t)module->m_base);
+			scanned++;
+		}
+	}
+	if (cache.IsDirty())
+	{
+		cache.Save(cachePath);
+	}
+	META_CONPRINTF("[KZ] Resolved %u signatures (%u cached, %u scanned) in %.2f ms\n", cached + scanned, cached, scanned,
+				   (Plat_FloatTime() - startTime) * 1000.0);
+}
+
 void *CGameConfig::ResolveSignature(const char *name)
 {
+	auto resolved = m_umAddresses.find(name);
+	if (resolved != m_umAddresses.end())
+	{
+		return resolved->second;
+	}
+	auto failed = m_umSignatureErrors.find(name);
+	if (failed != m_umSignatureErrors.end())
+	{
+		if (failed->second == SIG_FOUND_MULTIPLE)
+		{
+			Warning("Multiple addresses found for %s, defaulting to nullptr\n", name);
+		}
+		else
+		{
+			Warning("Failed to find address for %s\n", name);
+		}
+		return nullptr;
+	}
+
 	CModule **module = this->GetModule(name);
 	if (!module || !(*module))
 	{
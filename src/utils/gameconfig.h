@@ -23,6 +23,8 @@ public:
 	void *GetAddress(const std::string &name, void *engine, void *server, char *error, int maxlen);
 	CModule **GetModule(const char *name);
 	bool IsSymbol(const char *name);
+	// Scans every module once for all signatures that aren't in the cache file yet, ResolveSignature picks the results up afterwards.
+	void ResolveSignatures(const char *cachePath);
 	void *ResolveSignature(const char *name);
 	void *ResolveSignatureFromMov(const char *name);
 	static std::string GetDirectoryName(const std::string &directoryPathInput);
@@ -36,6 +38,7 @@ private:
 	std::unordered_map<std::string, int> m_umOffsets;
 	std::unordered_map<std::string, std::string> m_umSignatures;
 	std::unordered_map<std::string, void *> m_umAddresses;
+	std::unordered_map<std::string, int> m_umSignatureErrors;
 	std::unordered_map<std::string, std::string> m_umLibraries;
 	std::unordered_map<std::string, std::string> m_umPatches;
 };
@@ -12,6 +12,7 @@
 #include "cs2kz.h"
 #include "ctimer.h"
 #include "kz/kz.h"
+#include "kz/hud/kz_hud.h"
 #include "kz/jumpstats/kz_jumpstats.h"
 #include "kz/option/kz_option.h"
 #include "kz/quiet/kz_quiet.h"
@@ -462,6 +463,7 @@ static_function void Hook_GameFrame(bool simulating, bool bFirstTick, bool bLast
 	g_KZPlugin.serverGlobals = *(g_pKZUtils->GetGlobals());
 	RecordAnnounce::Check();
 	BaseRequest::CheckRequests();
+	KZDatabaseService::FlushWrites();
 	KZ::misc::EnforceTimeLimit();
 	KZTelemetryService::ActiveCheck();
 	RETURN_META(MRES_IGNORED);
@@ -582,6 +584,7 @@ static_function bool Hook_FireEvent(IGameEvent *event, bool bDontBroadcast)
 			if (player)
 			{
 				player->timerService->OnPlayerDeath();
+				player->quietService->UpdateHidingMask(false);
 				player->quietService->SendFullUpdate();
 			}
 		}
@@ -610,6 +613,7 @@ static_function bool Hook_FireEvent(IGameEvent *event, bool bDontBroadcast)
 				if (player)
 				{
 					player->timerService->OnPlayerSpawn();
+					player->quietService->UpdateHidingMask(true);
 				}
 			}
 		}
@@ -685,7 +689,8 @@ static_function CServerSideClientBase *Hook_ConnectClientPost(const char *pszNam
 // IGameSystem
 static_function void Hook_ServerGamePostSimulate(const EventServerGamePostSimulate_t *)
 {
-	ProcessTimers();
+	ProcessTimers(g_pKZUtils->GetGlobals()->curtime, g_pKZUtils->GetGlobals()->realtime);
+	KZHUDService::OnServerGamePostSimulate();
 	KZGlobalService::OnServerGamePostSimulate();
 }
 
@@ -1,11 +1,20 @@
 #pragma once
 #include "common.h"
 
+#include <charconv>
+#include <cmath>
+#include <string>
+#include <string_view>
+#include <type_traits>
+
 #include <vendor/json/single_include/nlohmann/json.hpp>
 #include <vendor/json/single_include/nlohmann/json_fwd.hpp>
 
 class Json
 {
+	friend class JsonWriter;
+
+
 public:
 	Json() : inner(nlohmann::json::object()) {}
 
@@ -413,3 +422,366 @@ private:
 		return true;
 	}
 };
+
+/**
+ * Streaming JSON serializer.
+ *
+ * Values are appended straight into a string buffer instead of building a `Json` tree first.
+ * The `Set()` overloads mirror the ones on `Json`, so `ToJson(JsonWriter &json)` implementations look the same.
+ */
+class JsonWriter
+{
+public:
+	/**
+	 * Returns an empty writer whose buffer is reused by every call on the same thread.
+	 *
+	 * The returned writer is only valid until the next call on the same thread.
+	 */
+	static JsonWriter &ForCurrentThread()
+	{
+		static_persist thread_local JsonWriter writer;
+		writer.Reset();
+		return writer;
+	}
+
+	void Reset()
+	{
+		this->buffer.clear();
+		this->needsComma = false;
+		this->afterKey = false;
+	}
+
+	const std::string &ToString() const
+	{
+		return this->buffer;
+	}
+
+	/**
+	 * Moves the written text out of the writer and leaves it empty.
+	 *
+	 * The next buffer is reserved at the size of the one taken, so a reused writer doesn't grow it again piece by piece.
+	 */
+	std::string TakeBuffer()
+	{
+		std::string taken = std::move(this->buffer);
+		this->Reset();
+		this->buffer.reserve(taken.size());
+		return taken;
+	}
+
+	void BeginObject()
+	{
+		this->BeginValue();
+		this->buffer += '{';
+		this->needsComma = false;
+	}
+
+	void EndObject()
+	{
+		this->buffer += '}';
+		this->needsComma = true;
+	}
+
+	void BeginArray()
+	{
+		this->BeginValue();
+		this->buffer += '[';
+		this->needsComma = false;
+	}
+
+	void EndArray()
+	{
+		this->buffer += ']';
+		this->needsComma = true;
+	}
+
+	void Key(std::string_view key)
+	{
+		this->BeginValue();
+		this->WriteString(key);
+		this->buffer += ':';
+		this->afterKey = true;
+	}
+
+	bool Value(bool value)
+	{
+		this->BeginValue();
+		this->buffer += value ? "true" : "false";
+		this->needsComma = true;
+		return true;
+	}
+
+	template<typename T, std::enable_if_t<std::is_integral_v<T> && !std::is_same_v<T, bool>, int> = 0>
+	bool Value(T value)
+	{
+		char text[24];
+		std::to_chars_result result = std::to_chars(text, text + sizeof(text), value);
+
+		this->BeginValue();
+		this->buffer.append(text, result.ptr - text);
+		this->needsComma = true;
+		return true;
+	}
+
+	bool Value(f64 value)
+	{
+		this->BeginValue();
+		this->needsComma = true;
+
+		// Same as nlohmann, non-finite numbers can't be represented in JSON.
+		if (!std::isfinite(value))
+		{
+			this->buffer += "null";
+			return true;
+		}
+
+		// Shortest text that reads back as the same value, instead of always printing 17 digits.
+		char text[32];
+		std::to_chars_result result = std::to_chars(text, text + sizeof(text), value);
+		size_t length = result.ptr - text;
+		this->buffer.append(text, length);
+
+		// Keep floats recognizable as floats on the other end.
+		if (std::string_view(text, length).find_first_of(".eE") == std::string_view::npos)
+		{
+			this->buffer += ".0";
+		}
+
+		return true;
+	}
+
+	bool Value(const char *value)
+	{
+		return this->Value(std::string_view(value));
+	}
+
+	bool Value(std::string_view value)
+	{
+		this->BeginValue();
+		this->WriteString(value);
+		this->needsComma = true;
+		return true;
+	}
+
+	bool Value(const std::string &value)
+	{
+		return this->Value(std::string_view(value));
+	}
+
+	bool Value(const Json &value)
+	{
+		if (!value.IsValid())
+		{
+			return false;
+		}
+
+		this->BeginValue();
+		this->buffer += value.inner.dump();
+		this->needsComma = true;
+		return true;
+	}
+
+	template<typename T>
+	auto Value(const T &value) -> decltype(value.ToJson(std::declval<JsonWriter &>()))
+	{
+		this->BeginObject();
+
+		if (!value.ToJson(*this))
+		{
+			return false;
+		}
+
+		this->EndObject();
+		return true;
+	}
+
+	template<typename T>
+	bool Value(const std::vector<T> &value)
+	{
+		this->BeginArray();
+
+		for (const auto &item : value)
+		{
+			if (!this->Value(item))
+			{
+				return false;
+			}
+		}
+
+		this->EndArray();
+		return true;
+	}
+
+	template<typename K, typename V>
+	bool Value(const std::unordered_map<K, V> &value)
+	{
+		this->BeginObject();
+
+		for (const auto &[k, v] : value)
+		{
+			char key[24];
+			std::to_chars_result result = std::to_chars(key, key + sizeof(key), k);
+			this->Key(std::string_view(key, result.ptr - key));
+
+			if (!this->Value(v))
+			{
+				return false;
+			}
+		}
+
+		this->EndObject();
+		return true;
+	}
+
+	template<typename T>
+	bool Set(std::string_view key, const T &value)
+	{
+		this->Key(key);
+		return this->Value(value);
+	}
+
+private:
+	std::string buffer;
+	bool needsComma = false;
+	bool afterKey = false;
+
+	void BeginValue()
+	{
+		if (this->afterKey)
+		{
+			this->afterKey = false;
+		}
+		else if (this->needsComma)
+		{
+			this->buffer += ',';
+		}
+	}
+
+	void WriteString(std::string_view value)
+	{
+		static_persist constexpr char hexDigits[] = "0123456789abcdef";
+
+		this->buffer += '"';
+
+		for (char c : value)
+		{
+			switch (c)
+			{
+				case '"':
+					this->buffer += "\\\"";
+					break;
+				case '\\':
+					this->buffer += "\\\\";
+					break;
+				case '\n':
+					this->buffer += "\\n";
+					break;
+				case '\r':
+					this->buffer += "\\r";
+					break;
+				case '\t':
+					this->buffer += "\\t";
+					break;
+				default:
+				{
+					if (static_cast<u8>(c) < 0x20)
+					{
+						this->buffer += "\\u00";
+						this->buffer += hexDigits[static_cast<u8>(c) >> 4];
+						this->buffer += hexDigits[static_cast<u8>(c) & 0xf];
+					}
+					else
+					{
+						this->buffer += c;
+					}
+				}
+			}
+		}
+
+		this->buffer += '"';
+	}
+};
+
+/**
+ * Base class for SAX-style JSON decoders.
+ *
+ * Every event is ignored by default; override the ones you care about.
+ * Returning `false` from any event stops parsing.
+ */
+class JsonSaxReader : public nlohmann::json_sax<nlohmann::json>
+{
+public:
+	/**
+	 * Feeds `text` through `reader`. Returns whether the whole document was consumed without errors.
+	 */
+	static bool Parse(std::string_view text, JsonSaxReader &reader)
+	{
+		return nlohmann::json::sax_parse(text.data(), text.data() + text.size(), &reader);
+	}
+
+	bool null() override
+	{
+		return true;
+	}
+
+	bool boolean(bool value) override
+	{
+		return true;
+	}
+
+	bool number_integer(number_integer_t value) override
+	{
+		return true;
+	}
+
+	bool number_unsigned(number_unsigned_t value) override
+	{
+		return true;
+	}
+
+	bool number_float(number_float_t value, const string_t &text) override
+	{
+		return true;
+	}
+
+	bool string(string_t &value) override
+	{
+		return true;
+	}
+
+	bool binary(binary_t &value) override
+	{
+		return true;
+	}
+
+	bool start_object(std::size_t elements) override
+	{
+		return true;
+	}
+
+	bool key(string_t &value) override
+	{
+		return true;
+	}
+
+	bool end_object() override
+	{
+		return true;
+	}
+
+	bool start_array(std::size_t elements) override
+	{
+		return true;
+	}
+
+	bool end_array() override
+	{
+		return true;
+	}
+
+	bool parse_error(std::size_t position, const std::string &lastToken, const nlohmann::detail::exception &error) override
+	{
+		META_CONPRINTF("[JSON] Parse error at byte %llu: %s\n", (u64)position, error.what());
+		return false;
+	}
+};
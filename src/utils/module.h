@@ -4,7 +4,9 @@
 #include "interface.h"
 #include "strtools.h"
 #include "plat.h"
+#include "sigscan.h"
 
+#include <algorithm>
 #include <string>
 #include <vector>
 
@@ -80,7 +82,7 @@ public:
 		m_size = m_hModuleInfo.SizeOfImage;
 		InitializeSections();
 #else
-		if (int e = GetModuleInformation(m_hModule, &m_base, &m_size, m_sections))
+		if (int e = GetModuleInformation(m_hModule, &m_base, &m_size, m_sections, m_szBuildID))
 		{
 			Error("Failed to get module info for %s, error %d\n", szModule, e);
 		}
@@ -89,38 +91,60 @@ public:
 
 	void *FindSignature(const byte *pData, size_t iSigLength, int &error)
 	{
-		unsigned char *pMemory;
-		void *return_addr = nullptr;
-		error = 0;
+		std::vector<sigscan::Pattern> patterns;
+		patterns.emplace_back(pData, iSigLength);
+		std::vector<sigscan::Result> results;
+		FindSignatures(patterns, results);
 
-		pMemory = (byte *)m_base;
+		error = results[0].matches == 0 ? SIG_NOT_FOUND : results[0].matches > 1 ? SIG_FOUND_MULTIPLE : SIG_OK;
+		return results[0].address;
+	}
+
+	// Resolves all patterns in a single pass over the executable sections.
+	void FindSignatures(const std::vector<sigscan::Pattern> &patterns, std::vector<sigscan::Result> &results)
+	{
+		sigscan::Scan(GetCodeRanges(), patterns, results);
+	}
 
-		for (size_t i = 0; i < m_size; i++)
+	bool MatchesAt(const sigscan::Pattern &pattern, uintptr_t offset)
+	{
+		uintptr_t address = (uintptr_t)m_base + offset;
+		for (const sigscan::Range &range : GetCodeRanges())
 		{
-			size_t Matches = 0;
-			while (*(pMemory + i + Matches) == pData[Matches] || pData[Matches] == '\x2A')
+			if (address >= (uintptr_t)range.base && address + pattern.bytes.size() <= (uintptr_t)range.base + range.size)
 			{
-				Matches++;
-				if (Matches == iSigLength)
-				{
-					if (return_addr)
-					{
-						error = SIG_FOUND_MULTIPLE;
-						return return_addr;
-					}
-
-					return_addr = (void *)(pMemory + i);
-					break;
-				}
+				return pattern.MatchesAt((const u8 *)address);
 			}
 		}
+		return false;
+	}
 
-		if (!return_addr)
+	// Identifies the exact binary, so cached signature offsets are only reused on the build they were found in.
+	std::string GetCacheKey()
+	{
+		char key[128];
+		V_snprintf(key, sizeof(key), "%s-%zx", m_szBuildID.empty() ? "nobuildid" : m_szBuildID.c_str(), m_size);
+		return key;
+	}
+
+	const std::vector<sigscan::Range> &GetCodeRanges()
+	{
+		if (m_codeRanges.empty())
 		{
-			error = SIG_NOT_FOUND;
+			for (auto &section : m_sections)
+			{
+				if (section.m_bExecutable && section.m_iSize > 0)
+				{
+					m_codeRanges.push_back({(u8 *)section.m_pBase, section.m_iSize});
+				}
+			}
+			std::sort(m_codeRanges.begin(), m_codeRanges.end(), [](const sigscan::Range &a, const sigscan::Range &b) { return a.base < b.base; });
+			if (m_codeRanges.empty())
+			{
+				m_codeRanges.push_back({(u8 *)m_base, m_size});
+			}
 		}
-
-		return return_addr;
+		return m_codeRanges;
 	}
 
 	void *FindInterface(const char *name)
@@ -166,4 +190,8 @@ public:
 	void *m_base;
 	size_t m_size;
 	std::vector<Section> m_sections;
+	std::string m_szBuildID;
+
+private:
+	std::vector<sigscan::Range> m_codeRanges;
 };
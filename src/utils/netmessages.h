@@ -0,0 +1,40 @@
+#pragma once
+#include "common.h"
+#include "utils/interfaces.h"
+#include "igameeventsystem.h"
+#include "public/networksystem/inetworkmessages.h"
+
+// A network message resolved by name on first use, along with a single message object that is cleared and
+// reused for every post instead of being allocated and freed each time.
+// The engine serializes the message while posting, and every poster runs on the main thread.
+template<typename T>
+class CachedNetMessage
+{
+public:
+	CachedNetMessage(const char *name) : name(name) {}
+
+	// Returns the cleared message, valid until the next call.
+	T *Prepare()
+	{
+		if (!this->msg)
+		{
+			this->netmsg = g_pNetworkMessages->FindNetworkMessagePartial(this->name);
+			this->msg = this->netmsg->AllocateMessage()->template ToPB<T>();
+		}
+		else
+		{
+			this->msg->Clear();
+		}
+		return this->msg;
+	}
+
+	void Post(IRecipientFilter *filter)
+	{
+		interfaces::pGameEventSystem->PostEventAbstract(0, false, filter, this->netmsg, this->msg, 0);
+	}
+
+private:
+	const char *name;
+	INetworkMessageInternal *netmsg {};
+	CNetMessagePB<T> *msg {};
+};
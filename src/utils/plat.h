@@ -14,6 +14,7 @@ struct Section
 	std::string m_szName;
 	void *m_pBase;
 	size_t m_iSize;
+	bool m_bExecutable;
 };
 
 #if defined(_WIN32)
@@ -34,7 +35,8 @@ struct Module
 };
 
 #ifndef _WIN32
-int GetModuleInformation(HINSTANCE module, void **base, size_t *length, std::vector<Section> &m_sections);
+// buildID is the hex encoded GNU build-id note, empty if the module has none.
+int GetModuleInformation(HINSTANCE module, void **base, size_t *length, std::vector<Section> &m_sections, std::string &buildID);
 #endif
 
 #ifdef _WIN32
@@ -28,7 +28,7 @@ struct ModuleInfo
 
 // https://github.com/alliedmodders/sourcemod/blob/master/core/logic/MemoryUtils.cpp#L502-L587
 // https://github.com/komashchenko/DynLibUtils/blob/5eb95475170becfcc64fd5d32d14ec2b76dcb6d4/module_linux.cpp#L95
-int GetModuleInformation(HINSTANCE hModule, void **base, size_t *length, std::vector<Section> &m_sections)
+int GetModuleInformation(HINSTANCE hModule, void **base, size_t *length, std::vector<Section> &m_sections, std::string &buildID)
 {
 	link_map *lmap;
 	if (dlinfo(hModule, RTLD_DI_LINKMAP, &lmap) != 0)
@@ -54,14 +54,41 @@ int GetModuleInformation(HINSTANCE hModule, void **base, size_t *length, std::ve
 			ElfW(Shdr) *shdrs = reinterpret_cast<ElfW(Shdr) *>(reinterpret_cast<uintptr_t>(ehdr) + ehdr->e_shoff);
 			const char *strTab = reinterpret_cast<const char *>(reinterpret_cast<uintptr_t>(ehdr) + shdrs[ehdr->e_shstrndx].sh_offset);
 
+			bool foundCode = false;
 			for (auto i = 0; i < ehdr->e_phnum; ++i)
 			{
 				ElfW(Phdr) *phdr = reinterpret_cast<ElfW(Phdr) *>(reinterpret_cast<uintptr_t>(ehdr) + ehdr->e_phoff + i * ehdr->e_phentsize);
-				if (phdr->p_type == PT_LOAD && phdr->p_flags & PF_X)
+				if (phdr->p_type == PT_LOAD && phdr->p_flags & PF_X && !foundCode)
 				{
 					*base = reinterpret_cast<void *>(lmap->l_addr + phdr->p_vaddr);
 					*length = phdr->p_filesz;
-					break;
+					foundCode = true;
+				}
+				else if (phdr->p_type == PT_NOTE && buildID.empty())
+				{
+					uintptr_t note = reinterpret_cast<uintptr_t>(ehdr) + phdr->p_offset;
+					uintptr_t notesEnd = note + phdr->p_filesz;
+					while (note + sizeof(ElfW(Nhdr)) <= notesEnd)
+					{
+						ElfW(Nhdr) *nhdr = reinterpret_cast<ElfW(Nhdr) *>(note);
+						const uint8_t *name = reinterpret_cast<const uint8_t *>(note + sizeof(ElfW(Nhdr)));
+						const uint8_t *desc = name + ((nhdr->n_namesz + 3) & ~3);
+						if (reinterpret_cast<uintptr_t>(desc) + nhdr->n_descsz > notesEnd)
+						{
+							break;
+						}
+						if (nhdr->n_type == NT_GNU_BUILD_ID && nhdr->n_namesz == 4 && !memcmp(name, "GNU", 4))
+						{
+							char hex[3];
+							for (uint32_t j = 0; j < nhdr->n_descsz; j++)
+							{
+								snprintf(hex, sizeof(hex), "%02x", desc[j]);
+								buildID += hex;
+							}
+							break;
+						}
+						note = reinterpret_cast<uintptr_t>(desc) + ((nhdr->n_descsz + 3) & ~3);
+					}
 				}
 			}
 
@@ -77,6 +104,7 @@ int GetModuleInformation(HINSTANCE hModule, void **base, size_t *length, std::ve
 				section.m_szName = strTab + shdr->sh_name;
 				section.m_pBase = reinterpret_cast<void *>(lmap->l_addr + shdr->sh_addr);
 				section.m_iSize = shdr->sh_size;
+				section.m_bExecutable = shdr->sh_flags & SHF_EXECINSTR;
 				m_sections.push_back(section);
 			}
 
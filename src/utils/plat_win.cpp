@@ -15,12 +15,18 @@ void CModule::InitializeSections()
 
 	IMAGE_SECTION_HEADER *pSectionHeader = IMAGE_FIRST_SECTION(pNtHeader);
 
+	// PE files have no build-id, the link timestamp and image size identify a build well enough.
+	char buildID[32];
+	V_snprintf(buildID, sizeof(buildID), "%08x%08x", pNtHeader->FileHeader.TimeDateStamp, pNtHeader->OptionalHeader.SizeOfImage);
+	m_szBuildID = buildID;
+
 	for (int i = 0; i < pNtHeader->FileHeader.NumberOfSections; i++)
 	{
 		Section section;
 		section.m_szName = (char *)pSectionHeader[i].Name;
 		section.m_pBase = (void *)((uint8_t *)m_base + pSectionHeader[i].VirtualAddress);
 		section.m_iSize = pSectionHeader[i].SizeOfRawData;
+		section.m_bExecutable = pSectionHeader[i].Characteristics & IMAGE_SCN_MEM_EXECUTE;
 
 		m_sections.push_back(std::move(section));
 	}
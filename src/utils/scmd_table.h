@@ -0,0 +1,151 @@
+#pragma once
+
+#include <ctype.h>
+
+#include "common.h"
+
+// The command registry behind simplecmds.h. It doesn't need the SDK, so scripts/bench-scmd.sh can build it on its own.
+
+#define SCMD_CONSOLE_PREFIX "kz_"
+#define SCMD_MAX_CMDS       512
+#define SCMD_MAX_NAME_LEN   128
+// Must be a power of two.
+#define SCMD_HASH_BUCKETS 1024
+
+// Command slots are referenced by (index + 1) so that 0 means "no command".
+typedef u16 ScmdRef;
+
+template<typename Callback>
+struct ScmdTable
+{
+	struct Cmd
+	{
+		bool hasConsolePrefix;
+		i32 nameLength;
+		char name[SCMD_MAX_NAME_LEN];
+		Callback *callback;
+		bool hidden;
+
+		// Next command in the same hash bucket, by full name and by name without the console prefix.
+		// Free slots are chained through nextByName.
+		ScmdRef nextByName;
+		ScmdRef nextByShortName;
+
+		const char *GetShortName() const
+		{
+			return this->hasConsolePrefix ? this->name + strlen(SCMD_CONSOLE_PREFIX) : this->name;
+		}
+	};
+
+	// Number of slots ever used, including freed ones. Freed slots have no callback.
+	i32 cmdCount;
+	Cmd cmds[SCMD_MAX_CMDS];
+	ScmdRef firstFree;
+
+	ScmdRef nameBuckets[SCMD_HASH_BUCKETS];
+	ScmdRef shortNameBuckets[SCMD_HASH_BUCKETS];
+
+	// Case insensitive FNV-1a.
+	static u32 HashName(const char *name)
+	{
+		u32 hash = 2166136261u;
+		for (const char *c = name; *c; c++)
+		{
+			hash ^= (u8)tolower((u8)*c);
+			hash *= 16777619u;
+		}
+		return hash & (SCMD_HASH_BUCKETS - 1);
+	}
+
+	bool IsFull() const
+	{
+		return this->cmdCount >= SCMD_MAX_CMDS && !this->firstFree;
+	}
+
+	Cmd *FindByName(const char *name)
+	{
+		for (ScmdRef ref = this->nameBuckets[HashName(name)]; ref; ref = this->cmds[ref - 1].nextByName)
+		{
+			if (!V_stricmp(this->cmds[ref - 1].name, name))
+			{
+				return &this->cmds[ref - 1];
+			}
+		}
+		return nullptr;
+	}
+
+	// The name must be unique and the table not full. Reuses a freed slot if there is one.
+	void Add(const char *name, i32 nameLength, bool hasConsolePrefix, Callback *callback, bool hidden)
+	{
+		ScmdRef ref = this->firstFree;
+		if (ref)
+		{
+			this->firstFree = this->cmds[ref - 1].nextByName;
+		}
+		else
+		{
+			ref = ++this->cmdCount;
+		}
+
+		Cmd cmd = {hasConsolePrefix, nameLength, "", callback, hidden};
+		V_snprintf(cmd.name, SCMD_MAX_NAME_LEN, "%s", name);
+		this->cmds[ref - 1] = cmd;
+
+		this->Link(&this->nameBuckets[HashName(cmd.name)], &Cmd::nextByName, ref);
+		this->Link(&this->shortNameBuckets[HashName(cmd.GetShortName())], &Cmd::nextByShortName, ref);
+	}
+
+	void Remove(Cmd *cmd)
+	{
+		ScmdRef ref = (ScmdRef)(cmd - this->cmds) + 1;
+		this->Unlink(&this->nameBuckets[HashName(cmd->name)], &Cmd::nextByName, ref);
+		this->Unlink(&this->shortNameBuckets[HashName(cmd->GetShortName())], &Cmd::nextByShortName, ref);
+
+		*cmd = {};
+		cmd->nextByName = this->firstFree;
+		this->firstFree = ref;
+	}
+
+	// Calls fn on every command whose name without the console prefix matches, in registration order, until it returns true.
+	// The next command is fetched first, so fn is allowed to unregister commands.
+	template<typename T>
+	bool ForEachByShortName(const char *name, T fn)
+	{
+		ScmdRef ref = this->shortNameBuckets[HashName(name)];
+		while (ref)
+		{
+			Cmd *cmd = &this->cmds[ref - 1];
+			ref = cmd->nextByShortName;
+			if (!V_stricmp(name, cmd->GetShortName()) && fn(cmd))
+			{
+				return true;
+			}
+		}
+		return false;
+	}
+
+private:
+	// Appends to the end of the bucket so commands sharing a name keep their registration order.
+	void Link(ScmdRef *bucket, ScmdRef Cmd::*next, ScmdRef ref)
+	{
+		ScmdRef *link = bucket;
+		while (*link)
+		{
+			link = &(this->cmds[*link - 1].*next);
+		}
+		*link = ref;
+		this->cmds[ref - 1].*next = 0;
+	}
+
+	void Unlink(ScmdRef *bucket, ScmdRef Cmd::*next, ScmdRef ref)
+	{
+		for (ScmdRef *link = bucket; *link; link = &(this->cmds[*link - 1].*next))
+		{
+			if (*link == ref)
+			{
+				*link = this->cmds[ref - 1].*next;
+				return;
+			}
+		}
+	}
+};
@@ -0,0 +1,278 @@
+#include "sigscan.h"
+
+#include <algorithm>
+#include <cstdio>
+
+#if defined(__SSE2__) || defined(_M_X64) || defined(_M_AMD64)
+#include <emmintrin.h>
+#define SIGSCAN_SSE2
+#endif
+
+#ifdef _WIN32
+#include <intrin.h>
+#endif
+
+#include "tier0/memdbgon.h"
+
+#define SIGSCAN_WILDCARD 0x2A
+
+#define SIGSCAN_CACHE_HEADER "// cs2kz signature cache v1"
+
+// Bytes that show up all over x86-64 code (REX prefixes, mov, call, padding, ...), bad to filter candidates on.
+static_function bool IsCommonByte(u8 value)
+{
+	switch (value)
+	{
+		case 0x00:
+		case 0x01:
+		case 0x0F:
+		case 0x24:
+		case 0x41:
+		case 0x44:
+		case 0x48:
+		case 0x49:
+		case 0x4C:
+		case 0x74:
+		case 0x75:
+		case 0x83:
+		case 0x85:
+		case 0x89:
+		case 0x8B:
+		case 0x8D:
+		case 0x90:
+		case 0xC0:
+		case 0xCC:
+		case 0xE8:
+		case 0xEB:
+		case 0xFF:
+			return true;
+	}
+	return false;
+}
+
+static_function u32 CountTrailingZeros(u32 value)
+{
+#ifdef _WIN32
+	unsigned long index;
+	_BitScanForward(&index, value);
+	return index;
+#else
+	return __builtin_ctz(value);
+#endif
+}
+
+sigscan::Pattern::Pattern(const byte *data, size_t length) : bytes(data, data + length), wildcard(length)
+{
+	// Anchor pairs always beat single bytes, fewer common bytes beat more.
+	u32 bestScore = UINT32_MAX;
+	for (size_t i = 0; i < length; i++)
+	{
+		this->wildcard[i] = this->bytes[i] == SIGSCAN_WILDCARD;
+		if (this->wildcard[i])
+		{
+			continue;
+		}
+		bool pair = i + 1 < length && this->bytes[i + 1] != SIGSCAN_WILDCARD;
+		u32 score = pair ? IsCommonByte(this->bytes[i]) + IsCommonByte(this->bytes[i + 1]) : 3 + IsCommonByte(this->bytes[i]);
+		if (score < bestScore)
+		{
+			bestScore = score;
+			this->anchor = i;
+			this->anchorLength = pair ? 2 : 1;
+		}
+	}
+}
+
+bool sigscan::Pattern::MatchesAt(const u8 *address) const
+{
+	for (size_t i = 0; i < this->bytes.size(); i++)
+	{
+		if (!this->wildcard[i] && address[i] != this->bytes[i])
+		{
+			return false;
+		}
+	}
+	return true;
+}
+
+// Returns true once the pattern can't get any more results.
+static_function bool RecordMatch(const sigscan::Pattern &pattern, u8 *address, sigscan::Result &result)
+{
+	if (!pattern.MatchesAt(address))
+	{
+		return false;
+	}
+	if (result.matches++ == 0)
+	{
+		result.address = address;
+	}
+	return result.matches >= 2;
+}
+
+// Checks the candidates [from, to) of a range, the pattern is known to fit at every one of them.
+static_function bool ScanBlock(const sigscan::Pattern &pattern, u8 *base, size_t from, size_t to, sigscan::Result &result)
+{
+	size_t i = from;
+	u8 first = pattern.anchorLength > 0 ? pattern.bytes[pattern.anchor] : 0;
+	u8 second = pattern.anchorLength > 1 ? pattern.bytes[pattern.anchor + 1] : 0;
+#ifdef SIGSCAN_SSE2
+	if (pattern.anchorLength > 0)
+	{
+		// 16 candidates per iteration. Reading the second anchor byte of the last candidate stays within the range
+		// because every pattern with a two byte anchor reaches at least one byte past it.
+		__m128i firstVec = _mm_set1_epi8((char)first);
+		__m128i secondVec = _mm_set1_epi8((char)second);
+		for (; i + 16 <= to; i += 16)
+		{
+			const u8 *anchor = base + i + pattern.anchor;
+			__m128i hits = _mm_cmpeq_epi8(_mm_loadu_si128((const __m128i *)anchor), firstVec);
+			if (pattern.anchorLength > 1)
+			{
+				hits = _mm_and_si128(hits, _mm_cmpeq_epi8(_mm_loadu_si128((const __m128i *)(anchor + 1)), secondVec));
+			}
+			u32 mask = (u32)_mm_movemask_epi8(hits);
+			while (mask)
+			{
+				u32 bit = CountTrailingZeros(mask);
+				mask &= mask - 1;
+				if (RecordMatch(pattern, base + i + bit, result))
+				{
+					return true;
+				}
+			}
+		}
+	}
+#endif
+	for (; i < to; i++)
+	{
+		const u8 *anchor = base + i + pattern.anchor;
+		if (pattern.anchorLength > 0 && (anchor[0] != first || (pattern.anchorLength > 1 && anchor[1] != second)))
+		{
+			continue;
+		}
+		if (RecordMatch(pattern, base + i, result))
+		{
+			return true;
+		}
+	}
+	return false;
+}
+
+void sigscan::Scan(const std::vector<Range> &ranges, const std::vector<Pattern> &patterns, std::vector<Result> &results)
+{
+	results.assign(patterns.size(), {});
+	std::vector<u32> active;
+	for (u32 i = 0; i < patterns.size(); i++)
+	{
+		if (!patterns[i].bytes.empty())
+		{
+			active.push_back(i);
+		}
+	}
+
+	for (const Range &range : ranges)
+	{
+		for (size_t block = 0; block < range.size && !active.empty(); block += SIGSCAN_BLOCK_SIZE)
+		{
+			for (size_t j = 0; j < active.size();)
+			{
+				const Pattern &pattern = patterns[active[j]];
+				if (pattern.bytes.size() <= range.size)
+				{
+					size_t to = std::min(block + SIGSCAN_BLOCK_SIZE, range.size - pattern.bytes.size() + 1);
+					if (block < to && ScanBlock(pattern, range.base, block, to, results[active[j]]))
+					{
+						active[j] = active.back();
+						active.pop_back();
+						continue;
+					}
+				}
+				j++;
+			}
+		}
+	}
+}
+
+u64 sigscan::HashString(const char *string)
+{
+	u64 hash = 0xCBF29CE484222325ull;
+	for (; *string; string++)
+	{
+		hash = (hash ^ (u8)*string) * 0x100000001B3ull;
+	}
+	return hash;
+}
+
+static_function std::string GetCacheEntryKey(const char *module, u64 signatureHash)
+{
+	char key[128];
+	V_snprintf(key, sizeof(key), "%s %016llx", module, (unsigned long long)signatureHash);
+	return key;
+}
+
+void sigscan::Cache::Load(const char *path)
+{
+	this->entries.clear();
+	this->dirty = false;
+	FILE *file = fopen(path, "r");
+	if (!file)
+	{
+		return;
+	}
+
+	char line[512];
+	if (!fgets(line, sizeof(line), file) || V_strncmp(line, SIGSCAN_CACHE_HEADER, V_strlen(SIGSCAN_CACHE_HEADER)))
+	{
+		fclose(file);
+		return;
+	}
+	while (fgets(line, sizeof(line), file))
+	{
+		char module[64], moduleKey[128];
+		unsigned long long signatureHash, offset;
+		if (sscanf(line, "%63s %127s %llx %llx", module, moduleKey, &signatureHash, &offset) == 4)
+		{
+			this->entries[GetCacheEntryKey(module, signatureHash)] = {module, moduleKey, (u64)signatureHash, (u64)offset, false};
+		}
+	}
+	fclose(file);
+}
+
+void sigscan::Cache::Save(const char *path)
+{
+	FILE *file = fopen(path, "w");
+	if (!file)
+	{
+		Warning("Failed to write the signature cache to %s\n", path);
+		return;
+	}
+	fprintf(file, "%s\n", SIGSCAN_CACHE_HEADER);
+	for (auto &[key, entry] : this->entries)
+	{
+		if (entry.used)
+		{
+			fprintf(file, "%s %s %016llx %llx\n", entry.module.c_str(), entry.moduleKey.c_str(), (unsigned long long)entry.signatureHash,
+					(unsigned long long)entry.offset);
+		}
+	}
+	fclose(file);
+	this->dirty = false;
+}
+
+bool sigscan::Cache::Find(const char *module, const std::string &moduleKey, u64 signatureHash, u64 &offset)
+{
+	auto it = this->entries.find(GetCacheEntryKey(module, signatureHash));
+	if (it == this->entries.end() || it->second.moduleKey != moduleKey)
+	{
+		return false;
+	}
+	it->second.used = true;
+	offset = it->second.offset;
+	return true;
+}
+
+void sigscan::Cache::Set(const char *module, const std::string &moduleKey, u64 signatureHash, u64 offset)
+{
+	this->entries[GetCacheEntryKey(module, signatureHash)] = {module, moduleKey, signatureHash, offset, true};
+	this->dirty = true;
+}
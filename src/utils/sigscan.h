@@ -0,0 +1,74 @@
+#pragma once
+#include "common.h"
+
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// Candidates are checked this many bytes at a time for every pattern, so a block stays in cache while all patterns walk over it.
+#define SIGSCAN_BLOCK_SIZE 65536
+
+namespace sigscan
+{
+	// 0x2A ('*') bytes are wildcards, same as in the gamedata file.
+	struct Pattern
+	{
+		Pattern(const byte *data, size_t length);
+
+		std::vector<u8> bytes;
+		std::vector<bool> wildcard;
+		// Offset of the one or two bytes that candidates are filtered on, picked to be as uncommon in machine code as possible.
+		size_t anchor {};
+		size_t anchorLength {};
+
+		bool MatchesAt(const u8 *address) const;
+	};
+
+	struct Range
+	{
+		u8 *base;
+		size_t size;
+	};
+
+	struct Result
+	{
+		void *address {};
+		// Counting stops at two, any more than one match is ambiguous anyway.
+		u32 matches {};
+	};
+
+	// Walks the ranges once for all patterns. Ranges must be sorted by address, the first match of every pattern is the lowest one.
+	void Scan(const std::vector<Range> &ranges, const std::vector<Pattern> &patterns, std::vector<Result> &results);
+
+	u64 HashString(const char *string);
+
+	// Offsets of resolved signatures, keyed by the module and the identity of its binary.
+	// Entries that weren't looked up or set since loading are dropped on save.
+	class Cache
+	{
+	public:
+		void Load(const char *path);
+		void Save(const char *path);
+
+		bool Find(const char *module, const std::string &moduleKey, u64 signatureHash, u64 &offset);
+		void Set(const char *module, const std::string &moduleKey, u64 signatureHash, u64 offset);
+
+		bool IsDirty() const
+		{
+			return this->dirty;
+		}
+
+	private:
+		struct Entry
+		{
+			std::string module;
+			std::string moduleKey;
+			u64 signatureHash;
+			u64 offset;
+			bool used;
+		};
+
+		std::unordered_map<std::string, Entry> entries;
+		bool dirty {};
+	};
+} // namespace sigscan
@@ -7,23 +7,9 @@
 #include "../kz/option/kz_option.h"
 
 #include "tier0/memdbgon.h"
-// private structs
-#define SCMD_MAX_NAME_LEN 128
 
-struct Scmd
-{
-	bool hasConsolePrefix;
-	i32 nameLength;
-	char name[SCMD_MAX_NAME_LEN];
-	scmd::Callback_t *callback;
-	bool hidden;
-};
-
-struct ScmdManager
-{
-	i32 cmdCount;
-	Scmd cmds[SCMD_MAX_CMDS];
-};
+typedef ScmdTable<scmd::Callback_t> ScmdManager;
+typedef ScmdManager::Cmd Scmd;
 
 static_global ScmdManager g_cmdManager = {};
 static_global bool g_coreCmdsRegistered = false;
@@ -36,7 +22,7 @@ static_function SCMD_CALLBACK(Command_KzHelp)
 	Scmd *cmds = g_cmdManager.cmds;
 	for (i32 i = 0; i < g_cmdManager.cmdCount; i++)
 	{
-		if (cmds[i].hidden)
+		if (!cmds[i].callback || cmds[i].hidden)
 		{
 			continue;
 		}
@@ -58,7 +44,7 @@ bool scmd::RegisterCmd(const char *name, scmd::Callback_t *callback, bool hidden
 {
 	Assert(name);
 	Assert(callback);
-	if (!name || !callback || g_cmdManager.cmdCount >= SCMD_MAX_CMDS)
+	if (!name || !callback || g_cmdManager.IsFull())
 	{
 		// TODO: print warning? error? segfault?
 		Assert(0);
@@ -89,51 +75,29 @@ bool scmd::RegisterCmd(const char *name, scmd::Callback_t *callback, bool hidden
 	}
 
 	// Check if command with this name already exists
-	Scmd *cmds = g_cmdManager.cmds;
-	for (i32 i = 0; i < g_cmdManager.cmdCount; i++)
+	if (g_cmdManager.FindByName(name))
 	{
-		if (nameLength != g_cmdManager.cmds[i].nameLength)
-		{
-			continue;
-		}
-
-		if (!V_stricmp(g_cmdManager.cmds[i].name, name))
-		{
-			// TODO: print warning? error? segfault?
-			// Command already exists
-			// Assert(0);
-			return false;
-		}
+		// TODO: print warning? error? segfault?
+		// Command already exists
+		// Assert(0);
+		return false;
 	}
 
 	// Command name is unique!
-	Scmd cmd = {hasConPrefix, nameLength, "", callback, hidden};
-	V_snprintf(cmd.name, SCMD_MAX_NAME_LEN, "%s", name);
-	g_cmdManager.cmds[g_cmdManager.cmdCount++] = cmd;
+	g_cmdManager.Add(name, nameLength, hasConPrefix, callback, hidden);
 	return true;
 }
 
 bool scmd::UnregisterCmd(const char *name)
 {
-	i32 indexToDelete = -1;
-	for (i32 i = 0; i < g_cmdManager.cmdCount; i++)
-	{
-		if (!V_stricmp(g_cmdManager.cmds[i].name, name))
-		{
-			indexToDelete = i;
-			break;
-		}
-	}
-	if (indexToDelete != -1)
+	Scmd *cmd = name ? g_cmdManager.FindByName(name) : nullptr;
+	if (!cmd)
 	{
-		for (i32 i = indexToDelete; i < g_cmdManager.cmdCount; i++)
-		{
-			g_cmdManager.cmds[i] = g_cmdManager.cmds[i + 1];
-		}
-		g_cmdManager.cmdCount--;
-		return true;
+		return false;
 	}
-	return false;
+
+	g_cmdManager.Remove(cmd);
+	return true;
 }
 
 META_RES scmd::OnClientCommand(CPlayerSlot &slot, const CCommand &args)
@@ -156,23 +120,10 @@ META_RES scmd::OnClientCommand(CPlayerSlot &slot, const CCommand &args)
 		return MRES_IGNORED;
 	}
 
-	for (i32 i = 0; i < g_cmdManager.cmdCount; i++)
+	Scmd *cmd = g_cmdManager.FindByName(args[0]);
+	if (cmd)
 	{
-		if (!g_cmdManager.cmds[i].callback)
-		{
-			// TODO: error?
-			Assert(g_cmdManager.cmds[i].callback);
-			continue;
-		}
-
-		if (!V_stricmp(g_cmdManager.cmds[i].name, args[0]))
-		{
-			result = g_cmdManager.cmds[i].callback(controller, &args);
-			if (result == MRES_SUPERCEDE)
-			{
-				return result;
-			}
-		}
+		result = cmd->callback(controller, &args);
 	}
 	return result;
 }
@@ -219,54 +170,23 @@ META_RES scmd::OnDispatchConCommand(ConCommandHandle cmd, const CCommandContext
 			// arg is too short!
 			return MRES_IGNORED;
 		}
-		Scmd *cmds = g_cmdManager.cmds;
 
 		CCommand cmdArgs;
 		cmdArgs.Tokenize(args[1]);
 
-		for (i32 i = 0; i < g_cmdManager.cmdCount; i++)
+		const char *arg = cmdArgs[0] + 1; // skip chat trigger
+		bool silent = args[1][0] == SCMD_CHAT_SILENT_TRIGGER;
+		if (g_cmdManager.ForEachByShortName(arg, [&](Scmd *cmd) { return cmd->callback(controller, &cmdArgs) == MRES_SUPERCEDE || silent; }))
 		{
-			if (!cmds[i].callback)
-			{
-				// TODO: error?
-				Assert(cmds[i].callback);
-				continue;
-			}
-
-			const char *arg = cmdArgs[0] + 1; // skip chat trigger
-			const char *cmdName = cmds[i].hasConsolePrefix ? cmds[i].name + strlen(SCMD_CONSOLE_PREFIX) : cmds[i].name;
-			if (!V_stricmp(arg, cmdName))
-			{
-				META_RES result = cmds[i].callback(controller, &cmdArgs);
-				if (args[1][0] == SCMD_CHAT_SILENT_TRIGGER || result == MRES_SUPERCEDE)
-				{
-					// don't send chat message
-					return MRES_SUPERCEDE;
-				}
-			}
+			// don't send chat message
+			return MRES_SUPERCEDE;
 		}
 	}
 	else // Are we overriding a console command?
 	{
-		for (i32 i = 0; i < g_cmdManager.cmdCount; i++)
+		if (g_cmdManager.ForEachByShortName(commandName, [&](Scmd *cmd) { return cmd->callback(controller, &args) == MRES_SUPERCEDE; }))
 		{
-			Scmd *cmds = g_cmdManager.cmds;
-			if (!cmds[i].callback)
-			{
-				// TODO: error?
-				Assert(cmds[i].callback);
-				continue;
-			}
-
-			const char *cmdName = cmds[i].hasConsolePrefix ? cmds[i].name + strlen(SCMD_CONSOLE_PREFIX) : cmds[i].name;
-			if (!V_stricmp(commandName, cmdName))
-			{
-				META_RES result = g_cmdManager.cmds[i].callback(controller, &args);
-				if (result == MRES_SUPERCEDE)
-				{
-					return result;
-				}
-			}
+			return MRES_SUPERCEDE;
 		}
 	}
 
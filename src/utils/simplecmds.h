@@ -3,14 +3,14 @@
 #ifndef SIMPLECMDS_H
 #define SIMPLECMDS_H
 
+#include "scmd_table.h"
+
 class CCSPlayerController;
 
 #define SCMD_CALLBACK(name) META_RES name(CCSPlayerController *controller, const CCommand *args)
 
-#define SCMD_CONSOLE_PREFIX      "kz_"
 #define SCMD_CHAT_SILENT_TRIGGER '/'
 #define SCMD_CHAT_TRIGGER        '!'
-#define SCMD_MAX_CMDS            512
 
 namespace scmd
 {
@@ -11,6 +11,7 @@
 #include "igameeventsystem.h"
 #include "sdk/recipientfilters.h"
 #include "public/networksystem/inetworkmessages.h"
+#include "utils/netmessages.h"
 #include "gametrace.h"
 
 #include "module.h"
@@ -61,6 +62,9 @@ bool utils::Initialize(ISmmAPI *ismm, char *error, size_t maxlen)
 		Warning("%s\n", error);
 		return false;
 	}
+	char sigCachePath[MAX_PATH];
+	ismm->PathFormat(sigCachePath, sizeof(sigCachePath), "%s/addons/cs2kz/gamedata/cs2kz-core.sigcache.txt", ismm->GetBaseDir());
+	g_pGameConfig->ResolveSignatures(sigCachePath);
 
 	// Convoluted way of having GameEventManager regardless of lateloading
 	if (!(interfaces::pGameEventManager = (IGameEventManager2 *)g_pGameConfig->ResolveSignatureFromMov("GameEventManager")))
@@ -372,22 +376,21 @@ bool utils::SetConvarValue(CPlayerSlot slot, const char *name, const char *value
 	return result;
 }
 
+static_global CachedNetMessage<CNETMsg_SetConVar> setConVarMsg("SetConVar");
+
 void utils::SendConVarValue(CPlayerSlot slot, const char *conVar, const char *value)
 {
-	INetworkMessageInternal *netmsg = g_pNetworkMessages->FindNetworkMessagePartial("SetConVar");
-	auto msg = netmsg->AllocateMessage()->ToPB<CNETMsg_SetConVar>();
+	CNETMsg_SetConVar *msg = setConVarMsg.Prepare();
 	CMsg_CVars_CVar *cvar = msg->mutable_convars()->add_cvars();
 	cvar->set_name(conVar);
 	cvar->set_value(value);
 	CSingleRecipientFilter filter(slot.Get());
-	interfaces::pGameEventSystem->PostEventAbstract(0, false, &filter, netmsg, msg, 0);
-	delete msg;
+	setConVarMsg.Post(&filter);
 }
 
 void utils::SendMultipleConVarValues(CPlayerSlot slot, const char **cvars, const char **values, u32 size)
 {
-	INetworkMessageInternal *netmsg = g_pNetworkMessages->FindNetworkMessagePartial("SetConVar");
-	auto msg = netmsg->AllocateMessage()->ToPB<CNETMsg_SetConVar>();
+	CNETMsg_SetConVar *msg = setConVarMsg.Prepare();
 	for (u32 i = 0; i < size; i++)
 	{
 		CMsg_CVars_CVar *cvar = msg->mutable_convars()->add_cvars();
@@ -395,26 +398,22 @@ void utils::SendMultipleConVarValues(CPlayerSlot slot, const char **cvars, const
 		cvar->set_value(values[i]);
 	}
 	CSingleRecipientFilter filter(slot.Get());
-	interfaces::pGameEventSystem->PostEventAbstract(0, false, &filter, netmsg, msg, 0);
-	delete msg;
+	setConVarMsg.Post(&filter);
 }
 
 void utils::SendConVarValue(CPlayerSlot slot, ConVar *conVar, const char *value)
 {
-	INetworkMessageInternal *netmsg = g_pNetworkMessages->FindNetworkMessagePartial("SetConVar");
-	auto msg = netmsg->AllocateMessage()->ToPB<CNETMsg_SetConVar>();
+	CNETMsg_SetConVar *msg = setConVarMsg.Prepare();
 	CMsg_CVars_CVar *cvar = msg->mutable_convars()->add_cvars();
 	cvar->set_name(conVar->m_pszName);
 	cvar->set_value(value);
 	CSingleRecipientFilter filter(slot.Get());
-	interfaces::pGameEventSystem->PostEventAbstract(0, false, &filter, netmsg, msg, 0);
-	delete msg;
+	setConVarMsg.Post(&filter);
 }
 
 void utils::SendMultipleConVarValues(CPlayerSlot slot, ConVar **conVar, const char **values, u32 size)
 {
-	INetworkMessageInternal *netmsg = g_pNetworkMessages->FindNetworkMessagePartial("SetConVar");
-	auto msg = netmsg->AllocateMessage()->ToPB<CNETMsg_SetConVar>();
+	CNETMsg_SetConVar *msg = setConVarMsg.Prepare();
 	for (u32 i = 0; i < size; i++)
 	{
 		CMsg_CVars_CVar *cvar = msg->mutable_convars()->add_cvars();
@@ -422,8 +421,7 @@ void utils::SendMultipleConVarValues(CPlayerSlot slot, ConVar **conVar, const ch
 		cvar->set_value(values[i]);
 	}
 	CSingleRecipientFilter filter(slot.Get());
-	interfaces::pGameEventSystem->PostEventAbstract(0, false, &filter, netmsg, msg, 0);
-	delete msg;
+	setConVarMsg.Post(&filter);
 }
 
 bool utils::IsSpawnValid(const Vector &origin)
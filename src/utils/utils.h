@@ -3,6 +3,7 @@
 #include "utils/interfaces.h"
 #include "sdk/datatypes.h"
 #include "igameevents.h"
+#include "utils/cformat.h"
 
 class KZUtils;
 class CBasePlayerController;
@@ -36,8 +37,7 @@ namespace utils
 	// c can be PI (for radians) or 180.0 (for degrees);
 	f32 GetAngleDifference(const f32 x, const f32 y, const f32 c, bool relative = false);
 
-	// Print functions
-	bool CFormat(char *buffer, u64 buffer_size, const char *text);
+	// Print functions, see utils/cformat.h for CFormat
 	void SayChat(CBaseEntity *entity, const char *format, ...);
 	void ClientPrintFilter(IRecipientFilter *filter, int msg_dest, const char *msg_name, const char *param1, const char *param2, const char *param3,
 						   const char *param4);
@@ -46,6 +46,7 @@ namespace utils
 	void PrintCentre(CBaseEntity *entity, const char *format, ...);
 	void PrintAlert(CBaseEntity *entity, const char *format, ...);
 	void PrintHTMLCentre(CBaseEntity *entity, const char *format, ...); // This one uses HTML formatting.
+	void PrintHTMLCentreFilter(IRecipientFilter *filter, const char *text);
 
 	void PrintConsoleAll(const char *format, ...);
 	void PrintChatAll(const char *format, ...);
@@ -56,6 +57,7 @@ namespace utils
 	// Color print
 	void CPrintChat(CBaseEntity *entity, const char *format, ...);
 	void CPrintChatAll(const char *format, ...);
+	void CPrintChatFilter(IRecipientFilter *filter, const char *text);
 
 	// Sounds
 	void PlaySoundToClient(CPlayerSlot player, const char *sound, f32 volume = 1.0f);